@@ -0,0 +1,99 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+
+namespace Bench
+{
+    Harness::Harness(double min_time, unsigned repetitions)
+        : m_min_time(min_time),
+          m_repetitions(std::max(repetitions, 1u)),
+          m_failed_checks_count(0)
+    {
+    }
+
+    void Harness::check(bool is_passed, const std::string & message)
+    {
+        if (!is_passed)
+        {
+            std::fprintf(stderr, "Check failed: %s\n", message.c_str());
+            ++m_failed_checks_count;
+        }
+    }
+
+    void Harness::addResult(const std::string & name, size_t iterations, size_t items_per_call, std::vector<double> & samples)
+    {
+        std::sort(samples.begin(), samples.end());
+
+        Result result;
+        result.m_name           = name;
+        result.m_iterations     = iterations;
+        result.m_items_per_call = items_per_call;
+        result.m_median_ns      = samples[samples.size() / 2];
+        result.m_min_ns         = samples.front();
+        result.m_max_ns         = samples.back();
+
+        std::printf("%-48s %14.1f ns %12.2f ns/item\n", name.c_str(), result.m_median_ns, result.m_median_ns / items_per_call);
+        m_results.push_back(result);
+    }
+
+    void Harness::printTable() const
+    {
+        std::printf("\n%-48s %14s %14s %14s %12s\n", "benchmark", "median ns", "min ns", "max ns", "ns/item");
+
+        for (auto & result : m_results)
+        {
+            std::printf("%-48s %14.1f %14.1f %14.1f %12.2f\n", result.m_name.c_str(), result.m_median_ns, result.m_min_ns, result.m_max_ns,
+                        result.m_median_ns / result.m_items_per_call);
+        }
+    }
+
+    bool Harness::writeJson(const std::string & filename) const
+    {
+        std::ofstream file(filename);
+
+        if (!file)
+        {
+            std::fprintf(stderr, "Can't open file %s for writing benchmark results.\n", filename.c_str());
+            return false;
+        }
+
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+#ifdef NDEBUG
+        const char * build_type = "release";
+#else
+        const char * build_type = "debug";
+#endif
+
+        file << std::fixed << std::setprecision(3);
+        file << "{\n";
+        file << "  \"date\": \"" << date << "\",\n";
+        file << "  \"build_type\": \"" << build_type << "\",\n";
+        file << "  \"repetitions\": " << m_repetitions << ",\n";
+        file << "  \"benchmarks\": [";
+
+        for (size_t i = 0; i < m_results.size(); ++i)
+        {
+            const Result & result = m_results[i];
+
+            file << (i == 0 ? "\n" : ",\n");
+            file << "    { \"name\": \"" << result.m_name << "\""
+                 << ", \"iterations\": " << result.m_iterations
+                 << ", \"items_per_call\": " << result.m_items_per_call
+                 << ", \"median_ns\": " << result.m_median_ns
+                 << ", \"min_ns\": " << result.m_min_ns
+                 << ", \"max_ns\": " << result.m_max_ns
+                 << ", \"ns_per_item\": " << result.m_median_ns / result.m_items_per_call << " }";
+        }
+
+        file << "\n  ]\n}\n";
+
+        return bool(file);
+    }
+}
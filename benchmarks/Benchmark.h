@@ -0,0 +1,162 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Bench
+{
+    /* Keeps the compiler from optimizing away a result that is never used */
+    template <typename T>
+    inline void doNotOptimize(const T & value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void * sink;
+        sink = &value;
+#endif
+    }
+
+    struct Result
+    {
+        std::string m_name;
+        size_t      m_iterations;     /* Per repetition */
+        size_t      m_items_per_call; /* e.g. transforms updated by one call, to compare different sizes */
+        double      m_median_ns;      /* Per call */
+        double      m_min_ns;
+        double      m_max_ns;
+    };
+
+    /**
+     * Runs every benchmark for a few repetitions of at least min_time seconds each
+     * and keeps the median, min and max time of a single call. Results are printed
+     * as a table and can be saved as JSON to track regressions between commits.
+     */
+    class Harness final
+    {
+    public:
+        explicit Harness(double min_time = 0.1, unsigned repetitions = 5);
+
+        /* Only benchmarks whose name contains the filter are run */
+        void setFilter(const std::string & filter) { m_filter = filter; }
+
+        /**
+         * @param setup Called before every repetition outside of the measurement, e.g. to reset the input data.
+         * @param func  Called once per iteration.
+         */
+        template <typename Setup, typename F>
+        void run(const std::string & name, size_t items_per_call, Setup && setup, F && func)
+        {
+            runRepetitions(name, items_per_call, setup, [&func](size_t iterations)
+            {
+                return measure(iterations, func);
+            });
+        }
+
+        template <typename F>
+        void run(const std::string & name, size_t items_per_call, F && func)
+        {
+            run(name, items_per_call, [] {}, func);
+        }
+
+        /**
+         * @brief Same as run(), but setup is called before every iteration, e.g. to spawn what func
+         *        despawns. Only func is timed - the clock is read around every call, so it's meant
+         *        for calls much longer than that.
+         */
+        template <typename Setup, typename F>
+        void runWithSetupEach(const std::string & name, size_t items_per_call, Setup && setup, F && func)
+        {
+            runRepetitions(name, items_per_call, [] {}, [&setup, &func](size_t iterations)
+            {
+                return measureEach(iterations, setup, func);
+            });
+        }
+
+        /* Reports a broken expectation of a benchmark, e.g. memory growing every frame. The run still goes on */
+        void check(bool is_passed, const std::string & message);
+        bool hasFailedChecks() const { return m_failed_checks_count > 0; }
+
+        void printTable() const;
+        bool writeJson(const std::string & filename) const;
+
+    private:
+        /* measure(iterations) returns the seconds the iterations took */
+        template <typename Setup, typename Measure>
+        void runRepetitions(const std::string & name, size_t items_per_call, Setup && setup, Measure && measure)
+        {
+            if (name.find(m_filter) == std::string::npos)
+            {
+                return;
+            }
+
+            /* Calibrate the number of iterations, so one repetition takes at least min_time */
+            size_t iterations = 1;
+            setup();
+
+            while (true)
+            {
+                double elapsed = measure(iterations);
+
+                if (elapsed >= m_min_time || iterations >= (size_t(1) << 30))
+                {
+                    break;
+                }
+
+                iterations = elapsed > 0.0 ? size_t(iterations * 1.5 * m_min_time / elapsed) + 1 : iterations * 10;
+            }
+
+            std::vector<double> samples;
+
+            for (unsigned i = 0; i < m_repetitions; ++i)
+            {
+                setup();
+                samples.push_back(measure(iterations) * 1e9 / iterations);
+            }
+
+            addResult(name, iterations, items_per_call, samples);
+        }
+
+        template <typename F>
+        static double measure(size_t iterations, F & func)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                func();
+            }
+
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            return elapsed.count();
+        }
+
+        template <typename Setup, typename F>
+        static double measureEach(size_t iterations, Setup & setup, F & func)
+        {
+            std::chrono::duration<double> elapsed(0.0);
+
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                setup();
+
+                auto start = std::chrono::steady_clock::now();
+                func();
+                elapsed += std::chrono::steady_clock::now() - start;
+            }
+
+            return elapsed.count();
+        }
+
+        void addResult(const std::string & name, size_t iterations, size_t items_per_call, std::vector<double> & samples);
+
+        std::vector<Result> m_results;
+        std::string         m_filter;
+        double              m_min_time;
+        unsigned            m_repetitions;
+        unsigned            m_failed_checks_count;
+    };
+}
@@ -0,0 +1,534 @@
+#include "HotPathBenchmarks.h"
+#include "Benchmark.h"
+
+#include "core_components/PointLightComponent.h"
+#include "core_components/TransformComponent.h"
+#include "core_engine/EntityQuery.h"
+#include "core_engine/EntitySpawner.h"
+#include "core_systems/RenderingSystem.h"
+#include "core_systems/SceneGraphSystem.h"
+#include "framework/rendering/Material.h"
+#include "framework/rendering/Model.h"
+#include "framework/rendering/UniformName.h"
+#include "framework/utilities/AffineMath.h"
+#include "framework/utilities/GeomPrimitive.h"
+#include "framework/utilities/ShaderGlobals.h"
+
+#include <entityx/entityx.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+namespace Bench
+{
+    namespace
+    {
+        typedef entityx::ComponentHandle<Vertex::TransformComponent> TransformHandle;
+
+        TransformHandle createTransform(entityx::EntityManager & entities, float offset)
+        {
+            entityx::Entity entity = entities.create();
+
+            return entity.assign<Vertex::TransformComponent>(glm::vec3(offset, 0.0f, 0.0f), glm::vec3(0.0f, offset, 0.0f));
+        }
+
+        /* Every node has children_count children, down to depth levels below the root */
+        size_t buildTree(entityx::EntityManager & entities, TransformHandle parent, unsigned children_count, unsigned depth)
+        {
+            if (depth == 0)
+            {
+                return 0;
+            }
+
+            size_t created = 0;
+
+            for (unsigned i = 0; i < children_count; ++i)
+            {
+                TransformHandle child = createTransform(entities, float(i + 1));
+                parent->addChild(child);
+
+                created += 1 + buildTree(entities, child, children_count, depth - 1);
+            }
+
+            return created;
+        }
+
+        void benchmarkHierarchy(Harness & harness, const std::string & name, unsigned children_count, unsigned depth)
+        {
+            entityx::EventManager  events;
+            entityx::EntityManager entities(events);
+
+            TransformHandle root = createTransform(entities, 0.0f);
+            size_t transforms_count = 1 + buildTree(entities, root, children_count, depth);
+
+            TransformHandle leaf = createTransform(entities, 1.0f);
+            root->addChild(leaf);
+            ++transforms_count;
+
+            Vertex::TransformHierarchy & hierarchy = Vertex::TransformComponent::hierarchy();
+
+            /* Sorts the new nodes before measuring */
+            hierarchy.update();
+
+            /* Moving the root makes the whole hierarchy dirty */
+            harness.run("TransformHierarchy::update/" + name + "/dirty", transforms_count, [&root, &hierarchy]
+            {
+                root->setPosition(root->position() + glm::vec3(0.001f));
+                hierarchy.update();
+            });
+
+            /* Only the moved node is visited */
+            harness.run("TransformHierarchy::update/" + name + "/one", transforms_count, [&leaf, &hierarchy]
+            {
+                leaf->setPosition(leaf->position() + glm::vec3(0.001f));
+                hierarchy.update();
+            });
+
+            harness.run("TransformHierarchy::update/" + name + "/clean", transforms_count, [&hierarchy]
+            {
+                hierarchy.update();
+            });
+        }
+
+        /* Pickup/attach gameplay - every object moves between two parents every frame */
+        void benchmarkReparent(Harness & harness, size_t objects_count)
+        {
+            entityx::EventManager  events;
+            entityx::EntityManager entities(events);
+
+            TransformHandle root  = createTransform(entities, 0.0f);
+            TransformHandle hands = createTransform(entities, 1.0f);
+            root->addChild(hands);
+
+            std::vector<TransformHandle> objects;
+
+            for (size_t i = 0; i < objects_count; ++i)
+            {
+                objects.push_back(createTransform(entities, float(i)));
+                root->addChild(objects.back());
+            }
+
+            Vertex::TransformHierarchy & hierarchy = Vertex::TransformComponent::hierarchy();
+            hierarchy.update();
+
+            const size_t slots_count = hierarchy.size();
+            size_t max_slots_count   = 0;
+            bool   is_attached       = false;
+
+            harness.run("TransformHierarchy::setParent/" + std::to_string(objects_count), objects_count, [&]
+            {
+                is_attached = !is_attached;
+
+                for (auto & object : objects)
+                {
+                    (is_attached ? hands : root)->addChild(object);
+                }
+
+                max_slots_count = std::max(max_slots_count, hierarchy.size());
+                hierarchy.update();
+            });
+
+            /* Reparenting must not copy nodes to the end of the arrays */
+            harness.check(max_slots_count <= slots_count, "TransformHierarchy::setParent grew the hierarchy from " + std::to_string(slots_count) +
+                                                          " to " + std::to_string(max_slots_count) + " slots");
+        }
+
+        /* One entity in ten is a light, like a scene full of props */
+        void benchmarkQuery(Harness & harness, size_t entities_count)
+        {
+            entityx::EventManager  events;
+            entityx::EntityManager entities(events);
+
+            Vertex::EntityQuery<Vertex::PointLightComponent, Vertex::TransformComponent> query;
+            query.configure(entities, events);
+
+            for (size_t i = 0; i < entities_count; ++i)
+            {
+                entityx::Entity entity = entities.create();
+                entity.assign<Vertex::TransformComponent>(glm::vec3(float(i)));
+
+                if (i % 10 == 0)
+                {
+                    entity.assign<Vertex::PointLightComponent>();
+                }
+            }
+
+            query.flush();
+
+            const std::string suffix = "/" + std::to_string(entities_count);
+
+            harness.run("entities_with_components" + suffix, query.size(), [&entities]
+            {
+                entityx::ComponentHandle<Vertex::PointLightComponent> point_light;
+                entityx::ComponentHandle<Vertex::TransformComponent>  transform;
+                float sum = 0.0f;
+
+                for (auto entity : entities.entities_with_components(point_light, transform))
+                {
+                    (void)entity;
+                    sum += point_light->m_range + transform->direction().z;
+                }
+                doNotOptimize(sum);
+            });
+
+            harness.run("EntityQuery::each" + suffix, query.size(), [&query]
+            {
+                float sum = 0.0f;
+
+                query.each([&sum](entityx::Entity entity, Vertex::PointLightComponent & point_light, Vertex::TransformComponent & transform)
+                {
+                    sum += point_light.m_range + transform.direction().z;
+                });
+                doNotOptimize(sum);
+            });
+        }
+
+        struct Projectile
+        {
+            glm::vec3 m_velocity;
+            float     m_lifetime;
+        };
+
+        /* A frame that spawns a volley of projectiles and clears the previous one */
+        void benchmarkSpawn(Harness & harness, size_t count)
+        {
+            entityx::EventManager  events;
+            entityx::EntityManager entities(events);
+
+            Vertex::EntityQuery<Projectile, Vertex::TransformComponent> query;
+            query.configure(entities, events);
+
+            Vertex::TransformHierarchy & hierarchy = Vertex::TransformComponent::hierarchy();
+            std::vector<entityx::Entity> spawned;
+
+            const Vertex::TransformComponent transform(glm::vec3(0.0f, 1.0f, 0.0f));
+            const Projectile projectile = { glm::vec3(0.0f, 0.0f, -50.0f), 2.0f };
+
+            /* Reference: one entity at a time, as GameObject does it */
+            harness.run("spawn/one by one/" + std::to_string(count), count, [&]
+            {
+                Vertex::EntitySpawner::despawn(spawned);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    entityx::Entity entity = entities.create();
+                    entity.assign<Vertex::TransformComponent>(glm::vec3(0.0f, 1.0f, 0.0f));
+                    entity.assign<Projectile>(projectile);
+
+                    Vertex::SceneGraphSystem::root().addChild(entity.component<Vertex::TransformComponent>());
+                    spawned.push_back(entity);
+                }
+
+                query.flush();
+                hierarchy.update();
+            });
+
+            harness.run("EntitySpawner::spawn/" + std::to_string(count), count, [&]
+            {
+                Vertex::EntitySpawner::despawn(spawned);
+                Vertex::EntitySpawner::spawn(entities, events, count, spawned, transform, projectile);
+
+                query.flush();
+                hierarchy.update();
+            });
+
+            /* The queries used to erase from the middle of a vector on every removal. Every despawn gets a fresh volley */
+            harness.runWithSetupEach("EntitySpawner::despawn/" + std::to_string(count), count, [&]
+            {
+                Vertex::EntitySpawner::despawn(spawned);
+                Vertex::EntitySpawner::spawn(entities, events, count, spawned, transform, projectile);
+
+                query.flush();
+                hierarchy.update();
+            },
+            [&]
+            {
+                Vertex::EntitySpawner::despawn(spawned);
+                query.flush();
+            });
+
+            Vertex::EntitySpawner::despawn(spawned);
+            hierarchy.update();
+        }
+
+        void benchmarkSortAlpha(Harness & harness, size_t items_count)
+        {
+            std::mt19937 random(42);
+            std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+            std::vector<Vertex::RenderItem> items(items_count);
+
+            for (auto & item : items)
+            {
+                item.m_is_static    = false;
+                item.m_position  = glm::vec3(distribution(random), distribution(random), distribution(random));
+            }
+
+            Vertex::RenderSnapshot snapshot;
+            snapshot.m_camera.m_position = glm::vec3(0.0f, 2.0f, 10.0f);
+            snapshot.m_alpha_items.reserve(items_count);
+
+            /* Sorting an already sorted range would be faster than in a real frame, so the copy is measured too */
+            harness.run("RenderingSystem::sortAlpha/" + std::to_string(items_count), items_count, [&snapshot, &items]
+            {
+                snapshot.m_alpha_items.assign(items.begin(), items.end());
+                Vertex::RenderingSystem::sortAlpha(snapshot);
+                doNotOptimize(snapshot.m_alpha_items.front());
+            });
+        }
+
+        void benchmarkGeometry(Harness & harness)
+        {
+            using Vertex::GeomPrimitive;
+            using Vertex::VertexBuffers;
+
+            harness.run("GeomPrimitive::genCube", 1, []
+            {
+                VertexBuffers buffers;
+                GeomPrimitive::genCube(buffers, 1.0f);
+                doNotOptimize(buffers.m_vertices.data());
+            });
+
+            harness.run("GeomPrimitive::genPlane/64x64", 1, []
+            {
+                VertexBuffers buffers;
+                GeomPrimitive::genPlane(buffers, 10.0f, 10.0f, 64, 64);
+                doNotOptimize(buffers.m_vertices.data());
+            });
+
+            harness.run("GeomPrimitive::genSphere/64", 1, []
+            {
+                VertexBuffers buffers;
+                GeomPrimitive::genSphere(buffers, 1.5f, 64);
+                doNotOptimize(buffers.m_vertices.data());
+            });
+
+            harness.run("GeomPrimitive::genTorus/64x64", 1, []
+            {
+                VertexBuffers buffers;
+                GeomPrimitive::genTorus(buffers, 1.0f, 2.0f, 64, 64);
+                doNotOptimize(buffers.m_vertices.data());
+            });
+
+            harness.run("GeomPrimitive::genCylinder/64", 1, []
+            {
+                VertexBuffers buffers;
+                GeomPrimitive::genCylinder(buffers, 3.0f, 1.5f, 64);
+                doNotOptimize(buffers.m_vertices.data());
+            });
+
+            harness.run("GeomPrimitive::genCone/64x64", 1, []
+            {
+                VertexBuffers buffers;
+                GeomPrimitive::genCone(buffers, 3.0f, 1.5f, 64, 64);
+                doNotOptimize(buffers.m_vertices.data());
+            });
+
+            VertexBuffers sphere;
+            GeomPrimitive::genSphere(sphere, 1.5f, 128);
+
+            harness.run("Model::calcTangentSpace/sphere128", sphere.m_indices.size() / 3, [&sphere]
+            {
+                Vertex::Model::calcTangentSpace(sphere);
+                doNotOptimize(sphere.m_vertices.front());
+            });
+        }
+
+        void benchmarkAffineMath(Harness & harness)
+        {
+            using Vertex::AffineMath;
+
+            const size_t count = 1024;
+
+            std::mt19937 random(42);
+            std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+            std::vector<glm::vec3> positions(count);
+            std::vector<glm::quat> orientations(count);
+            std::vector<glm::vec3> scales(count);
+            std::vector<glm::mat4> parents(count);
+            std::vector<glm::mat4> locals(count);
+            std::vector<glm::mat4> results(count);
+            std::vector<glm::mat3> normal_matrices(count);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                positions[i]    = glm::vec3(distribution(random), distribution(random), distribution(random)) * 100.0f;
+                orientations[i] = glm::normalize(glm::quat(distribution(random), distribution(random), distribution(random), distribution(random)));
+                scales[i]       = glm::vec3(1.0f) + glm::abs(glm::vec3(distribution(random), distribution(random), distribution(random)));
+                parents[i]      = AffineMath::composeTRS(positions[i], orientations[i], glm::vec3(scales[i].x));
+            }
+
+            /* Baselines are the glm code the engine used before */
+            harness.run("AffineMath::composeTRS/glm baseline", count, [&]
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    locals[i] = glm::translate(glm::mat4(1.0f), positions[i]) * glm::mat4_cast(orientations[i]) * glm::scale(glm::mat4(1.0f), scales[i]);
+                }
+                doNotOptimize(locals.front());
+            });
+
+            harness.run("AffineMath::composeTRS", count, [&]
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    locals[i] = AffineMath::composeTRS(positions[i], orientations[i], scales[i]);
+                }
+                doNotOptimize(locals.front());
+            });
+
+            harness.run("AffineMath::multiply/glm baseline", count, [&]
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    results[i] = parents[i] * locals[i];
+                }
+                doNotOptimize(results.front());
+            });
+
+            harness.run("AffineMath::multiply", count, [&]
+            {
+                AffineMath::multiply(parents.data(), locals.data(), results.data(), count);
+                doNotOptimize(results.front());
+            });
+
+            harness.run("AffineMath::normalMatrix/glm baseline", count, [&]
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    normal_matrices[i] = glm::mat3(glm::transpose(glm::inverse(locals[i])));
+                }
+                doNotOptimize(normal_matrices.front());
+            });
+
+            harness.run("AffineMath::normalMatrix", count, [&]
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    normal_matrices[i] = AffineMath::normalMatrix(locals[i]);
+                }
+                doNotOptimize(normal_matrices.front());
+            });
+
+            harness.run("AffineMath::normalMatrixUniform", count, [&]
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    normal_matrices[i] = AffineMath::normalMatrixUniform(parents[i]);
+                }
+                doNotOptimize(normal_matrices.front());
+            });
+
+            const glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+            glm::mat4 light_matrices[6];
+
+            harness.run("RenderingSystem::pointLightMatrices/glm baseline", 6, [&]
+            {
+                const glm::vec3 & position = positions.front();
+
+                light_matrices[0] = projection * glm::lookAt(position, position + glm::vec3( 1,  0,  0), glm::vec3(0, -1,  0));
+                light_matrices[1] = projection * glm::lookAt(position, position + glm::vec3(-1,  0,  0), glm::vec3(0, -1,  0));
+                light_matrices[2] = projection * glm::lookAt(position, position + glm::vec3( 0,  1,  0), glm::vec3(0,  0,  1));
+                light_matrices[3] = projection * glm::lookAt(position, position + glm::vec3( 0, -1,  0), glm::vec3(0,  0, -1));
+                light_matrices[4] = projection * glm::lookAt(position, position + glm::vec3( 0,  0,  1), glm::vec3(0, -1,  0));
+                light_matrices[5] = projection * glm::lookAt(position, position + glm::vec3( 0,  0, -1), glm::vec3(0, -1,  0));
+                doNotOptimize(light_matrices[0]);
+            });
+
+            harness.run("RenderingSystem::pointLightMatrices", 6, [&]
+            {
+                Vertex::RenderingSystem::pointLightMatrices(projection, positions.front(), light_matrices);
+                doNotOptimize(light_matrices[0]);
+            });
+        }
+
+        /* Names of the uniforms that RenderingSystem sets every frame */
+        const char * const UNIFORM_NAMES[] =
+        {
+            G_MVP, G_MODEL_MATRIX, G_NORMAL_MATRIX, G_CAM_POS, "s_scene_ambient", "s_light_matrix", "s_light_pos", "s_far_plane",
+            S_DIRECTIONAL_LIGHT ".base.color", S_DIRECTIONAL_LIGHT ".base.intensity", S_DIRECTIONAL_LIGHT ".direction",
+            S_POINT_LIGHT ".base.color", S_POINT_LIGHT ".base.intensity", S_POINT_LIGHT ".atten.constant",
+            S_POINT_LIGHT ".atten.linear", S_POINT_LIGHT ".atten.quadratic", S_POINT_LIGHT ".position", S_POINT_LIGHT ".range",
+            S_SPOT_LIGHT ".point.base.color", S_SPOT_LIGHT ".point.base.intensity", S_SPOT_LIGHT ".point.atten.constant",
+            S_SPOT_LIGHT ".point.atten.linear", S_SPOT_LIGHT ".point.atten.quadratic", S_SPOT_LIGHT ".point.position",
+            S_SPOT_LIGHT ".point.range", S_SPOT_LIGHT ".direction", S_SPOT_LIGHT ".cutoff"
+        };
+
+        const size_t UNIFORMS_COUNT = sizeof(UNIFORM_NAMES) / sizeof(UNIFORM_NAMES[0]);
+
+        void benchmarkLookups(Harness & harness)
+        {
+            Vertex::Material material;
+            material.addVector3("m_color", glm::vec3(1.0f));
+            material.addFloat("m_roughness", 0.5f);
+
+            /* Shader::updateUniforms() passes the names it keeps as std::strings */
+            const std::string float_name   = "specular_power";
+            const std::string vector3_name = "m_color";
+            const std::string missing_name = "m_missing";
+
+            harness.run("Material::getFloat", 1, [&material, &float_name]
+            {
+                doNotOptimize(material.getFloat(float_name));
+            });
+
+            harness.run("Material::getVector3", 1, [&material, &vector3_name]
+            {
+                doNotOptimize(material.getVector3(vector3_name));
+            });
+
+            harness.run("Material::getFloat/missing", 1, [&material, &missing_name]
+            {
+                doNotOptimize(material.getFloat(missing_name));
+            });
+
+            /* The same uniforms in the table Shader keeps its locations in */
+            Vertex::UniformTable<GLint> uniforms;
+            std::map<std::string, GLint> uniforms_map;
+
+            for (size_t i = 0; i < UNIFORMS_COUNT; ++i)
+            {
+                uniforms.insert(UNIFORM_NAMES[i], GLint(i));
+                uniforms_map[UNIFORM_NAMES[i]] = GLint(i);
+            }
+
+            harness.run("Shader::uniform lookup/literal", UNIFORMS_COUNT, [&uniforms]
+            {
+                for (size_t i = 0; i < UNIFORMS_COUNT; ++i)
+                {
+                    doNotOptimize(*uniforms.find(UNIFORM_NAMES[i]));
+                }
+            });
+
+            /* Reference: std::map keyed by std::string with a temporary string per lookup, as Shader did before */
+            harness.run("Shader::uniform lookup/std::map baseline", UNIFORMS_COUNT, [&uniforms_map]
+            {
+                for (size_t i = 0; i < UNIFORMS_COUNT; ++i)
+                {
+                    doNotOptimize(uniforms_map.find(UNIFORM_NAMES[i])->second);
+                }
+            });
+        }
+    }
+
+    void runHotPathBenchmarks(Harness & harness)
+    {
+        benchmarkHierarchy(harness, "deep2000", 1, 2000);
+        benchmarkHierarchy(harness, "wide4096", 4096, 1);
+        benchmarkHierarchy(harness, "tree4^6", 4, 6);
+
+        benchmarkReparent(harness, 1000);
+
+        benchmarkQuery(harness, 100000);
+        benchmarkSpawn(harness, 10000);
+
+        benchmarkSortAlpha(harness, 100);
+        benchmarkSortAlpha(harness, 5000);
+
+        benchmarkAffineMath(harness);
+        benchmarkGeometry(harness);
+        benchmarkLookups(harness);
+    }
+}
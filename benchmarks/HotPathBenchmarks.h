@@ -0,0 +1,13 @@
+#pragma once
+
+namespace Bench
+{
+    class Harness;
+
+    /**
+     * Engine code that runs every frame or on every model load: transform hierarchy
+     * updates, sorting transparent items, tangent space and primitive generation,
+     * material and uniform lookups. Nothing here needs a window or GL context.
+     */
+    void runHotPathBenchmarks(Harness & harness);
+}
@@ -0,0 +1,194 @@
+#include "SchedulerBenchmark.h"
+
+#include "core_engine/ParallelEach.h"
+#include "core_engine/SystemScheduler.h"
+#include "framework/utilities/JobSystem.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+namespace Bench
+{
+    namespace
+    {
+        struct Position { float x, y, z; };
+        struct Velocity { float x, y, z; };
+        struct Health   { float value, regen; };
+        struct Spin     { float angle, speed; };
+        struct Wave     { float phase, amplitude, value; };
+
+        /* Some floating point work to make every entity cost more than the bookkeeping */
+        float burn(float value, unsigned iterations)
+        {
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                value = std::sin(value) * 0.5f + std::cos(value * 0.25f);
+            }
+
+            return value;
+        }
+
+        const unsigned WORK_ITERATIONS = 16;
+
+        class MovementSystem : public entityx::System<MovementSystem>
+        {
+        public:
+            void update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt) override
+            {
+                float step = float(dt);
+
+                Vertex::parallelEach<Position, Velocity>(entities, [step](entityx::Entity entity, Position & position, Velocity & velocity)
+                {
+                    position.x += velocity.x * step;
+                    position.y += burn(velocity.y, WORK_ITERATIONS) * step;
+                    position.z += velocity.z * step;
+                });
+            }
+        };
+
+        class HealthSystem : public entityx::System<HealthSystem>
+        {
+        public:
+            void update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt) override
+            {
+                entities.each<Health>([dt](entityx::Entity entity, Health & health)
+                {
+                    health.value = burn(health.value + health.regen * float(dt), WORK_ITERATIONS);
+                });
+            }
+        };
+
+        class SpinSystem : public entityx::System<SpinSystem>
+        {
+        public:
+            void update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt) override
+            {
+                entities.each<Spin>([dt](entityx::Entity entity, Spin & spin)
+                {
+                    spin.angle = burn(spin.angle + spin.speed * float(dt), WORK_ITERATIONS);
+                });
+            }
+        };
+
+        class WaveSystem : public entityx::System<WaveSystem>
+        {
+        public:
+            void update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt) override
+            {
+                entities.each<Wave>([dt](entityx::Entity entity, Wave & wave)
+                {
+                    wave.phase += float(dt);
+                    wave.value = wave.amplitude * burn(wave.phase, WORK_ITERATIONS);
+                });
+            }
+        };
+
+        /* Depends on MovementSystem and WaveSystem */
+        class FollowSystem : public entityx::System<FollowSystem>
+        {
+        public:
+            void update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt) override
+            {
+                Vertex::parallelEach<Position, Wave>(entities, [](entityx::Entity entity, Position & position, Wave & wave)
+                {
+                    position.y = burn(position.y + wave.value, WORK_ITERATIONS);
+                });
+            }
+        };
+
+        struct World : public entityx::EntityX
+        {
+            explicit World(unsigned entities_count)
+            {
+                for (unsigned i = 0; i < entities_count; ++i)
+                {
+                    float f = float(i);
+
+                    entityx::Entity entity = entities.create();
+                    entity.assign<Position>(Position{ f, 0.0f, -f });
+                    entity.assign<Velocity>(Velocity{ 1.0f, 0.5f * f, 0.0f });
+                    entity.assign<Health>(Health{ 100.0f, 0.1f });
+                    entity.assign<Spin>(Spin{ 0.0f, f * 0.01f });
+
+                    if (i % 2 == 0)
+                    {
+                        entity.assign<Wave>(Wave{ f, 2.0f, 0.0f });
+                    }
+                }
+
+                systems.add<MovementSystem>();
+                systems.add<HealthSystem>();
+                systems.add<SpinSystem>();
+                systems.add<WaveSystem>();
+                systems.add<FollowSystem>();
+                systems.configure();
+
+                m_scheduler.add("MovementSystem", [this](entityx::TimeDelta dt) { systems.update<MovementSystem>(dt); })
+                           .reads<Velocity>().writes<Position>();
+                m_scheduler.add("HealthSystem", [this](entityx::TimeDelta dt) { systems.update<HealthSystem>(dt); })
+                           .writes<Health>();
+                m_scheduler.add("SpinSystem", [this](entityx::TimeDelta dt) { systems.update<SpinSystem>(dt); })
+                           .writes<Spin>();
+                m_scheduler.add("WaveSystem", [this](entityx::TimeDelta dt) { systems.update<WaveSystem>(dt); })
+                           .writes<Wave>();
+                m_scheduler.add("FollowSystem", [this](entityx::TimeDelta dt) { systems.update<FollowSystem>(dt); })
+                           .reads<Wave>().writes<Position>();
+                m_scheduler.build();
+            }
+
+            Vertex::SystemScheduler m_scheduler;
+        };
+
+        double measureTick(World & world, unsigned ticks_count)
+        {
+            const entityx::TimeDelta dt = 1.0 / 60.0;
+
+            /* Warm up the caches and wake up the workers */
+            for (unsigned i = 0; i < 5; ++i)
+            {
+                world.m_scheduler.update(dt);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+
+            for (unsigned i = 0; i < ticks_count; ++i)
+            {
+                world.m_scheduler.update(dt);
+            }
+
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+            return elapsed.count() / ticks_count;
+        }
+    }
+
+    void runSchedulerBenchmark(unsigned entities_count, unsigned ticks_count)
+    {
+        unsigned max_threads = std::thread::hardware_concurrency();
+        max_threads = max_threads > 0 ? max_threads : 1;
+
+        std::printf("SystemScheduler: %u entities, %u ticks\n", entities_count, ticks_count);
+        std::printf("%8s %12s %10s\n", "threads", "ms/tick", "speedup");
+
+        World world(entities_count);
+        double single_thread_time = 0.0;
+
+        for (unsigned threads = 1; threads <= max_threads; ++threads)
+        {
+            Vertex::JobSystem::init(threads - 1);
+
+            double tick_time = measureTick(world, ticks_count);
+
+            if (threads == 1)
+            {
+                single_thread_time = tick_time;
+            }
+
+            std::printf("%8u %12.3f %9.2fx\n", threads, tick_time, single_thread_time / tick_time);
+        }
+
+        Vertex::JobSystem::shutdown();
+    }
+}
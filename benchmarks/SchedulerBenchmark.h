@@ -0,0 +1,10 @@
+#pragma once
+
+namespace Bench
+{
+    /**
+     * Runs a synthetic set of systems through the SystemScheduler with 1..N threads
+     * and prints the average tick time and the speedup over a single thread.
+     */
+    void runSchedulerBenchmark(unsigned entities_count, unsigned ticks_count);
+}
@@ -0,0 +1,72 @@
+#include "Benchmark.h"
+#include "HotPathBenchmarks.h"
+#include "SchedulerBenchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*
+ * VertexEngineBench [--json <file>] [--filter <text>] [--min-time <seconds>] [--repetitions <n>]
+ *                   [--scheduler [entities] [ticks]]
+ *
+ * Runs the hot path benchmarks, --json saves their results for comparing commits.
+ * Exits with 1 when a benchmark's check failed.
+ * --scheduler runs the SystemScheduler scaling benchmark instead.
+ */
+int main(int argc, char * args[])
+{
+    const char * json_filename = nullptr;
+    const char * filter        = "";
+    double       min_time      = 0.1;
+    unsigned     repetitions   = 5;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        bool has_value = i + 1 < argc;
+
+        if (strcmp(args[i], "--scheduler") == 0)
+        {
+            unsigned entities_count = i + 1 < argc ? unsigned(std::atoi(args[i + 1])) : 20000;
+            unsigned ticks_count    = i + 2 < argc ? unsigned(std::atoi(args[i + 2])) : 200;
+
+            Bench::runSchedulerBenchmark(entities_count, ticks_count);
+
+            return 0;
+        }
+        else if (strcmp(args[i], "--json") == 0 && has_value)
+        {
+            json_filename = args[++i];
+        }
+        else if (strcmp(args[i], "--filter") == 0 && has_value)
+        {
+            filter = args[++i];
+        }
+        else if (strcmp(args[i], "--min-time") == 0 && has_value)
+        {
+            min_time = std::atof(args[++i]);
+        }
+        else if (strcmp(args[i], "--repetitions") == 0 && has_value)
+        {
+            repetitions = unsigned(std::atoi(args[++i]));
+        }
+        else
+        {
+            std::fprintf(stderr, "Unknown argument %s\n", args[i]);
+            return 1;
+        }
+    }
+
+    Bench::Harness harness(min_time, repetitions);
+    harness.setFilter(filter);
+
+    Bench::runHotPathBenchmarks(harness);
+    harness.printTable();
+
+    if (json_filename && !harness.writeJson(json_filename))
+    {
+        return 1;
+    }
+
+    return harness.hasFailedChecks() ? 1 : 0;
+}
@@ -1,16 +1,48 @@
 #include "scenes/TestDemo.h"
 #include "systems/MoveSystem.h"
 #include "core_engine/VertexCore.h"
+#include "core_components/TransformComponent.h"
+#include "core_components/PointLightComponent.h"
+#include "core_components/SpotLightComponent.h"
+#include <cstdio>
+#include <cstring>
 #include <memory>
 
 int main(int argc, char * args[])
 {
     Vertex::VertexCore vec(std::make_shared<TestDemo>(), 999.0f);
 
-    vec.addSystem<MoveSystem>();
+    vec.addSystem<MoveSystem>().reads<MoveSystemComponent, Vertex::PointLightComponent, Vertex::SpotLightComponent>()
+                               .writes<Vertex::TransformComponent>();
     vec.init(1280, 720, "Vertex Engine");
     //vec.init(1920, 1080, "Vertex Engine");
+
+    /*
+     * --pipelined - renders on a thread of its own, see VertexCore::setPipelinedRendering()
+     * --record-input <file> / --replay-input <file> - the same camera path on every run
+     */
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(args[i], "--pipelined") == 0)
+        {
+            vec.setPipelinedRendering(true);
+        }
+        else if (strcmp(args[i], "--record-input") == 0 && i + 1 < argc)
+        {
+            vec.recordInput(args[i + 1]);
+        }
+        else if (strcmp(args[i], "--replay-input") == 0 && i + 1 < argc)
+        {
+            vec.replayInput(args[i + 1]);
+        }
+    }
+
     vec.start();
+
+    if (vec.isInputReplayFinished())
+    {
+        printf("Input replay finished.\n");
+    }
    
     return 0;
 }
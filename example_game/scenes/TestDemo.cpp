@@ -1,4 +1,5 @@
 #include "TestDemo.h"
+#include "core_engine/AsyncAwait.h"
 #include "core_engine/CoreAssetManager.h"
 #include "core_components/CameraComponent.h"
 #include "framework/window/Window.h"
@@ -16,6 +17,13 @@
 #include "systems/MoveSystem.h"
 #include "framework/gui/GUI.h"
 
+/* The game object is in the scene right away, the model is added once it's loaded */
+static Vertex::AsyncTask streamModel(Vertex::GameObject game_object, std::string filepathname)
+{
+    Vertex::Model model = co_await Vertex::loadModelAsync(filepathname);
+    game_object.addComponent<Vertex::ModelRendererComponent>(model);
+}
+
 TestDemo::TestDemo()
 {
 }
@@ -54,23 +62,34 @@ void TestDemo::init()
     auto sphere_model = Vertex::CoreAssetManager::createModel();
     sphere_model.genSphere(0.5f, 24);
 
-    auto cyborg_model = Vertex::CoreAssetManager::createModel("res/models/cyborg/cyborg.obj");
-    auto zen3c_model = Vertex::CoreAssetManager::createModel("res/models/Zen3C/Zen3C.X");
-    auto damaged_helmet_model = Vertex::CoreAssetManager::createModel("res/models/damaged_helmet/DamagedHelmet.gltf");
-    auto sponza_model = Vertex::CoreAssetManager::createModel("res/models/sponza/Sponza.gltf");
+    /* Read in parallel - the cyborg has children and Zen3C is small, the larger ones are streamed below */
+    auto models = Vertex::CoreAssetManager::createModels({ "res/models/cyborg/cyborg.obj",
+                                                           "res/models/Zen3C/Zen3C.X" });
+    auto cyborg_model = models[0];
+    auto zen3c_model = models[1];
 
     auto wall_model = Vertex::CoreAssetManager::createModel();
     wall_model.genPlane(5, 5, 1, 1);
 
-    auto ground_tex           = Vertex::CoreAssetManager::createTexture2D("res/textures/trak_tile_g.jpg", true);
-    auto brickwall_tex        = Vertex::CoreAssetManager::createTexture2D("res/textures/brickwall.jpg", true);
-    auto brickwall_normal_tex = Vertex::CoreAssetManager::createTexture2D("res/textures/brickwall_normal.jpg");
-    auto bricks2              = Vertex::CoreAssetManager::createTexture2D("res/textures/bricks2.jpg", true);
-    auto bricks2_depth        = Vertex::CoreAssetManager::createTexture2D("res/textures/bricks2_disp.jpg");
-    auto bricks2_normal       = Vertex::CoreAssetManager::createTexture2D("res/textures/bricks2_normal.jpg");
-    auto window_tex           = Vertex::CoreAssetManager::createTexture2D("res/textures/window.png");
-    auto grass_tex            = Vertex::CoreAssetManager::createTexture2D("res/textures/grass.png");
-    auto opengl_logo          = Vertex::CoreAssetManager::createTexture2D("res/textures/opengl.png");
+    /* Decoded in parallel as well */
+    auto srgb_textures = Vertex::CoreAssetManager::createTextures2D({ "res/textures/trak_tile_g.jpg",
+                                                                      "res/textures/brickwall.jpg",
+                                                                      "res/textures/bricks2.jpg" }, true);
+    auto textures = Vertex::CoreAssetManager::createTextures2D({ "res/textures/brickwall_normal.jpg",
+                                                                 "res/textures/bricks2_disp.jpg",
+                                                                 "res/textures/bricks2_normal.jpg",
+                                                                 "res/textures/window.png",
+                                                                 "res/textures/grass.png",
+                                                                 "res/textures/opengl.png" });
+    auto ground_tex           = srgb_textures[0];
+    auto brickwall_tex        = srgb_textures[1];
+    auto bricks2              = srgb_textures[2];
+    auto brickwall_normal_tex = textures[0];
+    auto bricks2_depth        = textures[1];
+    auto bricks2_normal       = textures[2];
+    auto window_tex           = textures[3];
+    auto grass_tex            = textures[4];
+    auto opengl_logo          = textures[5];
 
     auto cyborg = Vertex::CoreAssetManager::createGameObject();
     cyborg.addComponent<Vertex::ModelRendererComponent>(cyborg_model);
@@ -83,15 +102,15 @@ void TestDemo::init()
     zen3c.setScale(0.018f);
 
     auto damaged_helmet = Vertex::CoreAssetManager::createGameObject();
-    damaged_helmet.addComponent<Vertex::ModelRendererComponent>(damaged_helmet_model);
     damaged_helmet.setPosition(3.0f, 2.5f, 0.0f);
     damaged_helmet.setScale(1.0f);
+    streamModel(damaged_helmet, "res/models/damaged_helmet/DamagedHelmet.gltf");
 
     auto sponza = Vertex::CoreAssetManager::createGameObject();
-    sponza.addComponent<Vertex::ModelRendererComponent>(sponza_model);
     sponza.setPosition(-1.5f, 0.0f, 10.0f);
     sponza.setOrientation(0.0f, -90.0f, 0.0f);
     sponza.setScale(6.0f);
+    streamModel(sponza, "res/models/sponza/Sponza.gltf");
 
     auto wall = Vertex::CoreAssetManager::createGameObject();
     wall.addComponent<Vertex::ModelRendererComponent>(wall_model);
@@ -245,6 +264,12 @@ void TestDemo::input(float delta)
         is_debug_render = !is_debug_render;
         Vertex::RenderingSystem::M_DEBUG_RENDERING = is_debug_render;
     }
+
+    if (Vertex::Input::getKeyUp(Vertex::KeyCode::F3))
+    {
+        auto core = Vertex::CoreServices::getCore();
+        core->setPerformanceHUDVisible(!core->isPerformanceHUDVisible());
+    }
 }
 
 void TestDemo::onGUI(float delta)
@@ -275,7 +300,7 @@ void TestDemo::onGUI(float delta)
 //    Vertex::GUI::circleFilled({ Vertex::Window::getWidth() / 2.0f, Vertex::Window::getHeight() / 2.0f}, 2.0f, glm::vec4(0.0, 1.0, 0.0, 1.0));
 //    auto pos = Vertex::GUI::text(Vertex::CoreAssetManager::getFont("Droid48"), "Hello ImGUI Text Demo!", { Vertex::Window::getWidth() / 2.0f, Vertex::Window::getHeight() / 2.0f + 100.0f}, 48.0f, glm::vec4(1.0, 0.0, 0.0, 1.0), true, true);
 //    Vertex::GUI::text(Vertex::CoreAssetManager::getFont("Droid48"), "Hello ImGUI Text Demo2!", { Vertex::Window::getWidth() / 2.0f, pos}, 48.0f, glm::vec4(1.0, 0.0, 0.0, 1.0), true, false);
-    Vertex::GUI::image(Vertex::CoreAssetManager::getTexture2D("res/textures/opengl.png"), { Vertex::Window::getWidth() - 200, 0 }, { Vertex::Window::getWidth(), 100 }, { 1.0f, 1.0f, 1.0f, 0.5f });
+    Vertex::GUI::image(Vertex::CoreAssetManager::getTexture2D("res/textures/opengl.png"), { Vertex::Window::getWidth() - 200.0f, 0.0f }, { float(Vertex::Window::getWidth()), 100.0f }, { 1.0f, 1.0f, 1.0f, 0.5f });
 
     Vertex::GUI::endHUD();
 }
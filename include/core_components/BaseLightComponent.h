@@ -2,6 +2,8 @@
 #include <glm/vec3.hpp>
 #include <glm/mat4x4.hpp>
 
+#include "core_engine/ChangeVersion.h"
+
 namespace Vertex
 {
     class ShadowInfo
@@ -30,21 +32,32 @@ namespace Vertex
         BaseLightComponent(const glm::vec3 & color, float intensity)
             : m_color(color),
               m_intensity(intensity),
-              m_shadow_info(ShadowInfo()) {}
+              m_shadow_info(ShadowInfo()),
+              m_version(ChangeVersion::current()) {}
 
         virtual ~BaseLightComponent() {}
 
         const ShadowInfo & getShadowInfo() const { return m_shadow_info; }
 
-        void setCastsShadows(bool casts_shadows) { m_shadow_info.setCastsShadows(casts_shadows); }
+        void setCastsShadows(bool casts_shadows) { m_shadow_info.setCastsShadows(casts_shadows); markChanged(); }
+
+        void setColor(const glm::vec3 & color) { m_color = color; markChanged(); }
+        void setIntensity(float intensity)     { m_intensity = intensity; markChanged(); }
+
+        /* ChangeVersion of the last change made by a setter or announced with markChanged() */
+        uint32_t version() const { return m_version; }
+
+        /* Needed after writing the fields directly */
+        void markChanged() { m_version = ChangeVersion::current(); }
 
         glm::vec3 m_color;
         float     m_intensity;
 
     protected:
-        void setShadowInfo(const ShadowInfo & shadow_info) { m_shadow_info = shadow_info; }
+        void setShadowInfo(const ShadowInfo & shadow_info) { m_shadow_info = shadow_info; markChanged(); }
 
     private:
         ShadowInfo m_shadow_info;
+        uint32_t   m_version;
     };
 }
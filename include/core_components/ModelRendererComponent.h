@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <memory>
 
+#include "core_engine/ChangeVersion.h"
 #include "framework/rendering/Model.h"
 
 namespace Vertex
@@ -11,19 +12,31 @@ namespace Vertex
         enum class RenderQueue { RQ_OPAQUE, RQ_ALPHA, RQ_ENVIRO_MAPPING_STATIC, RQ_ENVIRO_MAPPING_DYNAMIC };
 
         ModelRendererComponent()
-            : m_render_queue(RenderQueue::RQ_OPAQUE) 
+            : m_render_queue(RenderQueue::RQ_OPAQUE),
+              m_version(ChangeVersion::current())
         {}
 
         explicit ModelRendererComponent(const Model & model, RenderQueue render_queue = RenderQueue::RQ_OPAQUE)
             : m_model(model),
-              m_render_queue(render_queue)
+              m_render_queue(render_queue),
+              m_version(ChangeVersion::current())
         {}
 
         RenderQueue getRenderQueue() const { return m_render_queue; }
 
+        void setModel(const Model & model)             { m_model = model; markChanged(); }
+        void setRenderQueue(RenderQueue render_queue)  { m_render_queue = render_queue; markChanged(); }
+
+        /* ChangeVersion of the last change made by a setter or announced with markChanged() */
+        uint32_t version() const { return m_version; }
+
+        /* Needed after replacing m_model or its meshes directly, the materials may be edited without it */
+        void markChanged() { m_version = ChangeVersion::current(); }
+
         Model m_model;
 
     private:
         RenderQueue m_render_queue;
+        uint32_t    m_version;
     };
 }
@@ -34,6 +34,7 @@ namespace Vertex
         {
             m_attenuation = Attenuation(constant, linear, quadratic);
             calculateRange();
+            markChanged();
         }
 
         Attenuation m_attenuation;
@@ -25,6 +25,7 @@ namespace Vertex
         void setCutOffAngle(float angle)
         {
             m_cutoff = glm::cos(glm::radians(angle));
+            markChanged();
         }
 
         /* 
@@ -2,41 +2,71 @@
 
 #define GLM_ENABLE_EXPERIMENTAL
 
+#include <cassert>
+
 #include <glm/vec3.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/euler_angles.hpp>
 #include <entityx/Entity.h>
 
-#include <vector>
+#include "core_engine/TransformHierarchy.h"
+#include "framework/utilities/AffineMath.h"
 
 namespace Vertex
 {
+    /*
+     * Handle of a node in the TransformHierarchy - the poses and matrices of all the transforms
+     * are stored there and updated in one linear pass by the SceneGraphSystem.
+     * A transform stays in the hierarchy it was created in, parent and children included.
+     */
     class TransformComponent
     {
     public:
         TransformComponent(const glm::vec3 & position    = glm::vec3(0.0f),
                            const glm::vec3 & orientation = glm::vec3(0.0f, 0.0f, 0.0f),
                            const glm::vec3 & scale       = glm::vec3(1.0f))
-            : m_orientation  (orientation),
-              m_position     (position),
-              m_scale        (scale),
-              m_is_dirty     (true),
-              m_world_matrix (glm::mat4(1.0f)),
-              m_normal_matrix(glm::mat3(1.0f)),
-              m_direction    (glm::vec3(0.0f, 0.0f, -1.0f))
+            : m_hierarchy(&hierarchy()),
+              m_node     (m_hierarchy->create(position, glm::quat(orientation), scale)),
+              m_direction(glm::vec3(0.0f, 0.0f, -1.0f))
+        {}
+
+        TransformComponent(const glm::vec3 & position, const glm::quat & orientation, const glm::vec3 & scale)
+            : m_hierarchy(&hierarchy()),
+              m_node     (m_hierarchy->create(position, orientation, scale)),
+              m_direction(glm::vec3(0.0f, 0.0f, -1.0f))
+        {}
+
+        /* A copy is a new root with the same local pose, in the same hierarchy */
+        TransformComponent(const TransformComponent & other)
+            : m_hierarchy(other.m_hierarchy),
+              m_node     (m_hierarchy->create(other.position(), other.orientation(), other.scale())),
+              m_direction(other.m_direction)
         {}
 
+        TransformComponent & operator=(const TransformComponent & other)
+        {
+            setPosition(other.position());
+            setOrientation(other.orientation());
+            setScale(other.scale().x, other.scale().y, other.scale().z);
+            m_direction = other.m_direction;
+
+            return *this;
+        }
+
+        ~TransformComponent()
+        {
+            m_hierarchy->destroy(m_node);
+        }
+
         void setPosition(float x, float y, float z)
         {
-            m_position = glm::vec3(x, y, z);
-            m_is_dirty = true;
+            m_hierarchy->setPosition(m_node, glm::vec3(x, y, z));
         }
 
         void setPosition(const glm::vec3 & position)
         {
-            m_position = position;
-            m_is_dirty = true;
+            m_hierarchy->setPosition(m_node, position);
         }
 
         /*
@@ -45,11 +75,9 @@ namespace Vertex
         
         void setOrientation(float x, float y, float z)
         {
-            m_orientation = glm::angleAxis(glm::radians(x), glm::vec3(1.0f, 0.0f, 0.0f)) *
-                            glm::angleAxis(glm::radians(y), glm::vec3(0.0f, 1.0f, 0.0f)) *
-                            glm::angleAxis(glm::radians(z), glm::vec3(0.0f, 0.0f, 1.0f));
-            m_direction   = glm::normalize(glm::conjugate(m_orientation) * glm::vec3(0.0f, 0.0f, 1.0f));
-            m_is_dirty    = true;
+            setOrientation(glm::angleAxis(glm::radians(x), glm::vec3(1.0f, 0.0f, 0.0f)) *
+                           glm::angleAxis(glm::radians(y), glm::vec3(0.0f, 1.0f, 0.0f)) *
+                           glm::angleAxis(glm::radians(z), glm::vec3(0.0f, 0.0f, 1.0f)));
         }
 
         /*
@@ -57,81 +85,174 @@ namespace Vertex
         */
         void setOrientation(const glm::vec3 & axis, float angle)
         {
-            m_orientation = glm::angleAxis(glm::radians(angle), glm::normalize(axis));
-            m_direction   = glm::normalize(glm::conjugate(m_orientation) * glm::vec3(0.0f, 0.0f, 1.0f));
-            m_is_dirty    = true;
+            setOrientation(glm::angleAxis(glm::radians(angle), glm::normalize(axis)));
         }
 
         void setOrientation(const glm::quat & quat)
         {
-            m_orientation = quat;
-            m_direction   = glm::normalize(glm::conjugate(m_orientation) * glm::vec3(0.0f, 0.0f, 1.0f));
-            m_is_dirty    = true;
+            m_hierarchy->setOrientation(m_node, quat);
+            m_direction = glm::normalize(glm::conjugate(quat) * glm::vec3(0.0f, 0.0f, 1.0f));
         }
 
         void setScale(float x, float y, float z)
         {
-            m_scale    = glm::vec3(x, y, z);
-            m_is_dirty = true;
+            m_hierarchy->setScale(m_node, glm::vec3(x, y, z));
         }
 
         void setScale(float uniform_scale)
         {
-            m_scale    = glm::vec3(uniform_scale);
-            m_is_dirty = true;
+            m_hierarchy->setScale(m_node, glm::vec3(uniform_scale));
         }
 
+        /* The child is moved from its current parent, a transform has at most one */
         void addChild(const entityx::ComponentHandle<TransformComponent> & child)
         {
-            m_children.push_back(child);
+            /* Node ids are only meaningful within their own hierarchy */
+            assert(child->m_hierarchy == m_hierarchy && "The child transform belongs to another World");
+
+            m_hierarchy->setParent(child->m_node, m_node);
         }
 
-        void update(const glm::mat4 & parent_transform, bool dirty)
+        /*
+         * A static transform has its matrices baked once and costs nothing per frame after that.
+         * Changes of its pose are applied when it's made movable again.
+         */
+        void setStatic(bool is_static)
         {
-            dirty |= m_is_dirty;
+            m_hierarchy->setStatic(m_node, is_static);
+        }
 
-            if(dirty)
-            {
-                m_world_matrix  = getUpdatedWorldMatrix();
-                m_world_matrix  = parent_transform * m_world_matrix;
-                m_normal_matrix = glm::mat3(glm::transpose(glm::inverse(m_world_matrix)));
+        bool isStatic() const { return m_hierarchy->isStatic(m_node); }
+
+        /* Makes the transform a root, its local pose becomes the world one */
+        void detach()
+        {
+            m_hierarchy->setParent(m_node, TransformHierarchy::INVALID_INDEX);
+        }
 
-                m_is_dirty = false;
+        /* Moves the transform under the scene root of its own hierarchy, whichever World is current */
+        void attachToSceneRoot()
+        {
+            m_hierarchy->setParent(m_node, m_hierarchy->getSceneRoot());
+        }
+
+        /* The scene's root transform, detached ones go under it - see attachToSceneRoot() */
+        void makeSceneRoot()
+        {
+            m_hierarchy->setSceneRoot(m_node);
+        }
+
+        /* ChangeVersion of the last change of the pose, the parent's ones included */
+        uint32_t version() const { return m_hierarchy->getVersion(m_node); }
+
+        glm::mat4 world_matrix()  const { return m_hierarchy->getWorldMatrix(m_node);  }
+        glm::mat3 normal_matrix() const { return m_hierarchy->getNormalMatrix(m_node); }
+        glm::quat orientation()   const { return m_hierarchy->getOrientation(m_node);  }
+        glm::vec3 position()      const { return m_hierarchy->getPosition(m_node);     }
+        glm::vec3 scale()         const { return m_hierarchy->getScale(m_node);        }
+        glm::vec3 direction()     const { return m_direction;                         }
+
+        TransformHierarchy::NodeId node() const { return m_node; }
+
+        /* Hierarchy the node and its copies are in, which may not be the current one - see hierarchy() */
+        TransformHierarchy & ownHierarchy() const { return *m_hierarchy; }
+
+        /*
+         * The next frame shows the current pose without interpolating from the previous one, e.g. after a teleport
+         */
+        void resetInterpolation()
+        {
+            m_hierarchy->resetInterpolation(m_node);
+        }
+
+        /*
+         * Pose between the previous step (alpha = 0) and the current one (alpha = 1)
+         */
+        glm::vec3 interpolated_position(float alpha) const
+        {
+            return alpha >= 1.0f ? position() : glm::mix(m_hierarchy->getPreviousPosition(m_node), position(), alpha);
+        }
+
+        glm::quat interpolated_orientation(float alpha) const
+        {
+            return alpha >= 1.0f ? orientation() : glm::slerp(m_hierarchy->getPreviousOrientation(m_node), orientation(), alpha);
+        }
+
+        glm::vec3 interpolated_direction(float alpha) const
+        {
+            return alpha >= 1.0f ? m_direction : glm::normalize(glm::conjugate(interpolated_orientation(alpha)) * glm::vec3(0.0f, 0.0f, 1.0f));
+        }
+
+        /*
+         * Translation and scale of the world matrix are interpolated linearly, rotation spherically
+         */
+        void interpolate(float alpha, glm::mat4 & world_matrix, glm::mat3 & normal_matrix) const
+        {
+            const glm::mat4 & current_world_matrix  = m_hierarchy->getWorldMatrix(m_node);
+            const glm::mat4 & previous_world_matrix = m_hierarchy->getPreviousWorldMatrix(m_node);
+
+            if (alpha >= 1.0f || previous_world_matrix == current_world_matrix)
+            {
+                world_matrix  = current_world_matrix;
+                normal_matrix = m_hierarchy->getNormalMatrix(m_node);
+                return;
             }
 
-            for(unsigned i = 0; i < m_children.size(); ++i)
+            glm::vec3 previous_translation, translation;
+            glm::quat previous_rotation,    rotation;
+            glm::vec3 previous_scale,       scale;
+
+            if (!decompose(previous_world_matrix, previous_translation, previous_rotation, previous_scale) ||
+                !decompose(current_world_matrix, translation, rotation, scale))
             {
-                m_children[i]->update(m_world_matrix, dirty);
+                world_matrix  = current_world_matrix;
+                normal_matrix = m_hierarchy->getNormalMatrix(m_node);
+                return;
             }
+
+            translation = glm::mix(previous_translation, translation, alpha);
+            rotation    = glm::slerp(previous_rotation, rotation, alpha);
+            scale       = glm::mix(previous_scale, scale, alpha);
+
+            world_matrix  = AffineMath::composeTRS(translation, rotation, scale);
+            normal_matrix = AffineMath::isUniformScale(scale) ? AffineMath::normalMatrixUniform(world_matrix)
+                                                              : AffineMath::normalMatrix(world_matrix);
         }
 
-        glm::mat4 world_matrix()  const { return m_world_matrix;  }
-        glm::mat3 normal_matrix() const { return m_normal_matrix; }
-        glm::quat orientation()   const { return m_orientation;   }
-        glm::vec3 position()      const { return m_position;      }
-        glm::vec3 scale()         const { return m_scale;         }
-        glm::vec3 direction()     const { return m_direction;     }
+        /* Hierarchy of the World current on the calling thread - the new transforms are created there */
+        static TransformHierarchy & hierarchy() { return TransformHierarchy::current(); }
 
     private:
-        glm::mat4 getUpdatedWorldMatrix() const
+        /* Splits an affine matrix without shear into T * R * S, false if the scale is zero */
+        static bool decompose(const glm::mat4 & matrix, glm::vec3 & translation, glm::quat & rotation, glm::vec3 & scale)
         {
-            glm::mat4 T = glm::translate(glm::mat4(1.0f), m_position);
-            glm::mat4 R = glm::mat4_cast(m_orientation);
-            glm::mat4 S = glm::scale(glm::mat4(1.0f), m_scale);
+            glm::mat3 M(matrix);
+            scale = glm::vec3(glm::length(M[0]), glm::length(M[1]), glm::length(M[2]));
 
-            return T * R * S;
-        }
+            if (scale.x == 0.0f || scale.y == 0.0f || scale.z == 0.0f)
+            {
+                return false;
+            }
 
-        std::vector<entityx::ComponentHandle<TransformComponent>> m_children;
+            M[0] /= scale.x;
+            M[1] /= scale.y;
+            M[2] /= scale.z;
 
-        glm::mat4 m_world_matrix;
-        glm::mat3 m_normal_matrix;
+            /* Mirrored - keep the rotation proper */
+            if (glm::determinant(M) < 0.0f)
+            {
+                scale.x = -scale.x;
+                M[0]    = -M[0];
+            }
+
+            translation = glm::vec3(matrix[3]);
+            rotation    = glm::quat_cast(M);
 
-        glm::quat m_orientation;
-        glm::vec3 m_position;
-        glm::vec3 m_scale;
-        glm::vec3 m_direction;
+            return true;
+        }
 
-        bool m_is_dirty;
+        TransformHierarchy       * m_hierarchy;
+        TransformHierarchy::NodeId m_node;
+        glm::vec3                  m_direction;
     };
 }
@@ -0,0 +1,92 @@
+#pragma once
+
+/**
+ * Coroutine front end of AsyncTasks for games built as C++20 - the engine itself stays C++11,
+ * so the header is empty for older standards. A function returning AsyncTask runs until its
+ * first co_await and is resumed on the main thread at a later frame's sync point:
+ *
+ *     Vertex::AsyncTask TestDemo::spawnHelmet()
+ *     {
+ *         Vertex::Model model = co_await Vertex::loadModelAsync("res/models/damaged_helmet/DamagedHelmet.gltf");
+ *         helmet.addComponent<Vertex::ModelRendererComponent>(model);
+ *
+ *         co_await Vertex::seconds(2.0);
+ *         co_await Vertex::nextFrame();
+ *     }
+ *
+ * Nothing cancels a suspended coroutine - whatever it captured must outlive it, and the ones
+ * still suspended when the engine shuts down are never resumed.
+ */
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include <coroutine>
+#include <exception>
+#include <string>
+
+#include "core_engine/AsyncTasks.h"
+#include "core_engine/CoreAssetManager.h"
+
+namespace Vertex
+{
+    /* Fire and forget, the coroutine frame frees itself when the function returns */
+    struct AsyncTask
+    {
+        struct promise_type
+        {
+            AsyncTask          get_return_object()         { return AsyncTask(); }
+            std::suspend_never initial_suspend()  noexcept { return std::suspend_never(); }
+            std::suspend_never final_suspend()    noexcept { return std::suspend_never(); }
+            void               return_void()               {}
+            void               unhandled_exception()       { std::terminate(); }
+        };
+    };
+
+    struct NextFrameAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_resume() const noexcept {}
+
+        void await_suspend(std::coroutine_handle<> coroutine) const
+        {
+            AsyncTasks::nextFrame([coroutine]() { coroutine.resume(); });
+        }
+    };
+
+    struct SecondsAwaiter
+    {
+        double m_seconds;
+
+        bool await_ready() const noexcept { return m_seconds <= 0.0; }
+        void await_resume() const noexcept {}
+
+        void await_suspend(std::coroutine_handle<> coroutine) const
+        {
+            AsyncTasks::after(m_seconds, [coroutine]() { coroutine.resume(); });
+        }
+    };
+
+    /* Lives in the coroutine frame while it's suspended, so the model can be stored in it */
+    struct ModelAwaiter
+    {
+        std::string m_filepathname;
+        Model       m_model;
+
+        bool  await_ready() const noexcept { return false; }
+        Model await_resume() { return m_model; }
+
+        void await_suspend(std::coroutine_handle<> coroutine)
+        {
+            CoreAssetManager::createModelAsync(m_filepathname, [this, coroutine](const Model & model)
+            {
+                m_model = model;
+                coroutine.resume();
+            });
+        }
+    };
+
+    inline NextFrameAwaiter nextFrame()                               { return NextFrameAwaiter(); }
+    inline SecondsAwaiter   seconds(double seconds)                   { return SecondsAwaiter{ seconds }; }
+    inline ModelAwaiter     loadModelAsync(std::string filepathname)  { return ModelAwaiter{ std::move(filepathname), Model() }; }
+}
+
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "framework/utilities/EventChannel.h"
+
+namespace Vertex
+{
+    /**
+     * Game code that spans frames without blocking one: continuations resumed on the main
+     * thread once per frame, at the sync point after the steps and before the frame is rendered.
+     *
+     * Long blocking work (file reads, parsing) goes to one background thread of its own, not to
+     * the JobSystem - a frame's parallelFor would otherwise pick it up while waiting.
+     *
+     * All the functions except run() and post() must be called from the main thread.
+     */
+    class AsyncTasks final
+    {
+    public:
+        typedef std::function<void()> Task;
+
+        AsyncTasks() = delete;
+        ~AsyncTasks() = delete;
+
+        static void init();
+
+        /* Joins the background thread, the tasks that didn't run yet are dropped */
+        static void shutdown();
+
+        /* task runs at the next frame's sync point */
+        static void nextFrame(Task task);
+
+        /* task runs at the first sync point after the delay */
+        static void after(double seconds, Task task);
+
+        /**
+         * @brief work runs on the background thread, then runs on the main thread at the next
+         *        sync point. Thread safe. Without init() both run right away on the calling thread.
+         */
+        static void run(Task work, Task then);
+
+        /* task runs on the main thread at the next sync point. Thread safe - e.g. to come back from the render thread */
+        static void post(Task task);
+
+        /* Runs the finished continuations, the due timers and the tasks of this frame - called by VertexCore */
+        static void update();
+
+        /* Continuations that didn't run yet, including the ones waiting for the background thread */
+        static std::size_t pendingCount();
+
+    private:
+        struct Background
+        {
+            Task m_work;
+            Task m_then;
+        };
+
+        struct Delayed
+        {
+            double m_time;
+            Task   m_task;
+        };
+
+        static bool isLater(const Delayed & a, const Delayed & b);
+        static void backgroundLoop();
+
+        static std::vector<Task>    m_next_frame;
+        static std::vector<Delayed> m_delayed;     /* Min-heap by time */
+        static EventChannel<Task>   m_finished;
+
+        static std::deque<Background>   m_background;
+        static std::thread              m_background_thread;
+        static std::mutex               m_background_mutex;
+        static std::condition_variable  m_background_submitted;
+        static std::atomic<std::size_t> m_in_flight_count; /* Passed to run(), their then didn't run yet */
+        static bool                     m_stop_requested;
+    };
+}
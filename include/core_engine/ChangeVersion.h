@@ -0,0 +1,27 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Vertex
+{
+    /**
+     * Global clock of the component changes. Setters stamp the component with current(),
+     * a system that only wants the changes keeps the value advance() returned after it
+     * read them - everything changed since then has a newer version.
+     */
+    class ChangeVersion final
+    {
+    public:
+        static uint32_t current() { return m_clock.load(std::memory_order_relaxed); }
+
+        /* Returns the version of everything seen so far, the changes made from now on get a newer one */
+        static uint32_t advance() { return m_clock.fetch_add(1, std::memory_order_relaxed); }
+
+        /* Survives the clock wrapping around */
+        static bool isNewer(uint32_t version, uint32_t since) { return int32_t(version - since) > 0; }
+
+    private:
+        static std::atomic<uint32_t> m_clock;
+    };
+}
@@ -1,5 +1,7 @@
 #pragma once
+#include <functional>
 #include <map>
+#include <mutex>
 
 #include "GameObject.h"
 #include "framework/rendering/Texture.h"
@@ -13,14 +15,34 @@ namespace Vertex
     public:
         static GameObject createGameObject();
 
+        /* count GameObjects spawned in one batch, appended to game_objects */
+        static void createGameObjects(std::size_t count, std::vector<GameObject> & game_objects);
+
         static std::shared_ptr<Font>    createFont          (const std::string & font_name, const std::string& filepathname, GLuint font_height);
         static std::shared_ptr<Texture> createTexture2D     (const std::string & filepathname,  bool is_srgb = false, GLint num_mipmaps = 1);
+
+        /* Uploads a file decoded with Texture::import(), stored under the file's name */
+        static std::shared_ptr<Texture> createTexture2D     (const TextureImport & imported,    bool is_srgb = false, GLint num_mipmaps = 1);
+
         static std::shared_ptr<Texture> createTexture2D1x1  (const std::string & texture_name,  const glm::uvec4 & color);
         static std::shared_ptr<Texture> createCubeMapTexture(const std::string * filepathnames, bool is_srgb = false, GLint num_mipmaps = 1);
 
+        /* The files are decoded in parallel on the job system, the textures are then uploaded in order */
+        static std::vector<std::shared_ptr<Texture>> createTextures2D(const std::vector<std::string> & filepathnames, bool is_srgb = false, GLint num_mipmaps = 1);
+
         static Model createModel(const std::string & filepathname);
         static Model createModel();
 
+        /* The files are read in parallel on the job system, the meshes are then uploaded in order */
+        static std::vector<Model> createModels(const std::vector<std::string> & filepathnames);
+
+        /**
+         * @brief Reads the file and decodes its textures on the AsyncTasks' background thread and calls on_loaded
+         *        with the model at a later frame's sync point - never from within the call, even for a loaded model.
+         *        The meshes and textures are uploaded wherever the GL context is, see VertexCore::runOnRenderThread().
+         */
+        static void createModelAsync(const std::string & filepathname, const std::function<void(const Model &)> & on_loaded);
+
         static std::shared_ptr<Shader> createShader(const std::string & shader_name,
                                                     const std::string & compute_shader_filepathname);
 
@@ -57,6 +79,8 @@ namespace Vertex
         static std::vector<GameObject>      m_game_objects;
         static std::map<std::string, Model> m_loaded_models;
 
+        /* Guards the textures - the models loaded with createModelAsync() create theirs on the render thread */
+        static std::mutex                                      m_textures_mutex;
         static std::map<std::string, std::shared_ptr<Texture>> m_loaded_textures;
         static std::map<std::string, std::shared_ptr<Shader>>  m_loaded_shaders;
         static std::map<std::string, std::shared_ptr<Font>>    m_loaded_fonts;
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include <entityx/entityx.h>
+
+#include "core_engine/ChangeVersion.h"
+#include "core_engine/SpawnEvents.h"
+#include "core_engine/SystemScheduler.h"
+#include "framework/utilities/JobSystem.h"
+#include "helpers/Assertions.h"
+
+namespace Vertex
+{
+    namespace Detail
+    {
+        template <std::size_t ... Indices>
+        struct IndexSequence {};
+
+        template <std::size_t N, std::size_t ... Indices>
+        struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, Indices ...> {};
+
+        template <std::size_t ... Indices>
+        struct MakeIndexSequence<0, Indices ...>
+        {
+            typedef IndexSequence<Indices ...> Type;
+        };
+
+        /* Position of T in Types */
+        template <typename T, typename ... Types>
+        struct IndexOf;
+
+        template <typename T, typename ... Types>
+        struct IndexOf<T, T, Types ...>
+        {
+            static const std::size_t value = 0;
+        };
+
+        template <typename T, typename U, typename ... Types>
+        struct IndexOf<T, U, Types ...>
+        {
+            static const std::size_t value = 1 + IndexOf<T, Types ...>::value;
+        };
+    }
+
+    /**
+     * Cached set of the entities that have all the Components, kept up to date with the
+     * component added/removed events. Iterating it is a linear walk over a packed array of
+     * component pointers - no entity masks are scanned and no handles are validated.
+     * entityx never moves a component while it's assigned, so the pointers stay valid.
+     *
+     * The events are only recorded when they're dispatched and applied in order by flush(),
+     * which each() calls first - a whole frame of spawns and despawns costs one linear pass.
+     * Neither is locked, so a query must be flushed where no events can be emitted at the same
+     * time: in a system's update, since only the exclusive systems may emit them (see
+     * SystemScheduler), or on the main thread outside of the systems' update.
+     *
+     * A system keeps the query as a member and calls configure() from its own configure().
+     * Entities must not be created or destroyed and components must not be assigned or
+     * removed while the query is iterated.
+     */
+    template <typename ... Components>
+    class EntityQuery : public entityx::Receiver<EntityQuery<Components ...>>
+    {
+    public:
+        EntityQuery() = default;
+
+        EntityQuery(const EntityQuery &) = delete;
+        EntityQuery & operator=(const EntityQuery &) = delete;
+
+        /* Subscribes to the events and adds the entities that already match */
+        void configure(entityx::EntityManager & entities, entityx::EventManager & events)
+        {
+            int expand[] = { 0, (events.subscribe<entityx::ComponentAddedEvent<Components>>(*this),
+                                 events.subscribe<entityx::ComponentRemovedEvent<Components>>(*this), 0) ... };
+            (void)expand;
+
+            events.subscribe<SpawnBatchEvent>(*this);
+
+            for (auto entity : entities.entities_with_components<Components ...>())
+            {
+                add(entity);
+            }
+        }
+
+        /* Applies the recorded events - each() and parallelEach() do it, so it's only needed before size() */
+        void flush()
+        {
+#ifdef VERTEX_ASSERTS_ENABLED
+            FlushGuard guard(*this);
+#endif
+
+            for (auto & change : m_changes)
+            {
+                if (change.m_added)
+                {
+                    add(change.m_entity);
+                }
+                else
+                {
+                    remove(change.m_entity);
+                }
+            }
+
+            m_changes.clear();
+        }
+
+        /* func(entityx::Entity, Components & ...) */
+        template <typename F>
+        void each(F && func)
+        {
+            flush();
+
+            for (auto & row : m_rows)
+            {
+                call(func, row, Indices());
+            }
+        }
+
+        /**
+         * @brief Same as each(), but only for the entities whose Changed components (any of them) changed
+         *        or that joined the query since the last call. They must have a version() stamped from the ChangeVersion.
+         * @param since Kept by the caller between the calls, starts at 0 - the first call visits everything.
+         */
+        template <typename ... Changed, typename F>
+        void eachChanged(uint32_t & since, F && func)
+        {
+            flush();
+
+            for (auto & row : m_rows)
+            {
+                if (ChangeVersion::isNewer(row.m_version, since) || isChanged<Changed ...>(row, since))
+                {
+                    call(func, row, Indices());
+                }
+            }
+
+            /* The changes made by func itself are not reported back */
+            since = ChangeVersion::advance();
+        }
+
+        /**
+         * @brief Same as each(), but the function is called from many threads at once,
+         *        so it must only touch the components of the entity it was given.
+         */
+        template <typename F>
+        void parallelEach(F && func, std::size_t grain = 0)
+        {
+            flush();
+
+            JobSystem::parallelFor(0, m_rows.size(), [this, &func](std::size_t i)
+            {
+                call(func, m_rows[i], Indices());
+            }, grain);
+        }
+
+        std::size_t size() const { return m_rows.size(); }
+
+        /* The changes are recorded without a lock - see SystemScheduler for who may make them */
+        template <typename C>
+        void receive(const entityx::ComponentAddedEvent<C> & event)
+        {
+            VERTEX_ASSERT_MSG(SystemScheduler::allowsStructuralChanges(), "Components may only be assigned by exclusive systems!");
+            VERTEX_ASSERT_MSG(!isFlushing(), "The query is flushed while its events are emitted!");
+
+            Change change = { event.entity, true };
+            m_changes.push_back(change);
+        }
+
+        template <typename C>
+        void receive(const entityx::ComponentRemovedEvent<C> & event)
+        {
+            VERTEX_ASSERT_MSG(SystemScheduler::allowsStructuralChanges(), "Components may only be removed by exclusive systems!");
+            VERTEX_ASSERT_MSG(!isFlushing(), "The query is flushed while its events are emitted!");
+
+            Change change = { event.entity, false };
+            m_changes.push_back(change);
+        }
+
+        /* The batch may match the query, the rows are cheap to reserve */
+        void receive(const SpawnBatchEvent & event)
+        {
+            VERTEX_ASSERT_MSG(SystemScheduler::allowsStructuralChanges(), "Entities may only be spawned by exclusive systems!");
+            VERTEX_ASSERT_MSG(!isFlushing(), "The query is flushed while its events are emitted!");
+
+            m_rows.reserve(m_rows.size() + event.m_count);
+            m_changes.reserve(m_changes.size() + event.m_count * sizeof...(Components));
+        }
+
+    private:
+        typedef typename Detail::MakeIndexSequence<sizeof...(Components)>::Type Indices;
+
+        struct Row
+        {
+            entityx::Entity               m_entity;
+            std::tuple<Components * ...>  m_components;
+            uint32_t                      m_version; /* When it joined the query */
+        };
+
+        struct Change
+        {
+            entityx::Entity m_entity;
+            bool            m_added;
+        };
+
+#ifdef VERTEX_ASSERTS_ENABLED
+        /* Catches the events emitted on another thread while flush() runs */
+        struct FlushGuard
+        {
+            explicit FlushGuard(EntityQuery & query) : m_query(query) { m_query.m_is_flushing.store(true); }
+            ~FlushGuard() { m_query.m_is_flushing.store(false); }
+
+            EntityQuery & m_query;
+        };
+
+        bool isFlushing() const { return m_is_flushing.load(); }
+
+        std::atomic<bool> m_is_flushing { false };
+#else
+        bool isFlushing() const { return false; }
+#endif
+
+        template <typename ... Changed>
+        static bool isChanged(const Row & row, uint32_t since)
+        {
+            bool is_changed = false;
+            int expand[] = { 0, (is_changed = is_changed ||
+                                 ChangeVersion::isNewer(std::get<Detail::IndexOf<Changed, Components ...>::value>(row.m_components)->version(), since), 0) ... };
+            (void)expand;
+
+            return is_changed;
+        }
+
+        template <typename F, std::size_t ... I>
+        static void call(F & func, Row & row, Detail::IndexSequence<I ...>)
+        {
+            func(row.m_entity, *std::get<I>(row.m_components) ...);
+        }
+
+        void add(entityx::Entity entity)
+        {
+            /* Destroyed, or lost a component again before the flush */
+            if (!entity.valid())
+            {
+                return;
+            }
+
+            bool has_components = true;
+            int expand[] = { 0, (has_components = has_components && entity.has_component<Components>(), 0) ... };
+            (void)expand;
+
+            if (!has_components)
+            {
+                return;
+            }
+
+            const uint32_t index = entity.id().index();
+
+            if (index >= m_rows_indices.size())
+            {
+                m_rows_indices.resize(index + 1, INVALID_ROW);
+            }
+
+            /* Every component of the set reports it */
+            if (m_rows_indices[index] != INVALID_ROW)
+            {
+                return;
+            }
+
+            m_rows_indices[index] = uint32_t(m_rows.size());
+
+            Row row = { entity, std::make_tuple(entity.component<Components>().get() ...), ChangeVersion::current() };
+            m_rows.push_back(row);
+        }
+
+        void remove(entityx::Entity entity)
+        {
+            const uint32_t index = entity.id().index();
+
+            if (index >= m_rows_indices.size() || m_rows_indices[index] == INVALID_ROW)
+            {
+                return;
+            }
+
+            /* The index may belong to a newer entity already */
+            const uint32_t row = m_rows_indices[index];
+
+            if (m_rows[row].m_entity.id() != entity.id())
+            {
+                return;
+            }
+
+            /* The last row takes the removed one's place */
+            m_rows[row] = m_rows.back();
+            m_rows_indices[m_rows[row].m_entity.id().index()] = row;
+
+            m_rows.pop_back();
+            m_rows_indices[index] = INVALID_ROW;
+        }
+
+        static const uint32_t INVALID_ROW = 0xFFFFFFFFu;
+
+        std::vector<Row>      m_rows;
+        std::vector<uint32_t> m_rows_indices; /* By entity index */
+        std::vector<Change>   m_changes;
+    };
+
+    template <typename ... Components>
+    const uint32_t EntityQuery<Components ...>::INVALID_ROW;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <entityx/entityx.h>
+
+#include "core_components/TransformComponent.h"
+#include "core_engine/SpawnEvents.h"
+
+namespace Vertex
+{
+    /**
+     * Creates and destroys entities in batches. Destroyed entities go back to the entityx pools
+     * and their transforms to the TransformHierarchy, so the next batch reuses their storage.
+     */
+    class EntitySpawner final
+    {
+    public:
+        /**
+         * @brief Creates count entities and copy-constructs the given components in place in each of
+         *        them. Transforms are copied into the hierarchy of the given one and attached under its
+         *        scene root, like the ones of GameObjects - spawning a World's transforms takes one of that World.
+         * @param spawned The new entities are appended to it.
+         */
+        template <typename ... Components>
+        static void spawn(entityx::EntityManager & entities,
+                          entityx::EventManager  & events,
+                          std::size_t              count,
+                          std::vector<entityx::Entity> & spawned,
+                          const Components & ...   components)
+        {
+            events.emit<SpawnBatchEvent>(count);
+
+            /* The copies go to the given transform's hierarchy, not necessarily the current one */
+            if (TransformHierarchy * hierarchy = hierarchyOf(components ...))
+            {
+                hierarchy->reserve(count);
+            }
+
+            const std::size_t first = spawned.size();
+            spawned.reserve(first + count);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                entityx::Entity entity = entities.create();
+
+                int expand[] = { 0, (entity.assign<Components>(components), 0) ... };
+                (void)expand;
+
+                attachToRoot(entity);
+                spawned.push_back(entity);
+            }
+
+            events.emit<EntitiesSpawnedEvent>(spawned.data() + first, count);
+        }
+
+        static void despawn(std::vector<entityx::Entity> & spawned)
+        {
+            for (auto & entity : spawned)
+            {
+                if (entity.valid())
+                {
+                    entity.destroy();
+                }
+            }
+
+            spawned.clear();
+        }
+
+    private:
+        static TransformHierarchy * hierarchyOf()
+        {
+            return nullptr;
+        }
+
+        template <typename ... Rest>
+        static TransformHierarchy * hierarchyOf(const TransformComponent & transform, const Rest & ...)
+        {
+            return &transform.ownHierarchy();
+        }
+
+        template <typename Component, typename ... Rest>
+        static TransformHierarchy * hierarchyOf(const Component &, const Rest & ... rest)
+        {
+            return hierarchyOf(rest ...);
+        }
+
+        static void attachToRoot(entityx::Entity & entity)
+        {
+            auto transform = entity.component<TransformComponent>();
+
+            /* The copy is in the prototype's hierarchy, which the current World may not own */
+            if (transform)
+            {
+                transform->attachToSceneRoot();
+            }
+        }
+    };
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+#include <entityx/entityx.h>
+
+#include "framework/utilities/EventChannel.h"
+
+namespace Vertex
+{
+    /**
+     * One EventChannel per event type, for the threads that must not emit through the
+     * entityx EventManager directly (jobs, loaders, audio). dispatch() emits everything
+     * posted so far on the calling thread, so the receivers run at a defined point of the
+     * frame and never on the posting thread.
+     *
+     * The order of the events is kept within a type, not across the types.
+     */
+    class EventChannels final
+    {
+    public:
+        EventChannels();
+        ~EventChannels();
+
+        EventChannels(const EventChannels &) = delete;
+        EventChannels & operator=(const EventChannels &) = delete;
+
+        /* Thread safe, locks only the first time a type is posted */
+        template <typename E, typename ... Args>
+        void post(Args && ... args)
+        {
+            channel<E>().post(std::forward<Args>(args) ...);
+        }
+
+        template <typename E>
+        EventChannel<E> & channel()
+        {
+            const std::size_t family = familyOf<E>();
+            BaseRelay * relay = m_relays[family].load(std::memory_order_acquire);
+
+            if (!relay)
+            {
+                std::lock_guard<std::mutex> lock(m_relays_mutex);
+                relay = m_relays[family].load(std::memory_order_relaxed);
+
+                if (!relay)
+                {
+                    relay = new Relay<E>();
+                    m_relays[family].store(relay, std::memory_order_release);
+                }
+            }
+
+            return static_cast<Relay<E> *>(relay)->m_channel;
+        }
+
+        /* Emits the posted events through the manager on the calling thread, only one thread may call it */
+        void dispatch(entityx::EventManager & events);
+
+        static const std::size_t MAX_CHANNELS = 64;
+
+    private:
+        struct BaseRelay
+        {
+            virtual ~BaseRelay() {}
+            virtual void dispatch(entityx::EventManager & events) = 0;
+        };
+
+        template <typename E>
+        struct Relay : BaseRelay
+        {
+            void dispatch(entityx::EventManager & events) override
+            {
+                m_channel.drain([&events](const E & event)
+                {
+                    events.emit(event);
+                });
+            }
+
+            EventChannel<E> m_channel;
+        };
+
+        template <typename E>
+        static std::size_t familyOf()
+        {
+            static const std::size_t family = nextFamily();
+            return family;
+        }
+
+        static std::size_t nextFamily();
+
+        std::atomic<BaseRelay *> m_relays[MAX_CHANNELS];
+        std::mutex               m_relays_mutex;
+
+        static std::atomic<std::size_t> m_families_count;
+    };
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+namespace Vertex
+{
+    /**
+     * Decides when the fixed step loop runs its next steps and how it waits
+     * for them, instead of busy polling the clock.
+     *
+     * The steps are due every step_time seconds. When the loop falls behind
+     * (e.g. a stall while loading) at most max catch-up steps are run at once
+     * and the rest of the backlog is dropped, so a slow frame can't turn into
+     * ever more steps to catch up with.
+     */
+    class FramePacer final
+    {
+    public:
+        enum class Mode
+        {
+            SPIN,          /* Busy waits - the tightest timing, burns a whole core */
+            HYBRID_SLEEP,  /* Sleeps while it's safe, spins for the last bit */
+            YIELD          /* Gives the time slice back to the OS while waiting */
+        };
+
+        struct Stats
+        {
+            Stats()
+                : m_mean_frame_time(0.0),
+                  m_jitter(0.0),
+                  m_max_lateness(0.0),
+                  m_frames_count(0),
+                  m_dropped_steps(0)
+            {}
+
+            double m_mean_frame_time;  /* Seconds between two frames */
+            double m_jitter;           /* Standard deviation of the frame time */
+            double m_max_lateness;     /* The worst wake up after the deadline */
+
+            unsigned long long m_frames_count;
+            unsigned long long m_dropped_steps;
+        };
+
+        explicit FramePacer(double step_time);
+
+        void setMode(Mode mode) { m_mode = mode; }
+        Mode getMode() const    { return m_mode; }
+
+        void     setMaxCatchUpSteps(unsigned int steps_count);
+        unsigned getMaxCatchUpSteps() const { return m_max_catch_up_steps; }
+
+        double getStepTime() const { return m_step_time; }
+
+        /**
+         * Limits how often waitForFrame() lets the loop render, 0 - no limit,
+         * e.g. when v-sync already blocks the swap until the next refresh.
+         */
+        void   setMaxFrameRate(double frames_per_second);
+        double getMaxFrameRate() const { return m_min_frame_time > 0.0 ? 1.0 / m_min_frame_time : 0.0; }
+
+        /* Starts counting the steps from now */
+        void reset();
+
+        /**
+         * @brief Waits until the next step is due.
+         * @return Number of steps to run now, between 1 and the max catch-up steps.
+         */
+        unsigned int waitForSteps();
+
+        /**
+         * @brief For loops that render between the steps: waits for the next frame,
+         *        at most until the next step is due.
+         * @return Number of steps to run now, between 0 and the max catch-up steps.
+         */
+        unsigned int waitForFrame();
+
+        /**
+         * How far the last wait got from the last due step to the next one, in range [0, 1].
+         * The renderer interpolates between the previous and the current step by it.
+         */
+        double getInterpolationAlpha() const { return m_interpolation_alpha; }
+
+        const Stats & getStats() const { return m_stats; }
+        void resetStats();
+
+    private:
+        unsigned int takeDueSteps(double now);
+        void waitUntil(double deadline);
+        void sleepUntil(double deadline);
+        void recordFrame(double now);
+
+        Mode     m_mode;
+        double   m_step_time;
+        unsigned m_max_catch_up_steps;
+
+        double m_next_step_time;
+        double m_last_frame_time;
+        double m_min_frame_time;
+        double m_interpolation_alpha;
+
+        /* Running estimate of how long sleep_for(1ms) really takes, the hybrid mode spins for the rest */
+        double             m_sleep_estimate;
+        double             m_sleep_mean;
+        double             m_sleep_m2;
+        unsigned long long m_sleep_count;
+
+        Stats  m_stats;
+        double m_frame_time_m2;
+        bool   m_has_last_frame; /* m_last_frame_time is set */
+    };
+}
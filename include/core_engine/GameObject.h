@@ -4,11 +4,19 @@
 
 namespace Vertex
 {
+    class World;
+
     class GameObject
     {
     public:
         GameObject();
 
+        /* Wraps an entity that has a TransformComponent already, e.g. one made by EntitySpawner */
+        explicit GameObject(entityx::Entity entity);
+
+        /* New object in the world instead of the engine's scene */
+        explicit GameObject(World & world);
+
         template <typename S, typename ... Args>
         void addComponent(Args && ... args)
         {
@@ -30,8 +38,12 @@ namespace Vertex
         void setOrientation(const glm::quat & quat);
         void setScale(float x, float y, float z);
         void setScale(float uniform_scale);
+        void setStatic(bool is_static);
         void addChild(GameObject & child);
 
+        /* Moves the object from its parent back under the scene's root */
+        void detach();
+
     protected:
         entityx::Entity entity;
     };
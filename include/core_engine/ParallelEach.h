@@ -0,0 +1,36 @@
+#pragma once
+
+#include <entityx/entityx.h>
+
+#include "framework/utilities/FrameAllocator.h"
+#include "framework/utilities/JobSystem.h"
+
+namespace Vertex
+{
+    /**
+     * @brief Parallel version of entities.each<Components...>(func). The function
+     *        receives the same arguments - (entityx::Entity, Components & ...) -
+     *        but is called from many threads at once, so it must only touch the
+     *        components of the entity it was given.
+     *        Entities must not be created or destroyed and components must not
+     *        be assigned or removed during the loop.
+     * @param grain Number of entities in a single job; 0 picks it automatically.
+     */
+    template <typename ... Components, typename F>
+    void parallelEach(entityx::EntityManager & entities, F && func, std::size_t grain = 0)
+    {
+        FrameVector<entityx::Entity> matching_entities;
+        matching_entities.reserve(entities.size());
+
+        for (auto entity : entities.entities_with_components<Components ...>())
+        {
+            matching_entities.push_back(entity);
+        }
+
+        JobSystem::parallelFor(0, matching_entities.size(), [&matching_entities, &func](std::size_t i)
+        {
+            entityx::Entity entity = matching_entities[i];
+            func(entity, *entity.component<Components>().get() ...);
+        }, grain);
+    }
+}
@@ -1,14 +1,130 @@
 ﻿#pragma once
-#include "GameObject.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <entityx/entityx.h>
+
+#include "core_components/TransformComponent.h"
 
 namespace Vertex
 {
-    class Prefab
+    /* Where an instance of a prefab goes - applied on top of the pose of the prefab's root */
+    struct PrefabPlacement
+    {
+        PrefabPlacement(const glm::vec3 & position    = glm::vec3(0.0f),
+                        const glm::quat & orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                        const glm::vec3 & scale       = glm::vec3(1.0f))
+            : m_position   (position),
+              m_orientation(orientation),
+              m_scale      (scale)
+        {}
+
+        glm::vec3 m_position;
+        glm::quat m_orientation;
+        glm::vec3 m_scale;
+    };
+
+    /**
+     * Prototype of an object: a small hierarchy of nodes, each with a local pose and a set of
+     * components. Nothing of it lives in the world - instantiate() creates the entities, copies
+     * the prototype components into them type by type and links the transforms in one pass.
+     *
+     * Nodes are kept in pre-order (a parent is always added before its children), so a clone's
+     * parent is created before the clone itself and no fix-ups are needed.
+     */
+    class Prefab final
     {
     public:
-        Prefab() {}
-        virtual ~Prefab() {}
+        typedef uint32_t NodeIndex;
+
+        static const NodeIndex ROOT = 0;
+
+        Prefab(const glm::vec3 & position    = glm::vec3(0.0f),
+               const glm::quat & orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+               const glm::vec3 & scale       = glm::vec3(1.0f))
+        {
+            m_nodes.push_back(Node{ position, orientation, scale, INVALID_NODE, false });
+        }
+
+        NodeIndex addNode(NodeIndex         parent,
+                          const glm::vec3 & position    = glm::vec3(0.0f),
+                          const glm::quat & orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                          const glm::vec3 & scale       = glm::vec3(1.0f))
+        {
+            /* Pre-order - the parent must exist already */
+            assert(parent < m_nodes.size() && "Prefab parent node doesn't exist yet");
+
+            m_nodes.push_back(Node{ position, orientation, scale, parent, false });
+            return NodeIndex(m_nodes.size() - 1);
+        }
+
+        /* The component is constructed once here and copy-constructed into every instance */
+        template <typename C, typename ... Args>
+        void addComponent(NodeIndex node, Args && ... args)
+        {
+            static_assert(!std::is_same<C, TransformComponent>::value, "The pose of a node is given to addNode()");
+            assert(node < m_nodes.size() && "Prefab node doesn't exist");
+
+            m_components.push_back(Component{ node, std::make_shared<C>(std::forward<Args>(args) ...), &assignCopies<C> });
+        }
+
+        void setStatic(NodeIndex node, bool is_static)
+        {
+            assert(node < m_nodes.size() && "Prefab node doesn't exist");
+            m_nodes[node].m_is_static = is_static;
+        }
+
+        std::size_t nodesCount() const { return m_nodes.size(); }
+
+        /**
+         * @brief Creates an instance for every placement. The roots are attached under the scene's root.
+         * @param spawned The entities of all the nodes of all the instances are appended to it,
+         *                instance by instance, each instance's root first.
+         */
+        void instantiate(entityx::EntityManager & entities,
+                         entityx::EventManager  & events,
+                         const std::vector<PrefabPlacement> & placements,
+                         std::vector<entityx::Entity> & spawned) const;
+
+    private:
+        static const NodeIndex INVALID_NODE = 0xFFFFFFFFu;
+
+        typedef void (*AssignCopies)(const void * prototype, entityx::Entity * entities, std::size_t stride, std::size_t count);
+
+        struct Node
+        {
+            glm::vec3 m_position;
+            glm::quat m_orientation;
+            glm::vec3 m_scale;
+            NodeIndex m_parent;
+            bool      m_is_static;
+        };
+
+        struct Component
+        {
+            NodeIndex             m_node;
+            std::shared_ptr<void> m_prototype;
+            AssignCopies          m_assign_copies;
+        };
+
+        /* One indirect call per component of the prototype, the copies themselves are a tight typed loop */
+        template <typename C>
+        static void assignCopies(const void * prototype, entityx::Entity * entities, std::size_t stride, std::size_t count)
+        {
+            const C & component = *static_cast<const C *>(prototype);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                entities[i * stride].assign<C>(component);
+            }
+        }
 
-        virtual std::shared_ptr<GameObject> create() = 0;
+        std::vector<Node>      m_nodes;
+        std::vector<Component> m_components;
     };
 }
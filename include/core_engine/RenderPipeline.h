@@ -0,0 +1,97 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <entityx/entityx.h>
+
+#include "core_components/ModelRendererComponent.h"
+#include "framework/rendering/RenderSnapshot.h"
+
+namespace Vertex
+{
+    /**
+     * Renders snapshots on a dedicated thread, so the simulation thread can build
+     * the snapshot of frame N+1 while frame N is being submitted to the GPU.
+     * The GL context is owned by the render thread while the pipeline is running.
+     *
+     * With N snapshots the simulation can run at most N-1 frames ahead of the
+     * render thread - beginSnapshot() blocks when all the snapshots are in use.
+     */
+    class RenderPipeline final : public entityx::Receiver<RenderPipeline>
+    {
+    public:
+        typedef std::function<void(RenderSnapshot &)> RenderFunction;
+        typedef std::function<void()>                 Task;
+
+        RenderPipeline();
+        ~RenderPipeline();
+
+        RenderPipeline(const RenderPipeline &) = delete;
+        RenderPipeline & operator=(const RenderPipeline &) = delete;
+
+        /**
+         * @brief Takes the GL context from the calling thread and starts the render thread.
+         * @param snapshots_count 2 for double buffering, 3 for triple buffering.
+         */
+        void start(entityx::EventManager & events, unsigned snapshots_count, const RenderFunction & render_function);
+
+        /**
+         * @brief Renders pending snapshots, stops the render thread and gives the GL context back.
+         */
+        void stop();
+
+        bool isRunning() const { return m_is_running; }
+
+        /* Returns a free snapshot to fill, waits for the render thread if there is none */
+        RenderSnapshot & beginSnapshot();
+
+        /* Hands the snapshot returned by beginSnapshot() to the render thread */
+        void submitSnapshot();
+
+        /* Waits until all the submitted snapshots are rendered */
+        void waitIdle();
+
+        /**
+         * @brief Runs the task with the GL context current - on the render thread before its next
+         *        snapshot, or right away when the pipeline isn't running. Called from the main thread.
+         */
+        void runOnRenderThread(Task task);
+
+        /* Keeps a removed component's model until its snapshots are rendered, so the render thread releases its GL buffers */
+        void receive(const entityx::ComponentRemovedEvent<ModelRendererComponent> & event);
+
+    private:
+        struct RetiredModel
+        {
+            Model              m_model;
+            unsigned long long m_submitted_count; /* Released once this many snapshots are rendered */
+        };
+
+        void renderLoop();
+
+        std::vector<std::unique_ptr<RenderSnapshot>> m_snapshots;
+        RenderFunction                               m_render_function;
+        std::vector<Task>                            m_tasks; /* Guarded by m_mutex */
+
+        /* Copies of the models, they share the meshes with the removed components */
+        std::vector<RetiredModel> m_retired_models;  /* Guarded by m_mutex, in the order of removal */
+        std::vector<RetiredModel> m_released_models; /* Destroyed on the render thread, which owns the GL buffers */
+
+        std::thread             m_render_thread;
+        std::mutex              m_mutex;
+        std::condition_variable m_snapshot_submitted;
+        std::condition_variable m_snapshot_rendered;
+
+        /* Counters of all the snapshots, the slot of a snapshot is counter % snapshots count */
+        unsigned long long m_submitted_count;
+        unsigned long long m_rendered_count;
+
+        bool m_is_running;
+        bool m_stop_requested;
+    };
+}
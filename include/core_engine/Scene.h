@@ -1,6 +1,9 @@
 #pragma once
 #include <map>
+#include <vector>
+#include "GameObject.h"
 #include "Prefab.h"
+#include "World.h"
 
 namespace Vertex
 {
@@ -10,23 +13,19 @@ namespace Vertex
         Scene() {}
         ~Scene() {}
 
-        template <typename P, typename ... Args>
-        static void registerPrefab(const std::string & object, Args && ... args)
+        static void registerPrefab(const std::string & object, const Prefab & prefab)
         {
-            m_prefabs[object] = std::make_shared<P>(std::forward<Args>(args) ...);
+            m_prefabs[object] = prefab;
         }
 
-        static std::shared_ptr<GameObject> createPrefab(const std::string & object)
-        {
-            std::shared_ptr<GameObject> game_object;
+        /* Returns the GameObject of the instance's root, an invalid one if there's no such prefab */
+        static GameObject createPrefab(const std::string & object, const PrefabPlacement & placement = PrefabPlacement());
 
-            if (m_prefabs.count(object))
-            {
-                game_object = m_prefabs[object]->create();
-            }
+        /* Instantiates the prefab once per placement, the GameObjects of the instances' roots are appended */
+        static void instantiate(const std::string & object, const std::vector<PrefabPlacement> & placements, std::vector<GameObject> & game_objects);
 
-            return game_object;
-        }
+        /* Same in the world instead of the engine's scene, the entities of all the nodes are appended */
+        static void instantiate(World & world, const std::string & object, const std::vector<PrefabPlacement> & placements, std::vector<entityx::Entity> & entities);
 
         static std::shared_ptr<GameObject> createEmpty()
         {
@@ -34,7 +33,8 @@ namespace Vertex
         }
 
     private:
-        static std::map<std::string, std::shared_ptr<Prefab>> m_prefabs;
+        /* Registered before the worlds are stepped, read only afterwards */
+        static std::map<std::string, Prefab> m_prefabs;
     };
 }
 
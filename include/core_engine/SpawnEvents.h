@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+#include <entityx/entityx.h>
+
+namespace Vertex
+{
+    /* Emitted before a batch is spawned, so caches of entities can make room for it up front */
+    struct SpawnBatchEvent
+    {
+        explicit SpawnBatchEvent(std::size_t count)
+            : m_count(count)
+        {}
+
+        std::size_t m_count;
+    };
+
+    /* Emitted once for the whole batch, after all its entities got their components */
+    struct EntitiesSpawnedEvent
+    {
+        EntitiesSpawnedEvent(const entityx::Entity * entities, std::size_t count)
+            : m_entities(entities),
+              m_count   (count)
+        {}
+
+        const entityx::Entity * m_entities;
+        std::size_t             m_count;
+    };
+}
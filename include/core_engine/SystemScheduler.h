@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <bitset>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <entityx/entityx.h>
+
+namespace Vertex
+{
+    /**
+     * Declares which components a system reads and writes. Two systems may run
+     * at the same time only if neither of them writes what the other one touches.
+     * A system that declares nothing is exclusive - it never runs concurrently
+     * with any other system.
+     */
+    class SystemAccess final
+    {
+    public:
+        typedef std::bitset<entityx::MAX_COMPONENTS> ComponentMask;
+
+        SystemAccess()
+            : m_is_exclusive(true),
+              m_is_main_thread(false)
+        {}
+
+        template <typename ... Components>
+        SystemAccess & reads()
+        {
+            m_is_exclusive = false;
+            int expand[] = { 0, (m_reads.set(entityx::Component<Components>::family()), 0) ... };
+            (void)expand;
+
+            return *this;
+        }
+
+        template <typename ... Components>
+        SystemAccess & writes()
+        {
+            m_is_exclusive = false;
+            int expand[] = { 0, (m_writes.set(entityx::Component<Components>::family()), 0) ... };
+            (void)expand;
+
+            return *this;
+        }
+
+        /* The system doesn't touch any components */
+        SystemAccess & none()
+        {
+            m_is_exclusive = false;
+            return *this;
+        }
+
+        SystemAccess & exclusive()
+        {
+            m_is_exclusive = true;
+            return *this;
+        }
+
+        /* The system has to be updated on the main thread, e.g. because it polls the input */
+        SystemAccess & mainThread()
+        {
+            m_is_main_thread = true;
+            return *this;
+        }
+
+        bool conflictsWith(const SystemAccess & other) const;
+
+        bool isMainThread() const { return m_is_main_thread; }
+        bool isExclusive()  const { return m_is_exclusive; }
+
+    private:
+        ComponentMask m_reads;
+        ComponentMask m_writes;
+        bool          m_is_exclusive;
+        bool          m_is_main_thread;
+    };
+
+    /**
+     * Runs systems on the JobSystem. Systems are ordered by stage and then by
+     * registration order; a system waits only for the earlier systems it conflicts
+     * with, the rest of them run in parallel.
+     *
+     * Only exclusive systems may create or destroy entities, assign or remove components,
+     * or emit events - nothing else runs while they're updated, so the receivers, e.g.
+     * EntityQuery, don't need any locks. Systems that declared their access may overlap
+     * others, even the main thread ones.
+     */
+    class SystemScheduler final
+    {
+    public:
+        typedef std::function<void(entityx::TimeDelta)> UpdateFunction;
+
+        enum Stage { CORE_STAGE = 0, USER_STAGE = 1 };
+
+        SystemScheduler();
+        ~SystemScheduler();
+
+        SystemScheduler(const SystemScheduler &) = delete;
+        SystemScheduler & operator=(const SystemScheduler &) = delete;
+
+        /* The name must have a static storage, e.g. a literal or typeid(S).name() - the Profiler keeps it */
+        SystemAccess & add(const char * name, const UpdateFunction & update, Stage stage = USER_STAGE);
+
+        /**
+         * @brief Builds the dependency graph. Has to be called after all the systems are added.
+         */
+        void build();
+
+        /**
+         * @brief Updates all the systems and returns when all of them are done.
+         *        Must be called from the main thread.
+         */
+        void update(entityx::TimeDelta dt);
+
+        /* False while the calling thread updates a system that isn't exclusive */
+        static bool allowsStructuralChanges();
+
+    private:
+        struct Node
+        {
+            const char            * m_name;
+            UpdateFunction          m_update;
+            SystemAccess            m_access;
+            Stage                   m_stage;
+            std::vector<size_t>     m_successors;
+            unsigned                m_predecessors_count;
+            std::atomic<unsigned>   m_remaining_predecessors;
+        };
+
+        static void runJob(void * data, size_t index, size_t);
+
+        void dispatch(size_t index);
+        void run(size_t index);
+        bool popMainThreadNode(size_t & index);
+
+        std::vector<std::unique_ptr<Node>> m_nodes;
+
+        std::vector<size_t> m_main_thread_queue;
+        std::mutex          m_main_thread_mutex;
+
+        std::atomic<size_t> m_pending_nodes;
+        entityx::TimeDelta  m_dt;
+        bool                m_is_built;
+    };
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Vertex
+{
+    /**
+     * Local poses and world matrices of all the transforms, stored as arrays (structure of arrays)
+     * sorted so that every node comes after its parent and every subtree is one contiguous range.
+     * World matrices are updated in a single linear pass, without following any pointers.
+     *
+     * Nodes are referenced by ids, which stay valid until the node is destroyed - the position of
+     * a node in the arrays (its slot) changes when the hierarchy is reordered.
+     *
+     * Destroyed nodes leave removed slots behind, skipped by update() and dropped once they're
+     * a large part of the arrays. Reparenting only relinks the node - the arrays are sorted again
+     * once, on the next update(), however many nodes were reparented since the last one.
+     *
+     * Setters push the node onto a dirty list of the calling thread, so they can be called from
+     * many threads at once as long as every node is changed by one thread only. update() visits
+     * the subtrees of the dirty nodes only - when nothing moves, it visits nothing. Large updates
+     * are split into independent subtrees and run on the JobSystem, with the same results as
+     * a serial update.
+     * Creating, destroying and reparenting nodes and update() are not thread safe.
+     *
+     * There is one process-wide hierarchy, and one more per World - see current().
+     */
+    class TransformHierarchy final
+    {
+    public:
+        typedef uint32_t NodeId;
+
+        static const uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+        TransformHierarchy();
+
+        TransformHierarchy(const TransformHierarchy &) = delete;
+        TransformHierarchy & operator=(const TransformHierarchy &) = delete;
+
+        /* New root node */
+        NodeId create(const glm::vec3 & position, const glm::quat & orientation, const glm::vec3 & scale);
+
+        /* Children of the node are attached to its parent */
+        void destroy(NodeId node);
+
+        /**
+         * @brief Moves the node with its subtree under the parent, INVALID_INDEX makes it a root.
+         *        O(depth of the parent), the world matrices follow on the next update() - see the class comment.
+         * @return false if the parent is in the node's subtree.
+         */
+        bool   setParent(NodeId node, NodeId parent);
+        NodeId getParent(NodeId node) const { return m_links[node].m_parent; }
+
+        /* Node of the scene's root transform - the engine's or a World's one, INVALID_INDEX until it's set */
+        void   setSceneRoot(NodeId node) { m_scene_root = node; }
+        NodeId getSceneRoot() const      { return m_scene_root; }
+
+        void setPosition   (NodeId node, const glm::vec3 & position);
+        void setOrientation(NodeId node, const glm::quat & orientation);
+        void setScale      (NodeId node, const glm::vec3 & scale);
+
+        const glm::vec3 & getPosition    (NodeId node) const { return m_positions[m_slots[node]];       }
+        const glm::quat & getOrientation (NodeId node) const { return m_orientations[m_slots[node]];    }
+        const glm::vec3 & getScale       (NodeId node) const { return m_scales[m_slots[node]];          }
+        const glm::mat4 & getWorldMatrix (NodeId node) const { return m_world_matrices[m_slots[node]];  }
+        const glm::mat3 & getNormalMatrix(NodeId node) const { return m_normal_matrices[m_slots[node]]; }
+
+        /* ChangeVersion of the last change of the local pose or the world matrix */
+        uint32_t getVersion(NodeId node) const { return m_versions[m_slots[node]]; }
+
+        /* Pose at the beginning of the current step, see storePreviousStates() */
+        const glm::mat4 & getPreviousWorldMatrix(NodeId node) const { return m_previous_world_matrices[m_slots[node]]; }
+        const glm::vec3 & getPreviousPosition   (NodeId node) const { return m_previous_positions[m_slots[node]];      }
+        const glm::quat & getPreviousOrientation(NodeId node) const { return m_previous_orientations[m_slots[node]];   }
+
+        /**
+         * @brief A static node has its world and normal matrices baked on the next update() and is skipped
+         *        afterwards, even when its parent moves. Changes of its local pose are applied once
+         *        it is made movable again.
+         */
+        void setStatic(NodeId node, bool is_static);
+        bool isStatic (NodeId node) const { return (m_flags[m_slots[node]] & STATIC) != 0; }
+
+        /* The previous pose of the node becomes its current one after the next update() */
+        void resetInterpolation(NodeId node);
+
+        /* Recomputes the world and normal matrices of the dirty nodes and their subtrees */
+        void update();
+
+        /* Keeps the current poses as the previous ones, for the interpolated rendering - copies only the nodes updated since the last call */
+        void storePreviousStates();
+
+        /* Number of slots, destroyed nodes included until the next compaction */
+        size_t size() const { return m_nodes.size(); }
+
+        /* Room for count more nodes, so creating them doesn't reallocate the arrays */
+        void reserve(size_t count);
+
+        /* Hierarchy the new transforms of the calling thread go to - the process-wide one unless a World made its own current */
+        static TransformHierarchy & current();
+
+        /* nullptr restores the process-wide one. Returns the previous current one of the thread, nullptr if it was the process-wide one */
+        static TransformHierarchy * makeCurrent(TransformHierarchy * hierarchy);
+
+    private:
+        enum Flags : uint8_t
+        {
+            DIRTY            = 1 << 0, /* Local pose or parent changed, the node is on a dirty list */
+            HAS_WORLD_MATRIX = 1 << 1, /* Previous world matrix is valid */
+            UNIFORM_SCALE    = 1 << 2, /* World matrix is a rotation, a uniform scale and a translation */
+            REMOVED          = 1 << 3,
+            STATIC           = 1 << 4,
+            BAKED            = 1 << 5  /* Static and its world matrix is computed */
+        };
+
+        /* Parent and siblings of a node - doubly linked lists of children, by node id */
+        struct Links
+        {
+            Links()
+                : m_parent          (INVALID_INDEX),
+                  m_first_child     (INVALID_INDEX),
+                  m_last_child      (INVALID_INDEX),
+                  m_previous_sibling(INVALID_INDEX),
+                  m_next_sibling    (INVALID_INDEX)
+            {}
+
+            NodeId m_parent;
+            NodeId m_first_child;
+            NodeId m_last_child;
+            NodeId m_previous_sibling;
+            NodeId m_next_sibling;
+        };
+
+        void link(NodeId node, NodeId parent);
+        void unlink(NodeId node);
+
+        struct DirtyList
+        {
+            std::thread::id     m_thread_id;
+            std::vector<NodeId> m_nodes;
+        };
+
+        void markDirty(uint32_t slot);
+
+        /* Dirty list of the calling thread */
+        DirtyList & getDirtyList();
+
+        /* Slots [m_begin, m_end) whose parent is already up to date */
+        struct Range
+        {
+            uint32_t m_begin;
+            uint32_t m_end;
+        };
+
+        /* Below this number of nodes to update the jobs cost more than they save */
+        static const uint32_t PARALLEL_MIN_NODES = 4096;
+
+        /* Below this number of removed slots they're not worth a reorder */
+        static const uint32_t COMPACTION_MIN_REMOVED = 1024;
+
+        void removeSlot(uint32_t slot);
+
+        /* World and normal matrices of the slots in [begin, end), parents first */
+        void updateRange(uint32_t begin, uint32_t end);
+
+        /* Splits the dirty ranges into subtrees of at most target_size nodes and updates them in parallel */
+        void updateParallel(uint32_t target_size);
+
+        /* Pre-order of the live nodes from the links, drops the removed ones */
+        void reorder();
+
+        template <typename T>
+        static void permute(std::vector<T> & values, const std::vector<uint32_t> & order)
+        {
+            std::vector<T> permuted;
+            permuted.reserve(order.size());
+
+            for (uint32_t old_slot : order)
+            {
+                permuted.push_back(values[old_slot]);
+            }
+
+            values.swap(permuted);
+        }
+
+        /* By node id */
+        std::vector<uint32_t> m_slots;
+        std::vector<Links>    m_links;
+        std::vector<NodeId>   m_free_nodes;
+
+        /* By slot */
+        std::vector<NodeId>    m_nodes;
+        std::vector<uint32_t>  m_parents;
+        std::vector<uint32_t>  m_subtree_ends;
+        std::vector<uint8_t>   m_flags;
+        std::vector<uint32_t>  m_versions;
+        std::vector<glm::vec3> m_positions;
+        std::vector<glm::quat> m_orientations;
+        std::vector<glm::vec3> m_scales;
+        std::vector<glm::mat4> m_world_matrices;
+        std::vector<glm::mat3> m_normal_matrices;
+        std::vector<glm::mat4> m_previous_world_matrices;
+        std::vector<glm::vec3> m_previous_positions;
+        std::vector<glm::quat> m_previous_orientations;
+
+        std::vector<std::unique_ptr<DirtyList>> m_dirty_lists;
+        std::mutex                              m_dirty_lists_mutex;
+        std::vector<uint32_t>                   m_dirty_slots;
+        std::vector<Range>                      m_dirty_ranges;
+        std::vector<Range>                      m_job_ranges;
+        std::vector<Range>                      m_jobs; /* Indices into m_job_ranges */
+        std::vector<Range>                      m_moved_ranges; /* Updated since the last storePreviousStates() */
+        std::vector<uint32_t>                   m_order;
+        std::vector<NodeId>                     m_stack;
+
+        /* Tells the hierarchies apart in the per-thread cache of dirty lists */
+        uint64_t m_id;
+        NodeId   m_scene_root;
+        uint32_t m_removed_count;
+        bool     m_is_layout_stale; /* Nodes were reparented, the slots don't follow the links */
+        bool     m_are_previous_states_stale;
+
+        static std::atomic<uint64_t> m_hierarchies_count;
+    };
+}
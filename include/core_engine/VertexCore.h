@@ -1,7 +1,16 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <typeinfo>
+
 #include <entityx/entityx.h>
 
+#include "core_engine/EventChannels.h"
+#include "core_engine/FramePacer.h"
+#include "core_engine/RenderPipeline.h"
+#include "core_engine/SystemScheduler.h"
+#include "framework/utilities/FrameTelemetry.h"
 #include "game_logic/BaseGame.h"
 
 #define MIN_GL_VERSION_MAJOR 4
@@ -20,31 +29,148 @@ namespace Vertex
 
         /**
          * All systems must be added before calling init().
+         * Declare the components the system uses to let it run in parallel with other systems:
+         *     core.addSystem<MoveSystem>().reads<VelocityComponent>().writes<TransformComponent>();
+         * A system without any declarations is exclusive and runs alone - only such a system
+         * may create or destroy entities and assign or remove components.
          */
         template <typename S, typename ... Args>
-        void addSystem(Args && ... args)
+        SystemAccess & addSystem(Args && ... args)
         {
             m_users_systems.add<S>(std::forward<Args>(args) ...);
+
+            return m_scheduler.add(typeid(S).name(), [this](entityx::TimeDelta dt)
+            {
+                m_users_systems.update<S>(dt);
+            });
         }
 
+        /**
+         * Number of worker threads used to update the systems. Defaults to the number
+         * of hardware threads minus one (the main thread). Must be set before calling init().
+         */
+        void         setWorkerThreadsCount(unsigned int count);
+
+        /**
+         * Renders frames on a separate thread, while the main thread simulates the next one.
+         * snapshots_count = 2 is double buffering (the simulation is at most one frame ahead),
+         * 3 is triple buffering. Must be set before calling start().
+         * When it's enabled, the main thread doesn't own the GL context during the game loop:
+         * GL resources (models, textures, shaders) have to be created in BaseGame::init() or through
+         * runOnRenderThread(), e.g. CoreAssetManager::createModelAsync(), and must not be released
+         * before the loop ends, e.g. keep the models in CoreAssetManager. The models of the removed
+         * ModelRendererComponents are the exception, the render thread releases them.
+         * Snapshots share the meshes of the rendered models, which copy them before any change, so
+         * materials may be edited and ModelRendererComponent::m_model replaced during the loop as long
+         * as the replaced model was rendered - the render thread releases it with its last snapshot.
+         */
+        void         setPipelinedRendering(bool enabled, unsigned int snapshots_count = 2);
+
+        /**
+         * Runs the task where the GL context is current - on the render thread before its next frame
+         * during the pipelined game loop, right away otherwise. Must be called from the main thread,
+         * AsyncTasks::post() brings the results back to it.
+         */
+        void         runOnRenderThread(const std::function<void()> & task);
+
+        /**
+         * Runs the engine without a window and GL context, e.g. on simulation servers or CI.
+         * Rendering and GUI systems are replaced by null ones, models, textures and shaders
+         * only keep their CPU side data. Must be set before calling init().
+         */
+        void         setHeadless(bool enabled);
+
+        /**
+         * Ticks the fixed step simulation as fast as possible instead of in real time.
+         * Every tick still advances the simulation by 1 / framerate seconds.
+         */
+        void         setUncapped(bool enabled);
+
+        /**
+         * Renders as often as the display allows instead of once per batch of steps, with the
+         * transforms interpolated between the previous and the current step. Motion stays smooth
+         * with a simulation rate lower than the display's. Without v-sync limit the frame rate
+         * with getFramePacer().setMaxFrameRate(). Has no effect when uncapped.
+         */
+        void         setInterpolation(bool enabled);
+
+        /**
+         * Posts an event from any thread. It's emitted through the EventManager on the main thread
+         * at the next sync point - the start of a step or right before the frame is rendered.
+         */
+        template <typename E, typename ... Args>
+        void postEvent(Args && ... args)
+        {
+            m_event_channels.post<E>(std::forward<Args>(args) ...);
+        }
+
+        /* Runs ticks_count fixed steps right away, without rendering - for tests and benchmarks */
+        void         step(unsigned int ticks_count = 1);
+
+        /**
+         * Writes the keys and mouse state of every step to a file, see Input::startRecording().
+         * Must be called after init().
+         */
+        bool         recordInput(const std::string & filename);
+
+        /**
+         * Replays input recorded by recordInput() and stops the engine after the last step.
+         * With the same framerate every run simulates the same workload, e.g. to compare
+         * frame times of two builds. Must be called after init().
+         */
+        bool         replayInput(const std::string & filename);
+
+        /* True once the replay reached the end of the recording and stopped the engine */
+        bool         isInputReplayFinished() const { return m_is_input_replay_finished; }
+
+        /* Waiting mode, catch-up limit and frame time statistics of the game loop */
+        FramePacer & getFramePacer() { return m_frame_pacer; }
+
         void         init(unsigned int width, unsigned int height, const std::string & title);
         unsigned int getFPS() const;
 
+        /* Timings of the last frames, see FrameSample */
+        const FrameTelemetry & getTelemetry() const { return m_telemetry; }
+
+        /* Overlay with the frame time percentiles and histogram, drawn after BaseGame::onGUI() */
+        void setPerformanceHUDVisible(bool visible);
+        bool isPerformanceHUDVisible();
+
         void start();
         void stop();
 
     private:
         entityx::SystemManager m_users_systems;
+        SystemScheduler        m_scheduler;
+        RenderPipeline         m_render_pipeline;
+        FramePacer             m_frame_pacer;
+        FrameTelemetry         m_telemetry;
+        EventChannels          m_event_channels;
 
         std::shared_ptr<BaseGame>         m_game;
 
         double       m_frame_time;
         unsigned int m_fps;
         unsigned int m_fpsToReturn;
+        unsigned int m_worker_threads_count;
+        unsigned int m_render_snapshots_count;
+        bool         m_is_pipelined_rendering;
+        bool         m_is_headless;
+        bool         m_is_uncapped;
+        bool         m_is_interpolated;
+        bool         m_is_replaying_input;
+        bool         m_is_input_replay_finished;
         bool         m_is_running;
 
+        /* Written by the thread that renders, in seconds */
+        std::atomic<double> m_last_render_time;
+        std::atomic<double> m_last_swap_time;
+
+        void tick();
         void updateSystems(entityx::TimeDelta dt);
         void updateRenderingSystems(entityx::TimeDelta dt);
+        void renderSnapshot(RenderSnapshot & snapshot);
+        void recordFrame(unsigned int steps, double frame_time, double sim_time, double render_time, uint64_t heap_allocations);
         void run();
     };
 }
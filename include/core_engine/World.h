@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <entityx/entityx.h>
+
+#include "core_components/TransformComponent.h"
+#include "core_engine/TransformHierarchy.h"
+
+namespace Vertex
+{
+    /**
+     * A simulation independent of the engine's scene and of the other worlds - it owns its
+     * entities, systems, transform hierarchy and scene root. Assets, prefabs and the JobSystem
+     * are shared, so they have to be set up before the worlds are stepped.
+     *
+     * A world can be stepped on any thread, different worlds at the same time. Code that
+     * creates transforms or GameObjects of a world outside step() has to make it current first,
+     * with a World::Scope.
+     */
+    class World final
+    {
+    public:
+        World();
+        ~World();
+
+        World(const World &) = delete;
+        World & operator=(const World &) = delete;
+
+        entityx::EventManager  & events()   { return m_ecs.events;   }
+        entityx::EntityManager & entities() { return m_ecs.entities; }
+        entityx::SystemManager & systems()  { return m_ecs.systems;  }
+
+        TransformHierarchy & hierarchy() { return m_hierarchy; }
+        TransformComponent & root()      { return *m_root;     }
+
+        /* Configures the systems added so far, with the world current */
+        void configure();
+
+        /* Updates all the systems in the order they were added, then the transforms - on the calling thread */
+        void step(entityx::TimeDelta dt);
+
+        /* One job per world, returns when all of them are stepped */
+        static void stepAll(const std::vector<World *> & worlds, entityx::TimeDelta dt);
+
+        /* World current on the calling thread, nullptr when it's the engine's scene */
+        static World * current();
+
+        /* Makes the world current on the calling thread until the scope ends */
+        class Scope final
+        {
+        public:
+            explicit Scope(World & world);
+            ~Scope();
+
+            Scope(const Scope &) = delete;
+            Scope & operator=(const Scope &) = delete;
+
+        private:
+            World              * m_previous_world;
+            TransformHierarchy * m_previous_hierarchy;
+        };
+
+        /**
+         * Makes the engine's scene current on the calling thread until the scope ends, whatever world
+         * was current - the engine's entry points (GameObject(), CoreAssetManager, Scene) open one, so
+         * their transforms never go to a world's hierarchy. The engine's scene is still main thread only.
+         */
+        class EngineScope final
+        {
+        public:
+            EngineScope();
+            ~EngineScope();
+
+            EngineScope(const EngineScope &) = delete;
+            EngineScope & operator=(const EngineScope &) = delete;
+
+        private:
+            World              * m_previous_world;
+            TransformHierarchy * m_previous_hierarchy;
+        };
+
+    private:
+        /* Destroyed in reverse - the entities first, as their transforms refer to the hierarchy */
+        TransformHierarchy                  m_hierarchy;
+        std::unique_ptr<TransformComponent> m_root;
+        entityx::EntityX                    m_ecs;
+    };
+}
@@ -1,12 +1,27 @@
 ﻿#pragma once
 #include <entityx/System.h>
+#include <glm/gtc/quaternion.hpp>
+
+#include "core_components/CameraComponent.h"
+#include "core_components/TransformComponent.h"
+#include "core_engine/EntityQuery.h"
 
 namespace Vertex
 {
     class CameraSystem : public entityx::System<CameraSystem>
     {
     public:
+        CameraSystem()
+            : m_transforms_version(0)
+        {}
+
         void configure(entityx::EntityManager& entities, entityx::EventManager& events) override;
         void update(entityx::EntityManager& entities, entityx::EventManager& events, entityx::TimeDelta dt) override;
+
+        static glm::mat4 viewMatrix(const glm::quat & orientation, const glm::vec3 & position);
+
+    private:
+        EntityQuery<CameraComponent, TransformComponent> m_cameras;
+        uint32_t m_transforms_version;
     };
 }
@@ -2,20 +2,41 @@
 #include <entityx/System.h>
 
 #include "game_logic/BaseGame.h"
+#include "framework/gui/GUI.h"
 
 namespace Vertex
 {
     class GUISystem : public entityx::System<GUISystem>
     {
     public:
-        GUISystem() {}
+        GUISystem()
+            : m_telemetry(nullptr),
+              m_fps(nullptr),
+              m_is_performance_hud_visible(false)
+        {}
 
         void configure(entityx::EventManager & events) override;
         void update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt) override;
 
         void registerGame(const std::shared_ptr<BaseGame> & game);
 
+        /* Builds the GUI like update() does, but copies the draw data instead of rendering it */
+        void record(entityx::TimeDelta dt, GUIDrawData & draw_data);
+
+        /* Source of the performance HUD's data, it has to outlive the system */
+        void registerTelemetry(const FrameTelemetry * telemetry, const unsigned int * fps);
+
+        /* The hidden HUD doesn't compute anything */
+        void setPerformanceHUDVisible(bool visible) { m_is_performance_hud_visible = visible; }
+        bool isPerformanceHUDVisible() const        { return m_is_performance_hud_visible; }
+
     private:
+        void drawPerformanceHUD();
+
         std::shared_ptr<BaseGame> m_game;
+
+        const FrameTelemetry * m_telemetry;
+        const unsigned int   * m_fps;
+        bool                   m_is_performance_hud_visible;
     };
 }
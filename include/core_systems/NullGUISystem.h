@@ -0,0 +1,14 @@
+﻿#pragma once
+#include "core_systems/GUISystem.h"
+
+namespace Vertex
+{
+    /**
+     * Stands in for the GUISystem in the headless mode - BaseGame::onGUI() is not called.
+     */
+    class NullGUISystem : public GUISystem
+    {
+    public:
+        void update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt) override;
+    };
+}
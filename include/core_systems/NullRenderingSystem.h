@@ -0,0 +1,17 @@
+﻿#pragma once
+#include "core_systems/RenderingSystem.h"
+
+namespace Vertex
+{
+    /**
+     * Stands in for the RenderingSystem in the headless mode. It still tracks the render
+     * queues and the main camera, so the game can query them, but never touches GL.
+     * It's registered under the RenderingSystem's family, so CoreServices::getRenderer() works.
+     */
+    class NullRenderingSystem : public RenderingSystem
+    {
+    public:
+        void configure(entityx::EntityManager& entities, entityx::EventManager& events) override;
+        void update(entityx::EntityManager& entities, entityx::EventManager& events, entityx::TimeDelta dt) override;
+    };
+}
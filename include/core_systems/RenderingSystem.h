@@ -4,6 +4,10 @@
 #include "core_components/CameraComponent.h"
 #include "core_components/TransformComponent.h"
 #include "core_components/ModelRendererComponent.h"
+#include "core_components/DirectionalLightComponent.h"
+#include "core_components/PointLightComponent.h"
+#include "core_components/SpotLightComponent.h"
+#include "core_engine/EntityQuery.h"
 #include "framework/rendering/Shader.h"
 #include "framework/rendering/PostprocessEffect.h"
 #include "framework/rendering/RenderTarget.h"
@@ -11,6 +15,8 @@
 #include "framework/rendering/DeferredRendering.h"
 #include "framework/rendering/BloomPS.h"
 #include "framework/rendering/SSAO.h"
+#include "framework/rendering/RenderProxies.h"
+#include "framework/rendering/RenderSnapshot.h"
 
 namespace Vertex
 {
@@ -23,11 +29,38 @@ namespace Vertex
         void configure(entityx::EntityManager& entities, entityx::EventManager& events) override;
         void update(entityx::EntityManager& entities, entityx::EventManager& events, entityx::TimeDelta dt) override;
 
+        /**
+         * @brief Copies everything needed to render the frame from the entities.
+         *        Has to be called from the simulation thread.
+         */
+        void extract(entityx::EntityManager& entities, RenderSnapshot & snapshot);
+
+        /**
+         * @brief Renders the snapshot. Has to be called from the thread that owns the GL context.
+         */
+        void render(RenderSnapshot & snapshot);
+
+        /* Transparent items back to front, from the snapshot's camera */
+        static void sortAlpha(RenderSnapshot & snapshot);
+
+        /* View-projection matrices of the six faces of a point light's shadow cube map */
+        static void pointLightMatrices(const glm::mat4 & projection, const glm::vec3 & position, glm::mat4 * light_matrices);
+
         void receive(const entityx::ComponentAddedEvent<CameraComponent> & event);
-        void receive(const entityx::ComponentAddedEvent<ModelRendererComponent>& event);
-        void receive(const entityx::ComponentRemovedEvent<ModelRendererComponent>& event);
+
+        /* The proxies are removed in one batch by the next extract() */
+        void receive(const entityx::ComponentRemovedEvent<ModelRendererComponent> & event);
+        void receive(const entityx::ComponentRemovedEvent<TransformComponent> & event);
 
         void setSkybox(const std::shared_ptr<Skybox> & skybox);
+
+        /**
+         * @brief Where between the previous and the current simulation step the extracted
+         *        frame shows the transforms, 1 - the current step. See VertexCore::setInterpolation().
+         */
+        void setInterpolationAlpha(float alpha) { m_interpolation_alpha = alpha; }
+
+        /* Render targets are recreated when the next frame is rendered */
         void resize(unsigned width, unsigned height);
 
         entityx::ComponentHandle<TransformComponent> getCameraTransform();
@@ -38,13 +71,30 @@ namespace Vertex
         static bool M_DEBUG_RENDERING;
         static unsigned int M_DEBUG_WINDOW_WIDTH;
 
+    protected:
+        /* Queries of the renderables and the lights, and the events keeping the proxies up to date */
+        void configureQueries(entityx::EntityManager & entities, entityx::EventManager & events);
+
+        /* Spawns and despawns queued since the last frame, extract() applies them */
+        void flushQueries();
+
+        /**
+         * Applies the queued changes of a frame that's never extracted, e.g. in the headless mode.
+         * The proxies are not built then, so their queued removals are dropped.
+         */
+        void skipFrame();
+
     private:
         enum TextureMaps { SHADOW_MAP = 5 }; //TODO: move to Material class
 
-        std::vector<entityx::Entity> m_opaque_queue;
-        std::vector<entityx::Entity> m_alpha_queue;
-        std::vector<entityx::Entity> m_enviro_static_queue;
-        std::vector<entityx::Entity> m_enviro_dynamic_queue;
+        EntityQuery<ModelRendererComponent,    TransformComponent> m_renderables;
+        EntityQuery<DirectionalLightComponent, TransformComponent> m_directional_lights;
+        EntityQuery<PointLightComponent,       TransformComponent> m_point_lights;
+        EntityQuery<SpotLightComponent,        TransformComponent> m_spot_lights;
+
+        RenderProxies                m_proxies;
+        uint32_t                     m_proxies_version; /* ChangeVersion the proxies are refreshed to */
+        std::vector<entityx::Entity> m_removed_renderables;
 
         std::shared_ptr<Shader> m_forward_ambient;
         std::shared_ptr<Shader> m_forward_directional;
@@ -82,6 +132,15 @@ namespace Vertex
 
         entityx::Entity m_main_camera;
 
+        RenderSnapshot m_snapshot;
+
+        unsigned m_requested_width;
+        unsigned m_requested_height;
+        unsigned m_viewport_width;
+        unsigned m_viewport_height;
+
+        float m_interpolation_alpha;
+
         static void initRenderingStates();
 
         static void beginForwardRendering();
@@ -90,19 +149,25 @@ namespace Vertex
         void bindMainRenderTarget();
 
         void applyPostprocess(std::shared_ptr<PostprocessEffect> & effect, std::shared_ptr<RenderTarget> * src, std::shared_ptr<RenderTarget> * dst);
+        void applyResize(unsigned width, unsigned height);
+
+        static RenderProxy makeProxy(entityx::Entity entity, ModelRendererComponent & renderer, const TransformComponent & transform);
+
+        /* Removes the proxies of the removed renderables and refreshes the ones whose transforms changed */
+        void updateProxies();
 
-        void renderForward(entityx::EntityManager& entities);
-        void renderDeferred(entityx::EntityManager& entities);
+        void renderForward(RenderSnapshot & snapshot);
+        void renderDeferred(RenderSnapshot & snapshot);
         void renderDebug();
-        void renderDebugLightsBoundingBoxes(entityx::EntityManager& entities);
+        void renderDebugLightsBoundingBoxes(const RenderSnapshot & snapshot);
 
-        void renderOpaque(const std::shared_ptr<Shader> & shader);
-        void renderAlpha(const std::shared_ptr<Shader>& shader);
-        void renderEnviroMappingStatic(const std::shared_ptr<Shader>& shader);
-        void renderEnviroMappingDynamic(const std::shared_ptr<Shader>& shader);
-        void renderLightsForward(entityx::EntityManager& entities);
-        void renderLightsDeferred(entityx::EntityManager& entities);
+        static void renderItems(const std::vector<RenderItem> & items, const CameraData & camera, const std::shared_ptr<Shader> & shader);
 
-        void sortAlpha();
+        void renderOpaque(const RenderSnapshot & snapshot, const std::shared_ptr<Shader> & shader);
+        void renderAlpha(const RenderSnapshot & snapshot, const std::shared_ptr<Shader>& shader);
+        void renderEnviroMappingStatic(const RenderSnapshot & snapshot, const std::shared_ptr<Shader>& shader);
+        void renderEnviroMappingDynamic(const RenderSnapshot & snapshot, const std::shared_ptr<Shader>& shader);
+        void renderLightsForward(const RenderSnapshot & snapshot);
+        void renderLightsDeferred(const RenderSnapshot & snapshot);
     };
 }
@@ -11,6 +11,12 @@ namespace Vertex
         void configure(entityx::EntityManager& entities, entityx::EventManager& events) override;
         void update(entityx::EntityManager& entities, entityx::EventManager& events, entityx::TimeDelta dt) override;
 
+        /* Keeps the pose of every transform from before the step, for the interpolated rendering */
+        static void storePreviousStates();
+
+        /* Root of the World current on the calling thread, M_ROOT_NODE for the engine's own scene */
+        static TransformComponent & root();
+
         static TransformComponent M_ROOT_NODE;
     };
 }
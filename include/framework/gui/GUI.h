@@ -6,14 +6,38 @@
 #include "framework/window/Window.h"
 #include "framework/rendering/Texture.h"
 #include "framework/gui/Font.h"
+#include "framework/utilities/FrameTelemetry.h"
 
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 
 #include <memory>
+#include <vector>
 
 namespace Vertex
 {
+    /**
+     * Copy of the ImGui's draw data. It can be rendered while ImGui is already
+     * building the next frame, e.g. on the render thread.
+     */
+    class GUIDrawData final
+    {
+    public:
+        GUIDrawData();
+        ~GUIDrawData();
+
+        GUIDrawData(const GUIDrawData &) = delete;
+        GUIDrawData & operator=(const GUIDrawData &) = delete;
+
+        void copyFrom(const ImDrawData & draw_data);
+
+        ImDrawData * get() { return &m_draw_data; }
+
+    private:
+        ImDrawData                m_draw_data;
+        std::vector<ImDrawList *> m_draw_lists;
+    };
+
     class GUI
     {
     public:
@@ -21,14 +45,25 @@ namespace Vertex
 
         ~GUI();
         static void init(GLFWwindow * window);
+
+        /* Only the ImGui's context, without the platform and renderer bindings */
+        static void initHeadless();
         static void prepare();
         static void render();
+
+        /* Finishes the frame without rendering it, the draw data is copied instead */
+        static void endFrame(GUIDrawData & draw_data);
+        static void render(GUIDrawData & draw_data);
+
         static void updateWindowSize(float width, float height);
 
         /* HUD rendering */
         static void beginHUD();
         static void endHUD();
 
+        /* Frame time percentiles and histogram of the recorded frames */
+        static void performanceHUD(const FrameTelemetry & telemetry, unsigned int fps);
+
         static float text(const std::shared_ptr<Font> & font, const std::string& text, const glm::vec2 & position, float size, const glm::vec4 & color = glm::vec4(1.0f), bool center = false, bool text_shadow = false);
         static void line(const glm::vec2 & from, const glm::vec2 & to, const glm::vec4 & color = glm::vec4(1.0f), float thickness = 1.0f);
         static void circle(const glm::vec2 & position, float radius, const glm::vec4 & color = glm::vec4(1.0f), float thickness = 1.0f, uint32_t segments = 16);
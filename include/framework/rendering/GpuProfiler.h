@@ -0,0 +1,104 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+
+#include "framework/utilities/Profiler.h"
+
+namespace Vertex
+{
+    /**
+     * Measures render passes with GL timestamp queries and adds them to the
+     * Profiler's "GPU" lane. The queries of a frame are read two frames later,
+     * when they're done - a frame whose results aren't ready yet is skipped
+     * instead of stalling the pipeline.
+     *
+     * Has to be used only from the thread that owns the GL context.
+     */
+    class GpuProfiler final
+    {
+    public:
+        GpuProfiler() = delete;
+        ~GpuProfiler() = delete;
+        GpuProfiler(const GpuProfiler &) = delete;
+        GpuProfiler & operator=(const GpuProfiler &) = delete;
+
+        /* Collects the results of the oldest frame and starts recording a new one */
+        static void beginFrame();
+
+        static void beginPass(const char * name);
+        static void endPass();
+
+    private:
+        static const unsigned FRAMES_COUNT = 2;
+
+        struct Pass
+        {
+            const char * m_name;
+            GLuint       m_begin_query;
+            GLuint       m_end_query;
+            uint32_t     m_depth;
+        };
+
+        struct Frame
+        {
+            std::vector<Pass>   m_passes;
+            std::vector<GLuint> m_queries;
+
+            /* Both clocks read at the same moment, to put GPU times on the CPU's timeline */
+            int64_t  m_gpu_reference;
+            uint64_t m_cpu_reference;
+
+            /* End query issued last - with nested passes it's not the one of the last pass */
+            GLuint m_last_query;
+
+            /* Every pass got its end query */
+            bool m_is_complete;
+        };
+
+        static GLuint acquireQuery(Frame & frame, unsigned index);
+        static void   resolve(Frame & frame);
+
+        static Frame                 m_frames[FRAMES_COUNT];
+        static std::vector<unsigned> m_open_passes;
+        static unsigned              m_frame_index;
+        static unsigned              m_lane;
+        static bool                  m_is_lane_added;
+        static bool                  m_is_recording;
+    };
+
+    class GpuProfileScope final
+    {
+    public:
+        explicit GpuProfileScope(const char * name)
+            : m_is_active(Profiler::isEnabled())
+        {
+            if (m_is_active)
+            {
+                GpuProfiler::beginPass(name);
+            }
+        }
+
+        ~GpuProfileScope()
+        {
+            if (m_is_active)
+            {
+                GpuProfiler::endPass();
+            }
+        }
+
+        GpuProfileScope(const GpuProfileScope &) = delete;
+        GpuProfileScope & operator=(const GpuProfileScope &) = delete;
+
+    private:
+        bool m_is_active;
+    };
+}
+
+/* Times the scope both on the CPU and on the GPU */
+#ifndef VE_DISABLE_PROFILER
+    #define VE_PROFILE_GPU(name) VE_PROFILE_SCOPE(name); ::Vertex::GpuProfileScope VE_PROFILE_CONCAT(ve_gpu_profile_scope_, __LINE__)(name)
+#else
+    #define VE_PROFILE_GPU(name)
+#endif
@@ -20,9 +20,9 @@ namespace Vertex
         void addVector3(const std::string & uniform_name, const glm::vec3 & vector3);
         void addFloat  (const std::string & uniform_name, float value);
 
-        std::shared_ptr<Texture> getTexture(TextureType texture_type);
-        glm::vec3                getVector3(const std::string & uniform_name);
-        float                    getFloat  (const std::string & uniform_name);
+        std::shared_ptr<Texture> getTexture(TextureType texture_type) const;
+        glm::vec3                getVector3(const std::string & uniform_name) const;
+        float                    getFloat  (const std::string & uniform_name) const;
 
         void setBlendMode(BlendMode mode) { m_blend_mode = mode; }
 
@@ -31,6 +31,10 @@ namespace Vertex
         GLuint m_vbo_ids[2];
         GLuint m_indices_count;
         GLenum m_draw_mode;
+
+        /* Axis aligned bounding box of the vertices, in the model space */
+        glm::vec3 m_bounds_min;
+        glm::vec3 m_bounds_max;
     };
 
     class Mesh
@@ -44,6 +48,10 @@ namespace Vertex
 
         GLenum getDrawMode()     const { return m_mesh_data->m_draw_mode; }
         GLuint getIndicesCount() const { return m_mesh_data->m_indices_count; }
+        GLuint getVertexArray()  const { return m_mesh_data ? m_mesh_data->m_vao_id : 0; }
+
+        /* False when no buffers were set */
+        bool getBounds(glm::vec3 & min, glm::vec3 & max) const;
 
         void render() const;
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <map>
 #include <memory>
 
 #include <assimp/Importer.hpp>
@@ -12,12 +13,27 @@
 
 namespace Vertex
 {
+    /* CPU side of a model file - parsed and post-processed by Assimp, textures decoded, nothing is uploaded yet */
+    struct ModelImport
+    {
+        std::string      m_filename;
+        Assimp::Importer m_importer; /* Owns the scene */
+        const aiScene  * m_scene = nullptr;
+
+        /* By path, without the ones CoreAssetManager had loaded already */
+        std::map<std::string, std::shared_ptr<TextureImport>> m_textures;
+    };
+
     class Model
     {
     public:
         Model();
         virtual ~Model();
 
+        /* Copies share the meshes until one of them is modified. No moves - a moved from model would have no meshes */
+        Model(const Model &) = default;
+        Model & operator=(const Model &) = default;
+
         /* Primitives */
         void genCone    (float height = 3.0f, float r = 1.5f, unsigned int slices = 10, unsigned int stacks = 10);
         void genCube    (float radius = 1.0f);
@@ -28,32 +44,65 @@ namespace Vertex
         void genQuad    (float width = 1.0f, float height = 1.0f);
 
         void load(const std::string & filename);
+
+        /* Builds the meshes of an imported file, the GL context must be current on the calling thread */
+        void load(const ModelImport & imported);
+
+        /**
+         * @brief Reads the file and decodes its textures, thread safe - e.g. several files at once or on a background
+         *        thread, so that load() only uploads. The scene is null on failure.
+         */
+        static std::shared_ptr<ModelImport> import(const std::string & filename);
+
         void render(Shader & shader);
 
         void setDrawMode(GLenum draw_mode);
-        GLenum getDrawMode() { return getMesh(0).getDrawMode(); }
+        GLenum getDrawMode() const { return getMesh(0).getDrawMode(); }
 
         Mesh & getMesh(unsigned int index = 0)
         {
-            if (index > m_meshes.size())
+            std::vector<Mesh> & meshes = mutableMeshes();
+
+            if (index > meshes.size())
             {
-                index = m_meshes.size() - 1;
+                index = meshes.size() - 1;
             }
 
-            return m_meshes[index];
+            return meshes[index];
         }
 
-        unsigned meshesCount() const { return m_meshes.size(); }
+        const Mesh & getMesh(unsigned int index = 0) const
+        {
+            if (index > m_meshes->size())
+            {
+                index = m_meshes->size() - 1;
+            }
+
+            return (*m_meshes)[index];
+        }
+
+        unsigned meshesCount() const { return m_meshes->size(); }
+
+        /* Keeps the meshes alive and unchanged for as long as it's held, e.g. by the render snapshots */
+        std::shared_ptr<const std::vector<Mesh>> sharedMeshes() const { return m_meshes; }
+
+        /* Bounding box of all the meshes in the model space, empty at the origin for a model without meshes */
+        void getBounds(glm::vec3 & min, glm::vec3 & max) const;
+
+        /* Per-vertex tangents from positions and texture coordinates, for normal mapping */
+        static void calcTangentSpace(VertexBuffers & buffers);
 
     private:
-        void calcTangentSpace(VertexBuffers & buffers) const;
+        /* Copies the meshes first when they are shared with other models or snapshots */
+        std::vector<Mesh> & mutableMeshes();
+
         void genPrimitive(VertexBuffers & buffers);
 
-        void processNode(aiNode * node, const aiScene * scene, aiString & directory);
-        Mesh processMesh(aiMesh * mesh, const aiScene * scene, aiString & directory) const;
+        void processNode(aiNode * node, const ModelImport & imported, aiString & directory);
+        Mesh processMesh(aiMesh * mesh, const ModelImport & imported, aiString & directory) const;
 
-        void loadMaterialTextures(Mesh & mesh, aiMaterial * mat, aiTextureType type, Material::TextureType texture_type, aiString & directory) const;
+        void loadMaterialTextures(Mesh & mesh, aiMaterial * mat, aiTextureType type, Material::TextureType texture_type, const ModelImport & imported, aiString & directory) const;
 
-        std::vector<Mesh> m_meshes;
+        std::shared_ptr<std::vector<Mesh>> m_meshes;
     };
 }
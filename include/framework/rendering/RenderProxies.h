@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core_components/ModelRendererComponent.h"
+#include "core_components/TransformComponent.h"
+#include "framework/rendering/RenderSnapshot.h"
+
+namespace Vertex
+{
+    struct RenderProxy
+    {
+        RenderItem                          m_item;
+        Model                             * m_model;     /* The meshes are taken on every extract, so the materials may be edited */
+        const TransformComponent          * m_transform; /* For the interpolation of the movable ones */
+        ModelRendererComponent::RenderQueue m_queue;
+        uint32_t                            m_index;     /* Of the entity */
+        uint64_t                            m_id;
+    };
+
+    /**
+     * The renderer's own copy of what it draws - one packed proxy per renderable entity,
+     * refreshed only when its transform or ModelRendererComponent changes. The proxies are kept sorted by their keys,
+     * so the frames are extracted with a linear scan and no sorting in the steady state.
+     */
+    class RenderProxies final
+    {
+    public:
+        RenderProxies()
+            : m_is_order_dirty(false)
+        {}
+
+        /* Adds the proxy or replaces the one of the same entity */
+        void update(const RenderProxy & proxy);
+
+        /* Does nothing when the entity has no proxy - the id tells apart the entities reusing an index */
+        void remove(uint32_t index, uint64_t id);
+
+        /* Restores the order by sort keys after the proxies were added, removed or their keys changed */
+        void sort();
+
+        const std::vector<RenderProxy> & proxies() const { return m_proxies; }
+
+    private:
+        static const uint32_t INVALID_PROXY = 0xFFFFFFFFu;
+
+        std::vector<RenderProxy> m_proxies;
+        std::vector<uint32_t>    m_proxies_indices; /* By entity index */
+        bool                     m_is_order_dirty;
+    };
+}
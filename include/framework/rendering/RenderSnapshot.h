@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "core_components/BaseLightComponent.h"
+#include "framework/gui/GUI.h"
+#include "framework/rendering/Attenuation.h"
+#include "framework/rendering/Mesh.h"
+
+namespace Vertex
+{
+    class Skybox;
+
+    struct RenderItem
+    {
+        /* Shared with the ModelRendererComponent's model, which copies them before any change - see Model::mutableMeshes() */
+        std::shared_ptr<const std::vector<Mesh>> m_meshes;
+        glm::mat4   m_world_matrix;
+        glm::mat3   m_normal_matrix;
+        glm::vec3   m_position;
+        glm::vec3   m_bounds_min; /* World space, from the current step's pose */
+        glm::vec3   m_bounds_max;
+        uint64_t    m_sort_key;   /* Items with equal keys share the geometry */
+        bool        m_is_static;  /* The matrices never change, see TransformComponent::setStatic() */
+    };
+
+    struct CameraData
+    {
+        glm::mat4 m_view;
+        glm::mat4 m_projection;
+        glm::mat4 m_view_projection;
+        glm::vec3 m_position;
+    };
+
+    struct DirectionalLightData
+    {
+        glm::vec3  m_color;
+        float      m_intensity;
+        glm::vec3  m_direction;
+        ShadowInfo m_shadow_info;
+    };
+
+    struct PointLightData
+    {
+        glm::vec3   m_color;
+        float       m_intensity;
+        Attenuation m_attenuation;
+        float       m_range;
+        glm::vec3   m_position;
+        ShadowInfo  m_shadow_info;
+    };
+
+    struct SpotLightData
+    {
+        glm::vec3   m_color;
+        float       m_intensity;
+        Attenuation m_attenuation;
+        float       m_range;
+        glm::vec3   m_position;
+        glm::vec3   m_direction;
+        glm::quat   m_orientation;
+        float       m_cutoff;
+        ShadowInfo  m_shadow_info;
+    };
+
+    /**
+     * Everything the renderer needs to draw a single frame. It is filled by
+     * RenderingSystem::extract() and doesn't reference any entities, so the
+     * simulation can go on while the snapshot is being rendered.
+     */
+    class RenderSnapshot final
+    {
+    public:
+        RenderSnapshot()
+            : m_width(0),
+              m_height(0),
+              m_debug_rendering(false)
+        {}
+
+        RenderSnapshot(const RenderSnapshot &) = delete;
+        RenderSnapshot & operator=(const RenderSnapshot &) = delete;
+
+        /* Keeps the memory, so the snapshots don't allocate in the steady state. The render thread
+           clears the rendered snapshots, so it releases the GL buffers of the meshes only they kept */
+        void clear()
+        {
+            m_opaque_items.clear();
+            m_alpha_items.clear();
+            m_enviro_static_items.clear();
+
+            m_directional_lights.clear();
+            m_point_lights.clear();
+            m_spot_lights.clear();
+
+            m_skybox.reset();
+        }
+
+        unsigned m_width;
+        unsigned m_height;
+
+        CameraData m_camera;
+        glm::vec3  m_scene_ambient_color;
+        bool       m_debug_rendering;
+
+        std::vector<RenderItem> m_opaque_items;
+        std::vector<RenderItem> m_alpha_items;
+        std::vector<RenderItem> m_enviro_static_items;
+
+        std::vector<DirectionalLightData> m_directional_lights;
+        std::vector<PointLightData>       m_point_lights;
+        std::vector<SpotLightData>        m_spot_lights;
+
+        std::shared_ptr<Skybox> m_skybox;
+
+        GUIDrawData m_gui;
+    };
+}
@@ -7,6 +7,7 @@
 #include <entityx/Entity.h>
 #include "core_components/TransformComponent.h"
 #include "Material.h"
+#include "UniformName.h"
 
 namespace Vertex
 {
@@ -48,35 +49,38 @@ namespace Vertex
 
         bool link();
         void bind() const;
-        void updateUniforms(Material & material);
-        void updateGlobalUniforms(const TransformComponent & transform);
-
-        void setUniform(const std::string & uniformName, float value);
-        void setUniform(const std::string & uniformName, int value);
-        void setUniform(const std::string & uniformName, unsigned int value);
-        void setUniform(const std::string & uniformName, GLsizei count, float * value);
-        void setUniform(const std::string & uniformName, GLsizei count, int * value);
-        void setUniform(const std::string & uniformName, GLsizei count, glm::vec3 * vectors);
-        void setUniform(const std::string & uniformName, const glm::vec2 & vector);
-        void setUniform(const std::string & uniformName, const glm::vec3 & vector);
-        void setUniform(const std::string & uniformName, const glm::vec4 & vector);
-        void setUniform(const std::string & uniformName, const glm::mat3 & matrix);
-        void setUniform(const std::string & uniformName, const glm::mat4 & matrix);
-        void setUniform(const std::string & uniformName, glm::mat4 * matrices, unsigned count);
-
-        void setSubroutine(Type shader_type, const std::string & subroutine_name);
+        void updateUniforms(const Material & material);
+        void updateGlobalUniforms(const glm::mat4 & world_matrix,
+                                  const glm::mat3 & normal_matrix,
+                                  const glm::mat4 & view_projection,
+                                  const glm::vec3 & camera_position);
+
+        void setUniform(const UniformName & uniformName, float value);
+        void setUniform(const UniformName & uniformName, int value);
+        void setUniform(const UniformName & uniformName, unsigned int value);
+        void setUniform(const UniformName & uniformName, GLsizei count, float * value);
+        void setUniform(const UniformName & uniformName, GLsizei count, int * value);
+        void setUniform(const UniformName & uniformName, GLsizei count, glm::vec3 * vectors);
+        void setUniform(const UniformName & uniformName, const glm::vec2 & vector);
+        void setUniform(const UniformName & uniformName, const glm::vec3 & vector);
+        void setUniform(const UniformName & uniformName, const glm::vec4 & vector);
+        void setUniform(const UniformName & uniformName, const glm::mat3 & matrix);
+        void setUniform(const UniformName & uniformName, const glm::mat4 & matrix);
+        void setUniform(const UniformName & uniformName, glm::mat4 * matrices, unsigned count);
+
+        void setSubroutine(Type shader_type, const UniformName & subroutine_name);
 
     private:
         void addAllUniforms();
         void addAllSubroutines();
 
         void addShader(std::string const & file_name, GLuint type) const;
-        bool getUniformLocation(const std::string & uniform_name);
+        GLint findUniformLocation(const UniformName & uniform_name);
 
-        std::map<std::string, GLuint> m_subroutine_indices;
+        UniformTable<GLuint> m_subroutine_indices;
         std::map<GLenum, GLuint> m_active_subroutine_uniform_locations;
 
-        std::map<std::string, GLint> m_uniforms_locations;
+        UniformTable<GLint>          m_uniforms_locations;
         std::vector<std::string>     m_uniforms_names;
         std::vector<std::string>     m_global_uniforms_names;
         std::vector<GLint>           m_uniforms_types;
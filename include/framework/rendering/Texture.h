@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <memory>
 #include <string>
 #include <glm/vec4.hpp>
 
@@ -19,6 +20,20 @@ namespace Vertex
         GLuint channels;
     };
 
+    /* CPU side of an image file - decoded pixels, nothing is uploaded yet */
+    struct TextureImport
+    {
+        TextureImport() = default;
+        ~TextureImport();
+
+        TextureImport(const TextureImport &) = delete;
+        TextureImport & operator=(const TextureImport &) = delete;
+
+        std::string     m_filename;
+        ImageData       m_image_data;
+        unsigned char * m_pixels = nullptr; /* Null on failure and without a GL context */
+    };
+
     class Texture final
     {
     public:
@@ -32,10 +47,15 @@ namespace Vertex
         GLuint getHeight() const { return m_tex_data.height; }
         GLuint getID()     const {  return m_to_id; }
 
+        /* Decodes the file, thread safe - e.g. several files at once. Only reads the image's header when headless */
+        static std::shared_ptr<TextureImport> import(const std::string & filename);
+
     private:
         void genTexture2D     (const std::string & filename,  GLuint num_mipmaps, bool is_srgb = false);
+        void genTexture2D     (const TextureImport & imported, GLuint num_mipmaps, bool is_srgb = false);
         void genTexture2D1x1  (const glm::uvec4 & color);
         void genCubeMapTexture(const std::string * filenames, GLuint num_mipmaps, bool is_srgb = false);
+        void genHeadless      (const std::string * filenames, int files_count, GLenum type, GLuint num_mipmaps, bool is_srgb);
 
         ImageData m_tex_data;
         GLuint m_to_id;
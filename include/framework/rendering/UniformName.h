@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Vertex
+{
+    /**
+     * Non-owning name of a uniform or subroutine. Built implicitly from string literals
+     * and std::strings, so passing e.g. S_POINT_LIGHT ".base.color" to Shader::setUniform()
+     * doesn't create a temporary std::string every frame.
+     */
+    struct UniformName
+    {
+        UniformName(const char * name)
+            : m_name(name),
+              m_length(strlen(name)),
+              m_hash(hash(name, m_length))
+        {}
+
+        UniformName(const std::string & name)
+            : m_name(name.c_str()),
+              m_length(name.size()),
+              m_hash(hash(name.c_str(), name.size()))
+        {}
+
+        bool operator==(const std::string & name) const
+        {
+            return m_length == name.size() && memcmp(m_name, name.c_str(), m_length) == 0;
+        }
+
+        /* FNV-1a */
+        static uint32_t hash(const char * name, size_t length)
+        {
+            uint32_t hash = 2166136261u;
+
+            for (size_t i = 0; i < length; ++i)
+            {
+                hash = (hash ^ uint8_t(name[i])) * 16777619u;
+            }
+
+            return hash;
+        }
+
+        const char * m_name;
+        size_t       m_length;
+        uint32_t     m_hash;
+    };
+
+    /* Values by name kept sorted by the name's hash - lookups don't allocate */
+    template <typename T>
+    class UniformTable
+    {
+    public:
+        void insert(const UniformName & name, const T & value)
+        {
+            T * existing = find(name);
+
+            if (existing)
+            {
+                *existing = value;
+                return;
+            }
+
+            Entry entry = { name.m_hash, std::string(name.m_name, name.m_length), value };
+            m_entries.insert(lowerBound(name.m_hash), std::move(entry));
+        }
+
+        T * find(const UniformName & name)
+        {
+            for (auto it = lowerBound(name.m_hash); it != m_entries.end() && it->m_hash == name.m_hash; ++it)
+            {
+                if (name == it->m_name)
+                {
+                    return &it->m_value;
+                }
+            }
+
+            return nullptr;
+        }
+
+    private:
+        struct Entry
+        {
+            uint32_t    m_hash;
+            std::string m_name;
+            T           m_value;
+        };
+
+        typename std::vector<Entry>::iterator lowerBound(uint32_t hash)
+        {
+            return std::lower_bound(m_entries.begin(), m_entries.end(), hash,
+                                    [](const Entry & entry, uint32_t value) { return entry.m_hash < value; });
+        }
+
+        std::vector<Entry> m_entries;
+    };
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include <cstddef>
+
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Vertex
+{
+    /**
+     * Kernels for affine matrices - matrices stored as glm::mat4 whose last row is (0, 0, 0, 1).
+     * They skip the work a general 4x4 math does for that row. The products use SSE, or AVX
+     * when the engine is compiled with it enabled (e.g. /arch:AVX2 or -mavx2).
+     */
+    class AffineMath
+    {
+    public:
+        /* translate(position) * mat4_cast(orientation) * scale(scale), without the three full matrices */
+        static glm::mat4 composeTRS(const glm::vec3 & position, const glm::quat & orientation, const glm::vec3 & scale);
+
+        /* mat4_cast(orientation) * translate(translation), e.g. a view matrix */
+        static glm::mat4 composeRT(const glm::quat & orientation, const glm::vec3 & translation);
+
+        /* lhs * rhs - rhs has to be affine, lhs can be any matrix (e.g. a projection) */
+        static glm::mat4 multiply(const glm::mat4 & lhs, const glm::mat4 & rhs);
+
+        /* result[i] = lhs[i] * rhs[i] */
+        static void multiply(const glm::mat4 * lhs, const glm::mat4 * rhs, glm::mat4 * result, std::size_t count);
+
+        /* result[i] = lhs * rhs[i] */
+        static void multiply(const glm::mat4 & lhs, const glm::mat4 * rhs, glm::mat4 * result, std::size_t count);
+
+        /* mat3(transpose(inverse(affine))) from the cofactors of the upper 3x3 */
+        static glm::mat3 normalMatrix(const glm::mat4 & affine);
+
+        /* Same as normalMatrix() when the matrix is a rotation and a uniform scale only */
+        static glm::mat3 normalMatrixUniform(const glm::mat4 & affine);
+
+        /* Box that encloses the affine transformed box [min, max] */
+        static void transformBounds(const glm::mat4 & affine, const glm::vec3 & min, const glm::vec3 & max, glm::vec3 & result_min, glm::vec3 & result_max);
+
+        static bool isUniformScale(const glm::vec3 & scale) { return scale.x == scale.y && scale.y == scale.z; }
+    };
+}
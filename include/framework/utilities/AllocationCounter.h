@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Vertex
+{
+    /**
+     * Counts the calls to the global operator new of the whole program, over-aligned ones included, e.g. to check
+     * that a steady-state frame doesn't touch the heap. It replaces the global operator
+     * new/delete of every program linking the engine, so it's opt-in - configure with
+     * -DVE_ALLOCATION_COUNTER=ON (defines VE_ENABLE_ALLOCATION_COUNTER).
+     */
+    class AllocationCounter final
+    {
+    public:
+        AllocationCounter() = delete;
+        ~AllocationCounter() = delete;
+
+        /* Allocations since the start of the program, 0 when the counter is disabled */
+        static uint64_t getCount();
+
+        static bool isEnabled();
+    };
+}
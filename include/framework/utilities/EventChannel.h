@@ -0,0 +1,234 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Vertex
+{
+    /**
+     * Multi-producer, single-consumer queue of events. Any number of threads post without
+     * locks - every post is one compare-and-swap - and one thread drains the whole batch
+     * at once, in the order the events were posted.
+     *
+     * Nodes are allocated in blocks and recycled by the consumer, so posting only allocates
+     * when more events are pending than ever before. Past MAX_BLOCKS blocks the extra nodes
+     * are allocated one by one and freed when drained.
+     */
+    template <typename E>
+    class EventChannel final
+    {
+    public:
+        static const uint32_t BLOCK_SIZE = 64;
+        static const uint32_t MAX_BLOCKS = 256;
+
+        EventChannel()
+            : m_head(nullptr),
+              m_free_head(INVALID_INDEX),
+              m_blocks_count(0)
+        {
+            for (auto & block : m_blocks)
+            {
+                block.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~EventChannel()
+        {
+            Node * node = m_head.load(std::memory_order_acquire);
+
+            while (node)
+            {
+                Node * next = node->m_next;
+                node->event().~E();
+
+                if (node->m_index == INVALID_INDEX)
+                {
+                    delete node;
+                }
+
+                node = next;
+            }
+
+            for (auto & block : m_blocks)
+            {
+                delete[] block.load(std::memory_order_acquire);
+            }
+        }
+
+        EventChannel(const EventChannel &) = delete;
+        EventChannel & operator=(const EventChannel &) = delete;
+
+        /* The event is constructed from args. Thread safe */
+        template <typename ... Args>
+        void post(Args && ... args)
+        {
+            Node * node = acquireNode();
+            new (&node->m_storage) E(std::forward<Args>(args) ...);
+
+            node->m_next = m_head.load(std::memory_order_relaxed);
+
+            while (!m_head.compare_exchange_weak(node->m_next, node, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        /**
+         * @brief Calls func(const E &) for every event posted so far, oldest first.
+         *        Only one thread may drain. The events posted meanwhile are left for the next call.
+         * @return Number of the events.
+         */
+        template <typename F>
+        std::size_t drain(F && func)
+        {
+            Node * node = m_head.exchange(nullptr, std::memory_order_acquire);
+
+            /* The batch is newest first */
+            Node * oldest = nullptr;
+
+            while (node)
+            {
+                Node * next = node->m_next;
+                node->m_next = oldest;
+                oldest = node;
+                node = next;
+            }
+
+            std::size_t count = 0;
+
+            /* Recycled at once at the end, with a single compare-and-swap */
+            Node * first_free = nullptr;
+            Node * last_free  = nullptr;
+
+            while (oldest)
+            {
+                Node * next = oldest->m_next;
+
+                func(static_cast<const E &>(oldest->event()));
+                oldest->event().~E();
+
+                if (oldest->m_index == INVALID_INDEX)
+                {
+                    delete oldest;
+                }
+                else
+                {
+                    oldest->m_free_next.store(first_free ? first_free->m_index : INVALID_INDEX, std::memory_order_relaxed);
+                    last_free  = last_free ? last_free : oldest;
+                    first_free = oldest;
+                }
+
+                oldest = next;
+                ++count;
+            }
+
+            if (first_free)
+            {
+                pushFree(first_free, last_free);
+            }
+
+            return count;
+        }
+
+        bool isEmpty() const { return m_head.load(std::memory_order_acquire) == nullptr; }
+
+    private:
+        static const uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+        struct Node
+        {
+            E & event() { return *reinterpret_cast<E *>(&m_storage); }
+
+            typename std::aligned_storage<sizeof(E), alignof(E)>::type m_storage;
+
+            Node *                m_next;      /* Pending events */
+            std::atomic<uint32_t> m_free_next; /* Free nodes, by index */
+            uint32_t              m_index;     /* INVALID_INDEX when it's not from a block */
+        };
+
+        Node * nodeAt(uint32_t index) const
+        {
+            return m_blocks[index / BLOCK_SIZE].load(std::memory_order_acquire) + index % BLOCK_SIZE;
+        }
+
+        /*
+         * The free list head is a node index with a tag in the upper half. Every change bumps the tag,
+         * so a node that was popped and pushed back meanwhile can't make a stale pop succeed (ABA).
+         */
+        Node * acquireNode()
+        {
+            uint64_t head = m_free_head.load(std::memory_order_acquire);
+
+            while (uint32_t(head) != INVALID_INDEX)
+            {
+                Node *   node = nodeAt(uint32_t(head));
+                uint64_t next = ((head >> 32) + 1) << 32 | node->m_free_next.load(std::memory_order_relaxed);
+
+                if (m_free_head.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+                {
+                    return node;
+                }
+            }
+
+            return allocateNode();
+        }
+
+        /* [first, last] linked by m_free_next */
+        void pushFree(Node * first, Node * last)
+        {
+            uint64_t head = m_free_head.load(std::memory_order_relaxed);
+            uint64_t next;
+
+            do
+            {
+                last->m_free_next.store(uint32_t(head), std::memory_order_relaxed);
+                next = ((head >> 32) + 1) << 32 | first->m_index;
+            }
+            while (!m_free_head.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        /* A new block - one node is returned, the rest go to the free list */
+        Node * allocateNode()
+        {
+            uint32_t block = m_blocks_count.load(std::memory_order_relaxed);
+
+            do
+            {
+                if (block == MAX_BLOCKS)
+                {
+                    Node * node = new Node();
+                    node->m_index = INVALID_INDEX;
+
+                    return node;
+                }
+            }
+            while (!m_blocks_count.compare_exchange_weak(block, block + 1, std::memory_order_relaxed));
+
+            Node * nodes = new Node[BLOCK_SIZE];
+
+            for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+            {
+                nodes[i].m_index = block * BLOCK_SIZE + i;
+                nodes[i].m_free_next.store(nodes[i].m_index + 1, std::memory_order_relaxed);
+            }
+
+            m_blocks[block].store(nodes, std::memory_order_release);
+
+            pushFree(&nodes[1], &nodes[BLOCK_SIZE - 1]);
+
+            return &nodes[0];
+        }
+
+        std::atomic<Node *>   m_head;
+        std::atomic<uint64_t> m_free_head;
+        std::atomic<uint32_t> m_blocks_count;
+        std::atomic<Node *>   m_blocks[MAX_BLOCKS];
+    };
+
+    template <typename E> const uint32_t EventChannel<E>::BLOCK_SIZE;
+    template <typename E> const uint32_t EventChannel<E>::MAX_BLOCKS;
+    template <typename E> const uint32_t EventChannel<E>::INVALID_INDEX;
+}
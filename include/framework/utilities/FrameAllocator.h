@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace Vertex
+{
+    /**
+     * Bump allocator for data that lives at most until the end of the next frame.
+     * Every thread has two arenas, one is filled while the other still holds the
+     * previous frame's data. Memory is never freed one allocation at a time - the
+     * whole arena is reset when it's reused two frames later.
+     *
+     * Once the arenas have grown to the size of a frame's data they don't allocate anymore.
+     */
+    class FrameAllocator final
+    {
+    public:
+        FrameAllocator() = delete;
+        ~FrameAllocator() = delete;
+        FrameAllocator(const FrameAllocator &) = delete;
+        FrameAllocator & operator=(const FrameAllocator &) = delete;
+
+        /**
+         * @brief Starts a new frame for all the threads that don't call beginThreadFrame(),
+         *        they switch arenas on their next allocation. Called by the main loop.
+         */
+        static void beginFrame();
+
+        /* For threads with their own frame loop, e.g. the render thread - it stops following beginFrame() */
+        static void beginThreadFrame();
+
+        static void * allocate(size_t size, size_t alignment);
+
+        template <typename T>
+        static T * allocateArray(size_t count)
+        {
+            return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+        }
+
+        /* Bytes allocated by the calling thread in the current frame */
+        static size_t getUsedBytes();
+
+    private:
+        class Arena;
+        struct ThreadArenas;
+
+        static ThreadArenas & threadArenas();
+
+        static std::atomic<uint64_t> m_frame;
+    };
+
+    /* STL adapter, e.g. std::vector<int, FrameStlAllocator<int>> - deallocate() does nothing */
+    template <typename T>
+    class FrameStlAllocator
+    {
+    public:
+        typedef T value_type;
+
+        FrameStlAllocator() {}
+
+        template <typename U>
+        FrameStlAllocator(const FrameStlAllocator<U> &) {}
+
+        T * allocate(size_t count)
+        {
+            return FrameAllocator::allocateArray<T>(count);
+        }
+
+        void deallocate(T *, size_t) {}
+
+        template <typename U>
+        bool operator==(const FrameStlAllocator<U> &) const { return true; }
+
+        template <typename U>
+        bool operator!=(const FrameStlAllocator<U> &) const { return false; }
+    };
+
+    template <typename T>
+    using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Vertex
+{
+    struct FrameSample
+    {
+        float    m_frame_ms;   /* From the start of the previous frame, waiting included */
+        float    m_sim_ms;     /* All the fixed steps of the frame */
+        float    m_render_ms;  /* Building and submitting the frame, on the render thread when it's pipelined */
+        float    m_swap_ms;
+        unsigned m_sim_steps;
+        unsigned m_heap_allocations; /* Calls to the global operator new during the frame, all threads */
+    };
+
+    /**
+     * Ring buffer of the last N frames' timings. Recording a frame is a few
+     * stores - the statistics are only computed when something asks for them,
+     * e.g. the performance HUD when it's visible.
+     */
+    class FrameTelemetry final
+    {
+    public:
+        enum class Metric { FRAME_TIME, SIM_TIME, RENDER_TIME, SWAP_TIME, SIM_STEPS, HEAP_ALLOCATIONS };
+
+        explicit FrameTelemetry(size_t capacity = 600);
+
+        void push(const FrameSample & sample);
+        void clear();
+
+        size_t size()     const { return m_count; }
+        size_t capacity() const { return m_samples.size(); }
+
+        /* i = 0 is the oldest frame */
+        const FrameSample & get(size_t i) const;
+
+        /**
+         * @brief Nearest-rank percentile of the recorded frames.
+         * @param percentile In range [0, 100].
+         */
+        float percentile(Metric metric, float percentile) const;
+        float max(Metric metric) const;
+
+        /* Values from the oldest to the newest frame, e.g. for ImGui::PlotLines() */
+        void values(Metric metric, std::vector<float> & values) const;
+
+        /* Number of frames in each of bins_count equal bins in [0, max_value], the last bin takes everything above */
+        void histogram(Metric metric, float max_value, size_t bins_count, std::vector<float> & bins) const;
+
+    private:
+        static float value(const FrameSample & sample, Metric metric);
+
+        std::vector<FrameSample> m_samples;
+        size_t                   m_next;
+        size_t                   m_count;
+
+        /* Reused by percentile(), so it doesn't allocate every frame */
+        mutable std::vector<float> m_scratch;
+    };
+}
@@ -10,10 +10,6 @@ namespace Vertex
         GeomPrimitive() = delete;
         ~GeomPrimitive() = delete;
 
-        friend class Model;
-        friend class Skybox;
-
-    private:
         static void genCube(VertexBuffers & buffers, float radius);
         static void genCubeMap(VertexBuffers & buffers, float radius);
         static void genTorus(VertexBuffers & buffers, float innerRadius, float outerRadius, unsigned int slices, unsigned int stacks);
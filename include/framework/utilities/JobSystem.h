@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Vertex
+{
+    /**
+     * Counts jobs that were submitted but not finished yet.
+     * Pass it to JobSystem::submit() and wait for it with JobSystem::wait().
+     */
+    class JobCounter final
+    {
+    public:
+        JobCounter()
+            : m_pending(0)
+        {}
+
+        JobCounter(const JobCounter &) = delete;
+        JobCounter & operator=(const JobCounter &) = delete;
+
+        bool isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        std::atomic<int> m_pending;
+
+        friend class JobSystem;
+    };
+
+    /**
+     * Plain job description. Jobs don't own any memory, so submitting them never
+     * allocates - m_data has to stay alive until the job has been executed.
+     */
+    struct Job
+    {
+        typedef void(*Function)(void * data, std::size_t begin, std::size_t end);
+
+        Function     m_function;
+        void       * m_data;
+        std::size_t  m_begin;
+        std::size_t  m_end;
+        JobCounter * m_counter;
+    };
+
+    /**
+     * Work-stealing thread pool. Every worker owns a queue - it pops its own jobs
+     * from the back (LIFO) and steals from the front (FIFO) of the other queues
+     * when it runs out of work. Threads that are not workers (e.g. the main thread)
+     * share one additional queue and help executing jobs while they wait.
+     */
+    class JobSystem final
+    {
+    public:
+        JobSystem() = delete;
+        ~JobSystem() = delete;
+
+        /**
+         * @brief Spawns worker threads. With 0 workers all the jobs are executed
+         *        by the threads that wait for them.
+         */
+        static void init(unsigned workers_count);
+        static void shutdown();
+
+        /* Number of worker threads, the calling thread is not included */
+        static unsigned getWorkersCount();
+
+        /* Number of threads that execute jobs, including the calling thread */
+        static unsigned getThreadsCount() { return getWorkersCount() + 1; }
+
+        static void submit(const Job & job);
+
+        /**
+         * @brief Executes pending jobs on the calling thread until the counter drops to zero.
+         */
+        static void wait(JobCounter & counter);
+
+        /**
+         * @brief Executes at most one pending job on the calling thread.
+         * @return false if there was nothing to do.
+         */
+        static bool runOne();
+
+        /**
+         * @brief Calls func(i) for every i in [begin, end) using all threads.
+         *        The calling thread takes part in the work and returns when
+         *        all the iterations are done.
+         * @param grain Number of iterations in a single job; 0 picks it automatically.
+         */
+        template <typename F>
+        static void parallelFor(std::size_t begin, std::size_t end, F && func, std::size_t grain = 0)
+        {
+            if (begin >= end)
+            {
+                return;
+            }
+
+            const std::size_t count = end - begin;
+
+            if (grain == 0)
+            {
+                /* A few jobs per thread, so the stealing can even out the load */
+                grain = count / (getThreadsCount() * 4);
+                grain = grain > 0 ? grain : 1;
+            }
+
+            if (getWorkersCount() == 0 || count <= grain)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    func(i);
+                }
+
+                return;
+            }
+
+            typedef typename std::remove_reference<F>::type Function;
+
+            void * data = const_cast<void *>(static_cast<const void *>(&func));
+            JobCounter counter;
+
+            for (std::size_t chunk_begin = begin + grain; chunk_begin < end; chunk_begin += grain)
+            {
+                std::size_t chunk_end = chunk_begin + grain < end ? chunk_begin + grain : end;
+
+                Job job = { &parallelForJob<Function>, data, chunk_begin, chunk_end, &counter };
+                submit(job);
+            }
+
+            parallelForJob<Function>(data, begin, begin + grain);
+
+            wait(counter);
+        }
+
+    private:
+        class JobQueue;
+
+        static void workerLoop(unsigned queue_index);
+        static bool popOrSteal(unsigned queue_index, Job & job);
+        static void execute(const Job & job);
+        static unsigned getQueueIndex();
+
+        template <typename F>
+        static void parallelForJob(void * data, std::size_t begin, std::size_t end)
+        {
+            F & func = *static_cast<F *>(data);
+
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                func(i);
+            }
+        }
+
+        static std::vector<std::thread>               m_workers;
+        static std::vector<std::unique_ptr<JobQueue>> m_queues;
+
+        static std::atomic<bool> m_is_running;
+        static std::atomic<int>  m_queued_jobs;
+        static std::atomic<int>  m_sleeping_workers;
+
+        static std::mutex              m_sleep_mutex;
+        static std::condition_variable m_wake_condition;
+    };
+}
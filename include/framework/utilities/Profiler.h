@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Vertex
+{
+    struct ProfileEvent
+    {
+        /* Not copied - string literals or names owned by objects that outlive the profiler */
+        const char * m_name;
+        uint64_t     m_begin_ns;
+        uint64_t     m_end_ns;
+        uint32_t     m_depth;
+    };
+
+    /**
+     * Collects timed scopes from any number of threads. Every thread writes to its
+     * own ring buffer without locking, the oldest events are overwritten when it's full.
+     * The rings can be exported at any time as a Chrome trace (chrome://tracing, Perfetto).
+     *
+     * Disabled by default, a disabled scope only costs an atomic load. A thread gets its ring
+     * with its first scope while the profiler is enabled, and the ring is handed to another
+     * thread after it exits - its events stay in the trace until then.
+     */
+    class Profiler final
+    {
+    public:
+        Profiler() = delete;
+        ~Profiler() = delete;
+        Profiler(const Profiler &) = delete;
+        Profiler & operator=(const Profiler &) = delete;
+
+        static void setEnabled(bool enabled);
+        static bool isEnabled() { return m_is_enabled.load(std::memory_order_relaxed); }
+
+        /* Names the calling thread in the exported trace, doesn't allocate its ring */
+        static void setThreadName(const std::string & name);
+
+        /**
+         * @brief Adds a named timeline that isn't a thread, e.g. the GPU. At most MAX_LANES of them.
+         * @return Lane's id for record().
+         */
+        static unsigned addLane(const std::string & name);
+
+        /* Nanoseconds of a monotonic clock */
+        static uint64_t now();
+
+        static uint32_t beginScope();
+        static void     endScope(const char * name, uint64_t begin_ns);
+
+        /* Adds a finished event to the lane without locking. Only one thread may record to a lane */
+        static void record(unsigned lane, const ProfileEvent & event);
+
+        /**
+         * @brief Writes all the events that are still in the rings as Chrome trace JSON.
+         * @return FALSE if the file couldn't be written.
+         */
+        static bool exportChromeTrace(const std::string & filename);
+
+        static void clear();
+
+        static const unsigned MAX_LANES = 16;
+
+    private:
+        class Ring;
+        class ThreadState;
+
+        static Ring & threadRing();
+        static Ring & addRing(const std::string & name);
+
+        /* Reuses the ring of an exited thread if there's one */
+        static Ring & acquireRing(const std::string & name);
+        static void   releaseRing(Ring & ring);
+
+        static std::atomic<bool>                  m_is_enabled;
+        static std::mutex                         m_rings_mutex;
+        static std::vector<std::unique_ptr<Ring>> m_rings;      /* Rings are never freed, only reused */
+        static std::vector<Ring *>                m_free_rings; /* Of the exited threads */
+
+        /* Published once with release, so record() finds its ring without the mutex */
+        static std::atomic<Ring *>                m_lanes[MAX_LANES];
+        static unsigned                           m_lanes_count; /* Guarded by m_rings_mutex */
+
+        static thread_local ThreadState m_thread_state;
+    };
+
+    class ProfileScope final
+    {
+    public:
+        explicit ProfileScope(const char * name)
+            : m_name(name),
+              m_begin_ns(0)
+        {
+            if (Profiler::isEnabled())
+            {
+                Profiler::beginScope();
+                m_begin_ns = Profiler::now();
+            }
+        }
+
+        ~ProfileScope()
+        {
+            if (m_begin_ns != 0)
+            {
+                Profiler::endScope(m_name, m_begin_ns);
+            }
+        }
+
+        ProfileScope(const ProfileScope &) = delete;
+        ProfileScope & operator=(const ProfileScope &) = delete;
+
+    private:
+        const char * m_name;
+        uint64_t     m_begin_ns;
+    };
+}
+
+#define VE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define VE_PROFILE_CONCAT(a, b)      VE_PROFILE_CONCAT_IMPL(a, b)
+
+#ifndef VE_DISABLE_PROFILER
+    #define VE_PROFILE_SCOPE(name) ::Vertex::ProfileScope VE_PROFILE_CONCAT(ve_profile_scope_, __LINE__)(name)
+#else
+    #define VE_PROFILE_SCOPE(name)
+#endif
+
+#define VE_PROFILE_FUNCTION() VE_PROFILE_SCOPE(__FUNCTION__)
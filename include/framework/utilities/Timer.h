@@ -7,12 +7,13 @@ namespace Vertex
     {
     public:
         /**
-         * @brief Returns current time in seconds.
+         * @brief Returns current time in seconds. The clock is monotonic,
+         *        the value is only meaningful as a difference of two calls.
          * @return Time in seconds.
          */
         static double getTime()
         {
-            auto now = std::chrono::system_clock::now();
+            auto now = std::chrono::steady_clock::now();
 
             return std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count() / double(SECOND);
         }
@@ -30,5 +30,11 @@ namespace Vertex
         *          Have to be freed with stbi_image_free(data)!
         */
         static unsigned char* loadTexture(const std::string & filename, ImageData & image_data);
+
+        /**
+        * @brief   Reads only the image's header, the pixels are not decoded.
+        * @returns FALSE if the file is not a supported image.
+        */
+        static bool loadTextureInfo(const std::string & filename, ImageData & image_data);
     };
 }
\ No newline at end of file
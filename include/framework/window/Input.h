@@ -1,5 +1,8 @@
 #pragma once
 
+#include <bitset>
+#include <fstream>
+#include <string>
 #include <unordered_map>
 #include <GLFW/glfw3.h>
 #include <glm/vec2.hpp>
@@ -132,6 +135,32 @@ namespace Vertex
         static void init(GLFWwindow * window);
         static void update();
 
+        /**
+         * @brief Samples keys, mouse buttons and the cursor position for the next fixed step.
+         *        The getters return this state until the next call, so every system in a step
+         *        sees the same input. Called by the engine at the beginning of every step.
+         */
+        static void beginTick();
+
+        /**
+         * @brief Writes the input of every step to a binary file, until stopRecording() is called.
+         * @return false if the file can't be opened.
+         */
+        static bool startRecording(const std::string & filename);
+        static void stopRecording();
+        static bool isRecording();
+
+        /**
+         * @brief Reads the input of every step from a file written by startRecording()
+         *        instead of GLFW. Replay stops when the end of the file is reached.
+         *        Cursor positions are moved by the difference of window centers, so
+         *        a recording can be replayed in a window of different size.
+         * @return false if the file can't be opened or isn't an input recording.
+         */
+        static bool startReplay(const std::string & filename);
+        static void stopReplay();
+        static bool isReplaying();
+
         /**
          * @brief Check if key is pressed
          * @param KeyCode keycode
@@ -186,8 +215,28 @@ namespace Vertex
         static void setMouseCursorPosition(const glm::vec2 & cursor_position);
 
     private:
+        struct State
+        {
+            State() : m_mouse_position(0.0f) {}
+
+            std::bitset<GLFW_KEY_LAST + 1>          m_keys;
+            std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> m_mouse_buttons;
+            glm::vec2                               m_mouse_position;
+        };
+
+        static void pollState(State & state);
+        static void writeState(const State & previous_state, const State & state);
+        static bool readState(State & state);
+
         static GLFWwindow * m_window;
 
+        /* Input of the current step */
+        static State m_state;
+
+        static std::ofstream m_record_file;
+        static std::ifstream m_replay_file;
+        static glm::vec2     m_replay_cursor_offset;
+
         /**
          * States:
          * false -> key was not pressed
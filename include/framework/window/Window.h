@@ -15,8 +15,24 @@ namespace Vertex
         ~Window();
 
         static void createWindow(unsigned int width, unsigned int height, const std::string & title);
+
+        /**
+         * @brief Sets up the window's state without GLFW and GL context, for simulations
+         *        running on machines without a GPU. GL objects are not created then.
+         */
+        static void createHeadless(unsigned int width, unsigned int height, const std::string & title);
+        static bool isHeadless();
+
         static void endFrame();
 
+        /* endFrame() split in two, for rendering on a different thread than the one handling events */
+        static void pollEvents();
+        static void swapBuffers();
+
+        /* Moves the GL context between threads */
+        static void makeContextCurrent();
+        static void releaseContext();
+
         static int isCloseRequested();
 
         static int       getWidth();
@@ -33,6 +49,7 @@ namespace Vertex
         static GLFWwindow * m_window;
         static std::string  m_title;
         static glm::vec2    m_window_size;
+        static bool         m_is_headless;
 
         static void error_callback(int error, const char* description)
         {
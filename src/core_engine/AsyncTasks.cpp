@@ -0,0 +1,156 @@
+#include "core_engine/AsyncTasks.h"
+#include "framework/utilities/Profiler.h"
+#include "framework/utilities/Timer.h"
+
+#include <algorithm>
+
+namespace Vertex
+{
+    std::vector<AsyncTasks::Task>    AsyncTasks::m_next_frame;
+    std::vector<AsyncTasks::Delayed> AsyncTasks::m_delayed;
+    EventChannel<AsyncTasks::Task>   AsyncTasks::m_finished;
+
+    std::deque<AsyncTasks::Background> AsyncTasks::m_background;
+    std::thread                        AsyncTasks::m_background_thread;
+    std::mutex                         AsyncTasks::m_background_mutex;
+    std::condition_variable            AsyncTasks::m_background_submitted;
+    std::atomic<std::size_t>           AsyncTasks::m_in_flight_count(0);
+    bool                               AsyncTasks::m_stop_requested = false;
+
+    void AsyncTasks::init()
+    {
+        if (m_background_thread.joinable())
+        {
+            return;
+        }
+
+        m_stop_requested = false;
+        m_background_thread = std::thread(&AsyncTasks::backgroundLoop);
+    }
+
+    void AsyncTasks::shutdown()
+    {
+        if (m_background_thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_background_mutex);
+                m_stop_requested = true;
+                m_background.clear();
+            }
+
+            m_background_submitted.notify_one();
+            m_background_thread.join();
+        }
+
+        m_in_flight_count = 0;
+        m_finished.drain([](const Task &) {});
+        m_next_frame.clear();
+        m_delayed.clear();
+    }
+
+    void AsyncTasks::nextFrame(Task task)
+    {
+        m_next_frame.push_back(std::move(task));
+    }
+
+    void AsyncTasks::after(double seconds, Task task)
+    {
+        m_delayed.push_back(Delayed{ Timer::getTime() + seconds, std::move(task) });
+        std::push_heap(m_delayed.begin(), m_delayed.end(), isLater);
+    }
+
+    void AsyncTasks::run(Task work, Task then)
+    {
+        if (!m_background_thread.joinable())
+        {
+            work();
+            then();
+
+            return;
+        }
+
+        m_in_flight_count.fetch_add(1);
+
+        {
+            std::lock_guard<std::mutex> lock(m_background_mutex);
+            m_background.push_back(Background{ std::move(work), std::move(then) });
+        }
+
+        m_background_submitted.notify_one();
+    }
+
+    void AsyncTasks::post(Task task)
+    {
+        m_in_flight_count.fetch_add(1);
+        m_finished.post(std::move(task));
+    }
+
+    void AsyncTasks::update()
+    {
+        VE_PROFILE_SCOPE("Async Tasks");
+
+        /* Taken first, so the tasks scheduled by the continuations below wait for the next frame */
+        std::vector<Task> frame_tasks;
+        frame_tasks.swap(m_next_frame);
+
+        m_finished.drain([](const Task & then)
+        {
+            then();
+            m_in_flight_count.fetch_sub(1);
+        });
+
+        const double now = Timer::getTime();
+
+        while (!m_delayed.empty() && m_delayed.front().m_time <= now)
+        {
+            std::pop_heap(m_delayed.begin(), m_delayed.end(), isLater);
+
+            Task task = std::move(m_delayed.back().m_task);
+            m_delayed.pop_back();
+
+            task();
+        }
+
+        for (auto & task : frame_tasks)
+        {
+            task();
+        }
+    }
+
+    /* std heaps keep the largest element on top */
+    bool AsyncTasks::isLater(const Delayed & a, const Delayed & b)
+    {
+        return a.m_time > b.m_time;
+    }
+
+    std::size_t AsyncTasks::pendingCount()
+    {
+        return m_next_frame.size() + m_delayed.size() + m_in_flight_count.load();
+    }
+
+    void AsyncTasks::backgroundLoop()
+    {
+        Profiler::setThreadName("Async Tasks");
+
+        while (true)
+        {
+            Background task;
+
+            {
+                std::unique_lock<std::mutex> lock(m_background_mutex);
+                m_background_submitted.wait(lock, [] { return m_stop_requested || !m_background.empty(); });
+
+                if (m_stop_requested)
+                {
+                    return;
+                }
+
+                task = std::move(m_background.front());
+                m_background.pop_front();
+            }
+
+            task.m_work();
+            m_finished.post(std::move(task.m_then));
+        }
+    }
+}
@@ -0,0 +1,7 @@
+#include "core_engine/ChangeVersion.h"
+
+namespace Vertex
+{
+    /* Starts above the version of a system that hasn't run yet */
+    std::atomic<uint32_t> ChangeVersion::m_clock(1);
+}
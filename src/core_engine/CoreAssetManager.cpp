@@ -1,10 +1,16 @@
 #include "core_engine/CoreAssetManager.h"
+#include "core_engine/AsyncTasks.h"
+#include "core_engine/CoreServices.h"
+#include "core_engine/EntitySpawner.h"
+#include "core_engine/World.h"
+#include "framework/utilities/JobSystem.h"
 
 namespace Vertex
 {
     std::vector<GameObject>      CoreAssetManager::m_game_objects;
     std::map<std::string, Model> CoreAssetManager::m_loaded_models;
 
+    std::mutex                                      CoreAssetManager::m_textures_mutex;
     std::map<std::string, std::shared_ptr<Texture>> CoreAssetManager::m_loaded_textures;
     std::map<std::string, std::shared_ptr<Shader>>  CoreAssetManager::m_loaded_shaders;
     std::map<std::string, std::shared_ptr<Font>>    CoreAssetManager::m_loaded_fonts;
@@ -17,6 +23,24 @@ namespace Vertex
         return game_object;
     }
 
+    void CoreAssetManager::createGameObjects(std::size_t count, std::vector<GameObject> & game_objects)
+    {
+        World::EngineScope scope;
+        auto core = CoreServices::getCore();
+
+        std::vector<entityx::Entity> entities;
+        EntitySpawner::spawn(core->entities, core->events, count, entities, TransformComponent());
+
+        m_game_objects.reserve(m_game_objects.size() + count);
+        game_objects.reserve(game_objects.size() + count);
+
+        for (auto & entity : entities)
+        {
+            m_game_objects.push_back(GameObject(entity));
+            game_objects.push_back(m_game_objects.back());
+        }
+    }
+
     std::shared_ptr<Font> CoreAssetManager::createFont(const std::string & font_name, const std::string& filepathname, GLuint font_height)
     {        
         if(m_loaded_fonts.count(font_name))
@@ -32,6 +56,8 @@ namespace Vertex
 
     std::shared_ptr<Texture> CoreAssetManager::createTexture2D(const std::string& filepathname, bool is_srgb, GLint num_mipmaps)
     {
+        std::lock_guard<std::mutex> lock(m_textures_mutex);
+
         if(m_loaded_textures.count(filepathname))
         {
             return m_loaded_textures[filepathname];
@@ -44,8 +70,26 @@ namespace Vertex
         return texture2d;
     }
 
+    std::shared_ptr<Texture> CoreAssetManager::createTexture2D(const TextureImport & imported, bool is_srgb, GLint num_mipmaps)
+    {
+        std::lock_guard<std::mutex> lock(m_textures_mutex);
+
+        if(m_loaded_textures.count(imported.m_filename))
+        {
+            return m_loaded_textures[imported.m_filename];
+        }
+
+        auto texture2d = std::make_shared<Texture>();
+        texture2d->genTexture2D(imported, num_mipmaps, is_srgb);
+        m_loaded_textures[imported.m_filename] = texture2d;
+
+        return texture2d;
+    }
+
     std::shared_ptr<Texture> CoreAssetManager::createTexture2D1x1(const std::string& texture_name, const glm::uvec4& color)
     {
+        std::lock_guard<std::mutex> lock(m_textures_mutex);
+
         if(m_loaded_textures.count(texture_name))
         {
             return m_loaded_textures[texture_name];
@@ -60,6 +104,8 @@ namespace Vertex
 
     std::shared_ptr<Texture> CoreAssetManager::createCubeMapTexture(const std::string * filepathnames, bool is_srgb, GLint num_mipmaps)
     {
+        std::lock_guard<std::mutex> lock(m_textures_mutex);
+
         if (m_loaded_textures.count(filepathnames[0]))
         {
             return m_loaded_textures[filepathnames[0]];
@@ -72,6 +118,49 @@ namespace Vertex
         return texture_cube;
     }
 
+    std::vector<std::shared_ptr<Texture>> CoreAssetManager::createTextures2D(const std::vector<std::string> & filepathnames, bool is_srgb, GLint num_mipmaps)
+    {
+        std::vector<std::shared_ptr<TextureImport>> imported(filepathnames.size());
+        std::vector<std::size_t> missing;
+
+        {
+            std::lock_guard<std::mutex> lock(m_textures_mutex);
+
+            for (std::size_t i = 0; i < filepathnames.size(); ++i)
+            {
+                if (!m_loaded_textures.count(filepathnames[i]))
+                {
+                    missing.push_back(i);
+                }
+            }
+        }
+
+        /* Not locked, the jobs the calling thread picks up meanwhile may use the textures too */
+        JobSystem::parallelFor(0, missing.size(), [&](std::size_t i)
+        {
+            imported[missing[i]] = Texture::import(filepathnames[missing[i]]);
+        }, 1);
+
+        std::lock_guard<std::mutex> lock(m_textures_mutex);
+        std::vector<std::shared_ptr<Texture>> textures;
+        textures.reserve(filepathnames.size());
+
+        for (std::size_t i = 0; i < filepathnames.size(); ++i)
+        {
+            /* The same file may be listed twice */
+            if (imported[i] && !m_loaded_textures.count(filepathnames[i]))
+            {
+                auto texture2d = std::make_shared<Texture>();
+                texture2d->genTexture2D(*imported[i], num_mipmaps, is_srgb);
+                m_loaded_textures[filepathnames[i]] = texture2d;
+            }
+
+            textures.push_back(m_loaded_textures[filepathnames[i]]);
+        }
+
+        return textures;
+    }
+
     Model CoreAssetManager::createModel(const std::string& filepathname)
     {
         if(m_loaded_models.count(filepathname))
@@ -92,6 +181,85 @@ namespace Vertex
         return model;
     }
 
+    std::vector<Model> CoreAssetManager::createModels(const std::vector<std::string> & filepathnames)
+    {
+        std::vector<std::shared_ptr<ModelImport>> imported(filepathnames.size());
+
+        JobSystem::parallelFor(0, filepathnames.size(), [&](std::size_t i)
+        {
+            if (!m_loaded_models.count(filepathnames[i]))
+            {
+                imported[i] = Model::import(filepathnames[i]);
+            }
+        }, 1);
+
+        std::vector<Model> models;
+        models.reserve(filepathnames.size());
+
+        for (std::size_t i = 0; i < filepathnames.size(); ++i)
+        {
+            /* The same file may be listed twice */
+            if (imported[i] && !m_loaded_models.count(filepathnames[i]))
+            {
+                Model model;
+                model.load(*imported[i]);
+                m_loaded_models[filepathnames[i]] = model;
+            }
+
+            models.push_back(m_loaded_models[filepathnames[i]]);
+        }
+
+        return models;
+    }
+
+    void CoreAssetManager::createModelAsync(const std::string & filepathname, const std::function<void(const Model &)> & on_loaded)
+    {
+        if (m_loaded_models.count(filepathname))
+        {
+            Model model = m_loaded_models[filepathname];
+
+            AsyncTasks::nextFrame([model, on_loaded]()
+            {
+                on_loaded(model);
+            });
+
+            return;
+        }
+
+        auto imported = std::make_shared<std::shared_ptr<ModelImport>>();
+
+        AsyncTasks::run([imported, filepathname]()
+        {
+            *imported = Model::import(filepathname);
+        },
+        [imported, filepathname, on_loaded]()
+        {
+            /* Another request for the same file may have finished first */
+            if (m_loaded_models.count(filepathname))
+            {
+                on_loaded(m_loaded_models[filepathname]);
+                return;
+            }
+
+            /* The meshes and decoded textures are uploaded where the GL context is, the model is stored back on the main thread */
+            CoreServices::getCore()->runOnRenderThread([imported, filepathname, on_loaded]()
+            {
+                Model model;
+                model.load(**imported);
+
+                AsyncTasks::post([model, filepathname, on_loaded]()
+                {
+                    if (!m_loaded_models.count(filepathname))
+                    {
+                        m_loaded_models[filepathname] = model;
+                    }
+
+                    on_loaded(m_loaded_models[filepathname]);
+                });
+            });
+        });
+    }
+
     std::shared_ptr<Shader> CoreAssetManager::createShader(const std::string& shader_name,
                                                            const std::string& compute_shader_filepathname)
     {
@@ -192,6 +360,8 @@ namespace Vertex
     }
     std::shared_ptr<Texture> CoreAssetManager::getTexture2D(const std::string& texture_name)
     {
+        std::lock_guard<std::mutex> lock(m_textures_mutex);
+
         if(m_loaded_textures.count(texture_name))
         {
             return m_loaded_textures[texture_name];
@@ -0,0 +1,56 @@
+#include "core_engine/EventChannels.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace Vertex
+{
+    const std::size_t EventChannels::MAX_CHANNELS;
+
+    std::atomic<std::size_t> EventChannels::m_families_count(0);
+
+    EventChannels::EventChannels()
+    {
+        for (auto & relay : m_relays)
+        {
+            relay.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    EventChannels::~EventChannels()
+    {
+        for (auto & relay : m_relays)
+        {
+            delete relay.load(std::memory_order_acquire);
+        }
+    }
+
+    void EventChannels::dispatch(entityx::EventManager & events)
+    {
+        const std::size_t families_count = m_families_count.load(std::memory_order_acquire);
+
+        for (std::size_t family = 0; family < families_count && family < MAX_CHANNELS; ++family)
+        {
+            BaseRelay * relay = m_relays[family].load(std::memory_order_acquire);
+
+            if (relay)
+            {
+                relay->dispatch(events);
+            }
+        }
+    }
+
+    std::size_t EventChannels::nextFamily()
+    {
+        const std::size_t family = m_families_count.fetch_add(1, std::memory_order_relaxed);
+
+        /* Not an assert - release builds would index past the relays */
+        if (family >= MAX_CHANNELS)
+        {
+            fprintf(stderr, "Too many event types posted to EventChannels (more than %u), raise MAX_CHANNELS\n", unsigned(MAX_CHANNELS));
+            abort();
+        }
+
+        return family;
+    }
+}
@@ -0,0 +1,168 @@
+#include "core_engine/FramePacer.h"
+#include "framework/utilities/Timer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace Vertex
+{
+    FramePacer::FramePacer(double step_time)
+        : m_mode(Mode::HYBRID_SLEEP),
+          m_step_time(step_time),
+          m_max_catch_up_steps(5),
+          m_next_step_time(0.0),
+          m_last_frame_time(0.0),
+          m_min_frame_time(0.0),
+          m_interpolation_alpha(1.0),
+          m_sleep_estimate(0.005),
+          m_sleep_mean(0.005),
+          m_sleep_m2(0.0),
+          m_sleep_count(1),
+          m_frame_time_m2(0.0),
+          m_has_last_frame(false)
+    {
+    }
+
+    void FramePacer::setMaxCatchUpSteps(unsigned int steps_count)
+    {
+        m_max_catch_up_steps = std::max(steps_count, 1u);
+    }
+
+    void FramePacer::setMaxFrameRate(double frames_per_second)
+    {
+        m_min_frame_time = frames_per_second > 0.0 ? 1.0 / frames_per_second : 0.0;
+    }
+
+    void FramePacer::reset()
+    {
+        m_next_step_time = Timer::getTime() + m_step_time;
+        m_has_last_frame = false;
+    }
+
+    unsigned int FramePacer::waitForSteps()
+    {
+        waitUntil(m_next_step_time);
+
+        double now = Timer::getTime();
+
+        m_stats.m_max_lateness = std::max(m_stats.m_max_lateness, now - m_next_step_time);
+
+        unsigned int steps = takeDueSteps(now);
+        recordFrame(now);
+
+        return steps;
+    }
+
+    unsigned int FramePacer::waitForFrame()
+    {
+        /* Uncapped, it doesn't wait - the due step is late by as long as the last frame took */
+        double deadline = m_next_step_time;
+
+        if (m_min_frame_time > 0.0 && m_has_last_frame)
+        {
+            deadline = std::min(m_next_step_time, m_last_frame_time + m_min_frame_time);
+            waitUntil(deadline);
+        }
+
+        double now = Timer::getTime();
+
+        m_stats.m_max_lateness = std::max(m_stats.m_max_lateness, now - deadline);
+
+        unsigned int steps = takeDueSteps(now);
+        recordFrame(now);
+
+        return steps;
+    }
+
+    unsigned int FramePacer::takeDueSteps(double now)
+    {
+        unsigned int steps = 0;
+
+        if (now >= m_next_step_time)
+        {
+            /* The step at m_next_step_time is due, plus all the ones that were missed since */
+            unsigned long long due_steps = 1 + static_cast<unsigned long long>((now - m_next_step_time) / m_step_time);
+            steps = unsigned(std::min<unsigned long long>(due_steps, m_max_catch_up_steps));
+
+            m_next_step_time += due_steps * m_step_time;
+            m_stats.m_dropped_steps += due_steps - steps;
+        }
+
+        /* The last due step was at m_next_step_time - m_step_time */
+        m_interpolation_alpha = std::min(std::max(1.0 - (m_next_step_time - now) / m_step_time, 0.0), 1.0);
+
+        return steps;
+    }
+
+    void FramePacer::resetStats()
+    {
+        m_stats          = Stats();
+        m_frame_time_m2  = 0.0;
+        m_has_last_frame = false;
+    }
+
+    void FramePacer::waitUntil(double deadline)
+    {
+        switch (m_mode)
+        {
+        case Mode::SPIN:
+            while (Timer::getTime() < deadline) {}
+            break;
+        case Mode::HYBRID_SLEEP:
+            sleepUntil(deadline);
+            while (Timer::getTime() < deadline) {}
+            break;
+        case Mode::YIELD:
+            while (Timer::getTime() < deadline)
+            {
+                std::this_thread::yield();
+            }
+            break;
+        }
+    }
+
+    void FramePacer::sleepUntil(double deadline)
+    {
+        /**
+         * Sleeps are never shorter than asked, but can be a lot longer (up to ~15 ms on Windows),
+         * so keep sleeping in 1 ms chunks only while the estimated worst sleep still fits.
+         * Welford's algorithm keeps the estimate up to date without storing the samples.
+         */
+        double now = Timer::getTime();
+
+        while (deadline - now > m_sleep_estimate)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            double slept = Timer::getTime() - now;
+            now += slept;
+
+            ++m_sleep_count;
+            double delta  = slept - m_sleep_mean;
+            m_sleep_mean += delta / m_sleep_count;
+            m_sleep_m2   += delta * (slept - m_sleep_mean);
+
+            m_sleep_estimate = m_sleep_mean + std::sqrt(m_sleep_m2 / (m_sleep_count - 1));
+        }
+    }
+
+    void FramePacer::recordFrame(double now)
+    {
+        if (m_has_last_frame)
+        {
+            double frame_time = now - m_last_frame_time;
+
+            ++m_stats.m_frames_count;
+            double delta = frame_time - m_stats.m_mean_frame_time;
+            m_stats.m_mean_frame_time += delta / m_stats.m_frames_count;
+            m_frame_time_m2 += delta * (frame_time - m_stats.m_mean_frame_time);
+
+            m_stats.m_jitter = m_stats.m_frames_count > 1 ? std::sqrt(m_frame_time_m2 / (m_stats.m_frames_count - 1)) : 0.0;
+        }
+
+        m_last_frame_time = now;
+        m_has_last_frame  = true;
+    }
+}
@@ -4,17 +4,36 @@
 #include "core_components/TransformComponent.h"
 #include "core_systems/SceneGraphSystem.h"
 #include "core_engine/CoreServices.h"
+#include "core_engine/World.h"
 
 namespace Vertex
 {
     GameObject::GameObject()
     {
+        /* Also when called from a world's system - the entity is the engine's, so is its transform */
+        World::EngineScope scope;
+
         entity = CoreServices::getCore()->entities.create();
         addComponent<TransformComponent>();
 
         SceneGraphSystem::M_ROOT_NODE.addChild(entity.component<TransformComponent>());
     }
 
+    GameObject::GameObject(World & world)
+    {
+        World::Scope scope(world);
+
+        entity = world.entities().create();
+        addComponent<TransformComponent>();
+
+        world.root().addChild(entity.component<TransformComponent>());
+    }
+
+    GameObject::GameObject(entityx::Entity entity)
+        : entity(entity)
+    {
+    }
+
     void GameObject::setPosition(float x, float y, float z)
     {
         entity.component<TransformComponent>()->setPosition(x, y, z);
@@ -50,8 +69,19 @@ namespace Vertex
         entity.component<TransformComponent>()->setScale(uniform_scale);
     }
 
+    void GameObject::setStatic(bool is_static)
+    {
+        entity.component<TransformComponent>()->setStatic(is_static);
+    }
+
     void GameObject::addChild(GameObject & child)
     {
         entity.component<TransformComponent>()->addChild(child.getComponent<TransformComponent>());
     }
+
+    void GameObject::detach()
+    {
+        /* The root of the object's own scene - the current World may be another one */
+        entity.component<TransformComponent>()->attachToSceneRoot();
+    }
 }
@@ -0,0 +1,91 @@
+#include "core_engine/Prefab.h"
+#include "core_engine/SpawnEvents.h"
+#include "core_systems/SceneGraphSystem.h"
+
+namespace Vertex
+{
+    const Prefab::NodeIndex Prefab::ROOT;
+    const Prefab::NodeIndex Prefab::INVALID_NODE;
+
+    void Prefab::instantiate(entityx::EntityManager & entities,
+                             entityx::EventManager  & events,
+                             const std::vector<PrefabPlacement> & placements,
+                             std::vector<entityx::Entity> & spawned) const
+    {
+        const std::size_t nodes_count     = m_nodes.size();
+        const std::size_t instances_count = placements.size();
+        const std::size_t count           = nodes_count * instances_count;
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        TransformHierarchy & hierarchy = TransformComponent::hierarchy();
+
+        events.emit<SpawnBatchEvent>(count);
+        hierarchy.reserve(count);
+
+        const std::size_t first = spawned.size();
+        spawned.reserve(first + count);
+
+        std::vector<TransformHierarchy::NodeId> transforms(count);
+
+        const Node & root = m_nodes[ROOT];
+
+        for (std::size_t instance = 0; instance < instances_count; ++instance)
+        {
+            const PrefabPlacement & placement = placements[instance];
+
+            for (std::size_t node = 0; node < nodes_count; ++node)
+            {
+                entityx::Entity entity = entities.create();
+                spawned.push_back(entity);
+
+                const Node & prototype = m_nodes[node];
+                entityx::ComponentHandle<TransformComponent> transform;
+
+                if (node == ROOT)
+                {
+                    transform = entity.assign<TransformComponent>(placement.m_position + placement.m_orientation * (placement.m_scale * root.m_position),
+                                                                  placement.m_orientation * root.m_orientation,
+                                                                  placement.m_scale * root.m_scale);
+                }
+                else
+                {
+                    transform = entity.assign<TransformComponent>(prototype.m_position, prototype.m_orientation, prototype.m_scale);
+                }
+
+                transforms[instance * nodes_count + node] = transform->node();
+            }
+        }
+
+        /* Links - a parent precedes its children, so the instance's root comes first */
+        const TransformHierarchy::NodeId scene_root = SceneGraphSystem::root().node();
+
+        for (std::size_t instance = 0; instance < instances_count; ++instance)
+        {
+            const TransformHierarchy::NodeId * instance_transforms = transforms.data() + instance * nodes_count;
+
+            for (std::size_t node = 0; node < nodes_count; ++node)
+            {
+                const Node & prototype = m_nodes[node];
+
+                hierarchy.setParent(instance_transforms[node], node == ROOT ? scene_root : instance_transforms[prototype.m_parent]);
+
+                if (prototype.m_is_static)
+                {
+                    hierarchy.setStatic(instance_transforms[node], true);
+                }
+            }
+        }
+
+        /* Components - type by type, over the same node of every instance */
+        for (auto & component : m_components)
+        {
+            component.m_assign_copies(component.m_prototype.get(), spawned.data() + first + component.m_node, nodes_count, instances_count);
+        }
+
+        events.emit<EntitiesSpawnedEvent>(spawned.data() + first, count);
+    }
+}
@@ -0,0 +1,198 @@
+#include "core_engine/RenderPipeline.h"
+#include "framework/window/Window.h"
+#include "framework/utilities/FrameAllocator.h"
+#include "framework/utilities/Profiler.h"
+
+#include <iterator>
+
+namespace Vertex
+{
+    RenderPipeline::RenderPipeline()
+        : m_submitted_count(0),
+          m_rendered_count(0),
+          m_is_running(false),
+          m_stop_requested(false)
+    {
+    }
+
+    RenderPipeline::~RenderPipeline()
+    {
+        stop();
+    }
+
+    void RenderPipeline::start(entityx::EventManager & events, unsigned snapshots_count, const RenderFunction & render_function)
+    {
+        if (m_is_running)
+        {
+            return;
+        }
+
+        snapshots_count = snapshots_count < 2 ? 2 : snapshots_count;
+
+        m_snapshots.clear();
+        for (unsigned i = 0; i < snapshots_count; ++i)
+        {
+            m_snapshots.push_back(std::unique_ptr<RenderSnapshot>(new RenderSnapshot()));
+        }
+
+        m_render_function = render_function;
+        m_submitted_count = 0;
+        m_rendered_count  = 0;
+        m_stop_requested  = false;
+        m_is_running      = true;
+
+        events.subscribe<entityx::ComponentRemovedEvent<ModelRendererComponent>>(*this);
+
+        Window::releaseContext();
+        m_render_thread = std::thread(&RenderPipeline::renderLoop, this);
+    }
+
+    void RenderPipeline::stop()
+    {
+        if (!m_is_running)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop_requested = true;
+        }
+        m_snapshot_submitted.notify_one();
+
+        m_render_thread.join();
+        Window::makeContextCurrent();
+
+        m_retired_models.clear();
+
+        m_is_running = false;
+    }
+
+    RenderSnapshot & RenderPipeline::beginSnapshot()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        /* The snapshot being filled is the only one that's not counted */
+        m_snapshot_rendered.wait(lock, [this] { return m_submitted_count - m_rendered_count < m_snapshots.size(); });
+
+        return *m_snapshots[m_submitted_count % m_snapshots.size()];
+    }
+
+    void RenderPipeline::submitSnapshot()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_submitted_count;
+        }
+        m_snapshot_submitted.notify_one();
+    }
+
+    void RenderPipeline::waitIdle()
+    {
+        if (!m_is_running)
+        {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_snapshot_rendered.wait(lock, [this] { return m_rendered_count == m_submitted_count; });
+    }
+
+    void RenderPipeline::runOnRenderThread(Task task)
+    {
+        if (!m_is_running)
+        {
+            task();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_snapshot_submitted.notify_one();
+    }
+
+    void RenderPipeline::receive(const entityx::ComponentRemovedEvent<ModelRendererComponent> & event)
+    {
+        if (!m_is_running)
+        {
+            return;
+        }
+
+        entityx::ComponentHandle<ModelRendererComponent> renderer = event.component;
+
+        /* A copy shares the meshes and leaves the component intact for the other receivers. The snapshot
+           being filled drops the removed renderers, only the submitted ones may draw the model */
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_retired_models.push_back(RetiredModel{ renderer->m_model, m_submitted_count });
+    }
+
+    void RenderPipeline::renderLoop()
+    {
+        Window::makeContextCurrent();
+        Profiler::setThreadName("Render");
+
+        std::vector<Task> tasks;
+
+        while (true)
+        {
+            RenderSnapshot * snapshot = nullptr;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_snapshot_submitted.wait(lock, [this] { return m_rendered_count < m_submitted_count || m_stop_requested || !m_tasks.empty(); });
+
+                tasks.swap(m_tasks);
+
+                if (m_rendered_count < m_submitted_count)
+                {
+                    snapshot = m_snapshots[m_rendered_count % m_snapshots.size()].get();
+                }
+                else if (tasks.empty())
+                {
+                    break;
+                }
+            }
+
+            for (auto & task : tasks)
+            {
+                task();
+            }
+
+            tasks.clear();
+
+            if (!snapshot)
+            {
+                continue;
+            }
+
+            FrameAllocator::beginThreadFrame();
+            m_render_function(*snapshot);
+
+            /* The snapshot may hold the last references to the meshes, which have to be released with the GL context */
+            snapshot->clear();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_rendered_count;
+
+                auto retired_end = m_retired_models.begin();
+
+                while (retired_end != m_retired_models.end() && retired_end->m_submitted_count <= m_rendered_count)
+                {
+                    ++retired_end;
+                }
+
+                m_released_models.insert(m_released_models.end(), std::make_move_iterator(m_retired_models.begin()), std::make_move_iterator(retired_end));
+                m_retired_models.erase(m_retired_models.begin(), retired_end);
+            }
+            m_snapshot_rendered.notify_all();
+
+            /* Outside of the lock, deleting the GL buffers may take a while */
+            m_released_models.clear();
+        }
+
+        Window::releaseContext();
+    }
+}
@@ -1,6 +1,52 @@
 ﻿#include "core_engine/Scene.h"
+#include "core_engine/CoreServices.h"
 
 namespace Vertex
 {
-    std::map<std::string, std::shared_ptr<Prefab>> Scene::m_prefabs;
+    std::map<std::string, Prefab> Scene::m_prefabs;
+
+    GameObject Scene::createPrefab(const std::string & object, const PrefabPlacement & placement)
+    {
+        std::vector<GameObject> game_objects;
+        instantiate(object, std::vector<PrefabPlacement>(1, placement), game_objects);
+
+        return game_objects.empty() ? GameObject(entityx::Entity()) : game_objects.front();
+    }
+
+    void Scene::instantiate(const std::string & object, const std::vector<PrefabPlacement> & placements, std::vector<GameObject> & game_objects)
+    {
+        auto prefab = m_prefabs.find(object);
+
+        if (prefab == m_prefabs.end())
+        {
+            return;
+        }
+
+        World::EngineScope scope;
+        auto core = CoreServices::getCore();
+
+        std::vector<entityx::Entity> entities;
+        prefab->second.instantiate(core->entities, core->events, placements, entities);
+
+        const std::size_t nodes_count = prefab->second.nodesCount();
+        game_objects.reserve(game_objects.size() + placements.size());
+
+        for (std::size_t i = 0; i < entities.size(); i += nodes_count)
+        {
+            game_objects.push_back(GameObject(entities[i]));
+        }
+    }
+
+    void Scene::instantiate(World & world, const std::string & object, const std::vector<PrefabPlacement> & placements, std::vector<entityx::Entity> & entities)
+    {
+        auto prefab = m_prefabs.find(object);
+
+        if (prefab == m_prefabs.end())
+        {
+            return;
+        }
+
+        World::Scope scope(world);
+        prefab->second.instantiate(world.entities(), world.events(), placements, entities);
+    }
 }
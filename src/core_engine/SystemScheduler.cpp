@@ -0,0 +1,198 @@
+#include "core_engine/SystemScheduler.h"
+#include "framework/utilities/JobSystem.h"
+#include "framework/utilities/Profiler.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace Vertex
+{
+    namespace
+    {
+        /* Set while the thread updates a system that may overlap others */
+        thread_local bool t_is_updating_shared_system = false;
+    }
+
+    bool SystemAccess::conflictsWith(const SystemAccess & other) const
+    {
+        if (m_is_exclusive || other.m_is_exclusive)
+        {
+            return true;
+        }
+
+        /* Main thread systems are serialized anyway */
+        if (m_is_main_thread && other.m_is_main_thread)
+        {
+            return true;
+        }
+
+        return (m_writes & (other.m_reads | other.m_writes)).any() ||
+               (other.m_writes & m_reads).any();
+    }
+
+    SystemScheduler::SystemScheduler()
+        : m_pending_nodes(0),
+          m_dt(0.0),
+          m_is_built(false)
+    {
+    }
+
+    SystemScheduler::~SystemScheduler()
+    {
+    }
+
+    SystemAccess & SystemScheduler::add(const char * name, const UpdateFunction & update, Stage stage)
+    {
+        std::unique_ptr<Node> node(new Node());
+        node->m_name = name;
+        node->m_update = update;
+        node->m_stage = stage;
+        node->m_predecessors_count = 0;
+        node->m_remaining_predecessors = 0;
+
+        m_nodes.push_back(std::move(node));
+        m_is_built = false;
+
+        return m_nodes.back()->m_access;
+    }
+
+    void SystemScheduler::build()
+    {
+        std::stable_sort(m_nodes.begin(), m_nodes.end(), [](const std::unique_ptr<Node> & a, const std::unique_ptr<Node> & b)
+        {
+            return a->m_stage < b->m_stage;
+        });
+
+        for (auto & node : m_nodes)
+        {
+            node->m_successors.clear();
+            node->m_predecessors_count = 0;
+        }
+
+        for (size_t i = 0; i < m_nodes.size(); ++i)
+        {
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (m_nodes[j]->m_access.conflictsWith(m_nodes[i]->m_access))
+                {
+                    m_nodes[j]->m_successors.push_back(i);
+                    ++m_nodes[i]->m_predecessors_count;
+                }
+            }
+        }
+
+        m_main_thread_queue.clear();
+        m_main_thread_queue.reserve(m_nodes.size());
+
+        m_is_built = true;
+    }
+
+    void SystemScheduler::update(entityx::TimeDelta dt)
+    {
+        if (!m_is_built)
+        {
+            build();
+        }
+
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        m_dt = dt;
+        m_pending_nodes = m_nodes.size();
+
+        for (auto & node : m_nodes)
+        {
+            node->m_remaining_predecessors.store(node->m_predecessors_count, std::memory_order_relaxed);
+        }
+
+        for (size_t i = 0; i < m_nodes.size(); ++i)
+        {
+            if (m_nodes[i]->m_predecessors_count == 0)
+            {
+                dispatch(i);
+            }
+        }
+
+        /* Run the main thread systems and help the workers until everything is done */
+        while (m_pending_nodes.load(std::memory_order_acquire) > 0)
+        {
+            size_t index;
+            if (popMainThreadNode(index))
+            {
+                run(index);
+            }
+            else if (!JobSystem::runOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool SystemScheduler::allowsStructuralChanges()
+    {
+        return !t_is_updating_shared_system;
+    }
+
+    void SystemScheduler::runJob(void * data, size_t index, size_t)
+    {
+        static_cast<SystemScheduler *>(data)->run(index);
+    }
+
+    void SystemScheduler::dispatch(size_t index)
+    {
+        if (m_nodes[index]->m_access.isMainThread())
+        {
+            std::lock_guard<std::mutex> lock(m_main_thread_mutex);
+            m_main_thread_queue.push_back(index);
+
+            return;
+        }
+
+        Job job = { &SystemScheduler::runJob, this, index, index + 1, nullptr };
+        JobSystem::submit(job);
+    }
+
+    void SystemScheduler::run(size_t index)
+    {
+        Node & node = *m_nodes[index];
+
+        {
+            VE_PROFILE_SCOPE(node.m_name);
+
+            /* Waiting for a parallel for may run another system on this thread */
+            const bool was_updating_shared_system = t_is_updating_shared_system;
+            t_is_updating_shared_system = !node.m_access.isExclusive();
+
+            node.m_update(m_dt);
+
+            t_is_updating_shared_system = was_updating_shared_system;
+        }
+
+        for (auto successor : node.m_successors)
+        {
+            if (m_nodes[successor]->m_remaining_predecessors.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                dispatch(successor);
+            }
+        }
+
+        m_pending_nodes.fetch_sub(1, std::memory_order_release);
+    }
+
+    bool SystemScheduler::popMainThreadNode(size_t & index)
+    {
+        std::lock_guard<std::mutex> lock(m_main_thread_mutex);
+
+        if (m_main_thread_queue.empty())
+        {
+            return false;
+        }
+
+        index = m_main_thread_queue.back();
+        m_main_thread_queue.pop_back();
+
+        return true;
+    }
+}
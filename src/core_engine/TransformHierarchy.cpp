@@ -0,0 +1,623 @@
+#include "core_engine/TransformHierarchy.h"
+#include "core_engine/ChangeVersion.h"
+#include "framework/utilities/AffineMath.h"
+#include "framework/utilities/JobSystem.h"
+
+#include <algorithm>
+
+namespace Vertex
+{
+    const uint32_t TransformHierarchy::INVALID_INDEX;
+    const uint32_t TransformHierarchy::PARALLEL_MIN_NODES;
+    const uint32_t TransformHierarchy::COMPACTION_MIN_REMOVED;
+
+    std::atomic<uint64_t> TransformHierarchy::m_hierarchies_count(0);
+
+    namespace
+    {
+        thread_local TransformHierarchy * t_current_hierarchy = nullptr;
+    }
+
+    TransformHierarchy::TransformHierarchy()
+        : m_id(++m_hierarchies_count),
+          m_scene_root(INVALID_INDEX),
+          m_removed_count(0),
+          m_is_layout_stale(false),
+          m_are_previous_states_stale(false)
+    {
+    }
+
+    TransformHierarchy::NodeId TransformHierarchy::create(const glm::vec3 & position, const glm::quat & orientation, const glm::vec3 & scale)
+    {
+        NodeId node;
+
+        if (!m_free_nodes.empty())
+        {
+            node = m_free_nodes.back();
+            m_free_nodes.pop_back();
+        }
+        else
+        {
+            node = NodeId(m_slots.size());
+
+            m_slots.push_back(INVALID_INDEX);
+            m_links.push_back(Links());
+        }
+
+        /* A new root at the end keeps the order valid */
+        m_slots[node] = uint32_t(m_nodes.size());
+        m_links[node] = Links();
+
+        m_nodes.push_back(node);
+        m_parents.push_back(INVALID_INDEX);
+        m_subtree_ends.push_back(uint32_t(m_nodes.size()));
+        m_flags.push_back(0);
+        m_versions.push_back(ChangeVersion::current());
+        m_positions.push_back(position);
+        m_orientations.push_back(orientation);
+        m_scales.push_back(scale);
+        m_world_matrices.push_back(glm::mat4(1.0f));
+        m_normal_matrices.push_back(glm::mat3(1.0f));
+        m_previous_world_matrices.push_back(glm::mat4(1.0f));
+        m_previous_positions.push_back(position);
+        m_previous_orientations.push_back(orientation);
+
+        markDirty(m_slots[node]);
+
+        return node;
+    }
+
+    TransformHierarchy & TransformHierarchy::current()
+    {
+        if (t_current_hierarchy)
+        {
+            return *t_current_hierarchy;
+        }
+
+        static TransformHierarchy s_hierarchy;
+        return s_hierarchy;
+    }
+
+    TransformHierarchy * TransformHierarchy::makeCurrent(TransformHierarchy * hierarchy)
+    {
+        TransformHierarchy * previous = t_current_hierarchy;
+        t_current_hierarchy = hierarchy;
+
+        return previous;
+    }
+
+    void TransformHierarchy::reserve(size_t count)
+    {
+        const size_t nodes_count = m_nodes.size() + count;
+        const size_t ids_count   = m_slots.size() + (count > m_free_nodes.size() ? count - m_free_nodes.size() : 0);
+
+        m_slots.reserve(ids_count);
+        m_links.reserve(ids_count);
+
+        m_nodes.reserve(nodes_count);
+        m_parents.reserve(nodes_count);
+        m_subtree_ends.reserve(nodes_count);
+        m_flags.reserve(nodes_count);
+        m_versions.reserve(nodes_count);
+        m_positions.reserve(nodes_count);
+        m_orientations.reserve(nodes_count);
+        m_scales.reserve(nodes_count);
+        m_world_matrices.reserve(nodes_count);
+        m_normal_matrices.reserve(nodes_count);
+        m_previous_world_matrices.reserve(nodes_count);
+        m_previous_positions.reserve(nodes_count);
+        m_previous_orientations.reserve(nodes_count);
+    }
+
+    void TransformHierarchy::destroy(NodeId node)
+    {
+        const NodeId   parent      = m_links[node].m_parent;
+        const uint32_t parent_slot = parent != INVALID_INDEX ? m_slots[parent] : INVALID_INDEX;
+
+        /* The children stay in their slots, which are inside the parent's range already */
+        while (m_links[node].m_first_child != INVALID_INDEX)
+        {
+            NodeId child = m_links[node].m_first_child;
+
+            unlink(child);
+            link(child, parent);
+
+            m_parents[m_slots[child]] = parent_slot;
+            markDirty(m_slots[child]);
+        }
+
+        unlink(node);
+
+        if (node == m_scene_root)
+        {
+            m_scene_root = INVALID_INDEX;
+        }
+
+        /* A tombstone until the next compaction */
+        removeSlot(m_slots[node]);
+
+        m_slots[node] = INVALID_INDEX;
+        m_free_nodes.push_back(node);
+    }
+
+    void TransformHierarchy::removeSlot(uint32_t slot)
+    {
+        m_flags[slot]        = REMOVED;
+        m_nodes[slot]        = INVALID_INDEX;
+        m_parents[slot]      = INVALID_INDEX;
+        m_subtree_ends[slot] = slot + 1;
+
+        ++m_removed_count;
+    }
+
+    bool TransformHierarchy::setParent(NodeId node, NodeId parent)
+    {
+        if (m_links[node].m_parent == parent)
+        {
+            return true;
+        }
+
+        for (NodeId ancestor = parent; ancestor != INVALID_INDEX; ancestor = m_links[ancestor].m_parent)
+        {
+            if (ancestor == node)
+            {
+                return false;
+            }
+        }
+
+        unlink(node);
+        link(node, parent);
+
+        /* The slots are sorted again from the links on the next update() */
+        m_is_layout_stale = true;
+        markDirty(m_slots[node]);
+
+        return true;
+    }
+
+    void TransformHierarchy::link(NodeId node, NodeId parent)
+    {
+        Links & links = m_links[node];
+
+        links.m_parent = parent;
+
+        if (parent == INVALID_INDEX)
+        {
+            return;
+        }
+
+        /* Appended, so children keep the order they were attached in */
+        Links & parent_links = m_links[parent];
+
+        links.m_previous_sibling = parent_links.m_last_child;
+
+        if (parent_links.m_last_child != INVALID_INDEX)
+        {
+            m_links[parent_links.m_last_child].m_next_sibling = node;
+        }
+        else
+        {
+            parent_links.m_first_child = node;
+        }
+
+        parent_links.m_last_child = node;
+    }
+
+    void TransformHierarchy::unlink(NodeId node)
+    {
+        Links & links = m_links[node];
+
+        if (links.m_parent != INVALID_INDEX)
+        {
+            Links & parent_links = m_links[links.m_parent];
+
+            if (links.m_previous_sibling != INVALID_INDEX)
+            {
+                m_links[links.m_previous_sibling].m_next_sibling = links.m_next_sibling;
+            }
+            else
+            {
+                parent_links.m_first_child = links.m_next_sibling;
+            }
+
+            if (links.m_next_sibling != INVALID_INDEX)
+            {
+                m_links[links.m_next_sibling].m_previous_sibling = links.m_previous_sibling;
+            }
+            else
+            {
+                parent_links.m_last_child = links.m_previous_sibling;
+            }
+        }
+
+        links.m_parent           = INVALID_INDEX;
+        links.m_previous_sibling = INVALID_INDEX;
+        links.m_next_sibling     = INVALID_INDEX;
+    }
+
+    void TransformHierarchy::setPosition(NodeId node, const glm::vec3 & position)
+    {
+        uint32_t slot = m_slots[node];
+
+        m_positions[slot] = position;
+        markDirty(slot);
+    }
+
+    void TransformHierarchy::setOrientation(NodeId node, const glm::quat & orientation)
+    {
+        uint32_t slot = m_slots[node];
+
+        m_orientations[slot] = orientation;
+        markDirty(slot);
+    }
+
+    void TransformHierarchy::setScale(NodeId node, const glm::vec3 & scale)
+    {
+        uint32_t slot = m_slots[node];
+
+        m_scales[slot] = scale;
+        markDirty(slot);
+    }
+
+    void TransformHierarchy::resetInterpolation(NodeId node)
+    {
+        uint32_t slot = m_slots[node];
+
+        m_previous_positions[slot]    = m_positions[slot];
+        m_previous_orientations[slot] = m_orientations[slot];
+        m_flags[slot] &= uint8_t(~HAS_WORLD_MATRIX);
+
+        markDirty(slot);
+    }
+
+    void TransformHierarchy::update()
+    {
+        /*
+         * Reparented nodes are sorted once per update, however many of them moved. Every removal
+         * leaves a tombstone, they're dropped once they're a quarter of the slots
+         */
+        if (m_is_layout_stale || (m_removed_count >= COMPACTION_MIN_REMOVED && m_removed_count * 4 >= m_nodes.size()))
+        {
+            /* The recorded slots are stale after the reorder */
+            m_are_previous_states_stale |= !m_moved_ranges.empty();
+            m_moved_ranges.clear();
+
+            reorder();
+        }
+
+        m_dirty_slots.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(m_dirty_lists_mutex);
+
+            for (auto & dirty_list : m_dirty_lists)
+            {
+                for (NodeId node : dirty_list->m_nodes)
+                {
+                    /* Destroyed after it was changed */
+                    if (m_slots[node] != INVALID_INDEX)
+                    {
+                        m_dirty_slots.push_back(m_slots[node]);
+                    }
+                }
+
+                dirty_list->m_nodes.clear();
+            }
+        }
+
+        /* A dirty node inside a dirty subtree is updated with the subtree */
+        std::sort(m_dirty_slots.begin(), m_dirty_slots.end());
+
+        m_dirty_ranges.clear();
+
+        uint32_t updated_end = 0;
+        uint32_t nodes_count = 0;
+
+        for (uint32_t slot : m_dirty_slots)
+        {
+            if (slot >= updated_end)
+            {
+                updated_end = m_subtree_ends[slot];
+                nodes_count += updated_end - slot;
+
+                Range range = { slot, updated_end };
+                m_dirty_ranges.push_back(range);
+            }
+        }
+
+        /* Without storePreviousStates() calls the ranges would only pile up */
+        if (m_moved_ranges.size() + m_dirty_ranges.size() > m_nodes.size())
+        {
+            m_are_previous_states_stale = true;
+            m_moved_ranges.clear();
+        }
+        else if (!m_are_previous_states_stale)
+        {
+            m_moved_ranges.insert(m_moved_ranges.end(), m_dirty_ranges.begin(), m_dirty_ranges.end());
+        }
+
+        if (nodes_count < PARALLEL_MIN_NODES || JobSystem::getWorkersCount() == 0)
+        {
+            for (const Range & range : m_dirty_ranges)
+            {
+                updateRange(range.m_begin, range.m_end);
+            }
+
+            return;
+        }
+
+        /* A few jobs per thread, so the stealing can even out the load */
+        updateParallel(std::max(nodes_count / (JobSystem::getThreadsCount() * 4), 1u));
+    }
+
+    void TransformHierarchy::updateParallel(uint32_t target_size)
+    {
+        m_job_ranges.clear();
+
+        /*
+         * Children of an updated node are independent of each other - a range too large for
+         * one job has its root updated here and its child subtrees are split further.
+         */
+        while (!m_dirty_ranges.empty())
+        {
+            Range range = m_dirty_ranges.back();
+            m_dirty_ranges.pop_back();
+
+            if (range.m_end - range.m_begin <= target_size)
+            {
+                m_job_ranges.push_back(range);
+                continue;
+            }
+
+            updateRange(range.m_begin, range.m_begin + 1);
+
+            for (uint32_t child = range.m_begin + 1; child < range.m_end; child = m_subtree_ends[child])
+            {
+                Range child_range = { child, m_subtree_ends[child] };
+                m_dirty_ranges.push_back(child_range);
+            }
+        }
+
+        /* Neighbouring ranges share cache lines, so a job takes consecutive ones */
+        std::sort(m_job_ranges.begin(), m_job_ranges.end(), [](const Range & lhs, const Range & rhs)
+        {
+            return lhs.m_begin < rhs.m_begin;
+        });
+
+        m_jobs.clear();
+
+        uint32_t job_size = target_size;
+
+        for (uint32_t i = 0; i < uint32_t(m_job_ranges.size()); ++i)
+        {
+            if (job_size >= target_size)
+            {
+                Range job = { i, i };
+                m_jobs.push_back(job);
+                job_size = 0;
+            }
+
+            m_jobs.back().m_end = i + 1;
+            job_size += m_job_ranges[i].m_end - m_job_ranges[i].m_begin;
+        }
+
+        JobSystem::parallelFor(0, m_jobs.size(), [this](std::size_t job)
+        {
+            for (uint32_t i = m_jobs[job].m_begin; i < m_jobs[job].m_end; ++i)
+            {
+                updateRange(m_job_ranges[i].m_begin, m_job_ranges[i].m_end);
+            }
+        }, 1);
+    }
+
+    void TransformHierarchy::updateRange(uint32_t begin, uint32_t end)
+    {
+        const uint32_t version = ChangeVersion::current();
+
+        for (uint32_t slot = begin; slot < end; ++slot)
+        {
+            uint8_t  flags  = m_flags[slot];
+            uint32_t parent = m_parents[slot];
+
+            if (flags & REMOVED)
+            {
+                continue;
+            }
+
+            /* Baked - its children use the frozen world matrix */
+            if ((flags & (STATIC | BAKED)) == (STATIC | BAKED))
+            {
+                m_flags[slot] = uint8_t(flags & ~DIRTY);
+                continue;
+            }
+
+            glm::mat4 local = AffineMath::composeTRS(m_positions[slot], m_orientations[slot], m_scales[slot]);
+            glm::mat4 & world = m_world_matrices[slot];
+
+            world = parent != INVALID_INDEX ? AffineMath::multiply(m_world_matrices[parent], local) : local;
+
+            bool is_uniform_scale = AffineMath::isUniformScale(m_scales[slot]) &&
+                                    (parent == INVALID_INDEX || (m_flags[parent] & UNIFORM_SCALE));
+
+            m_normal_matrices[slot] = is_uniform_scale ? AffineMath::normalMatrixUniform(world) : AffineMath::normalMatrix(world);
+
+            /* Nothing to interpolate from yet */
+            if (!(flags & HAS_WORLD_MATRIX))
+            {
+                m_previous_world_matrices[slot] = world;
+            }
+
+            m_flags[slot] = uint8_t((flags & ~(DIRTY | UNIFORM_SCALE)) | HAS_WORLD_MATRIX | (is_uniform_scale ? UNIFORM_SCALE : 0));
+            m_versions[slot] = version;
+
+            if (flags & STATIC)
+            {
+                m_flags[slot] |= BAKED;
+            }
+        }
+    }
+
+    void TransformHierarchy::storePreviousStates()
+    {
+        if (m_are_previous_states_stale)
+        {
+            m_previous_world_matrices = m_world_matrices;
+            m_previous_positions      = m_positions;
+            m_previous_orientations   = m_orientations;
+
+            m_are_previous_states_stale = false;
+            return;
+        }
+
+        /* Poses of the nodes that did not move are equal to the previous ones already */
+        for (const Range & range : m_moved_ranges)
+        {
+            std::copy(m_world_matrices.begin() + range.m_begin, m_world_matrices.begin() + range.m_end, m_previous_world_matrices.begin() + range.m_begin);
+            std::copy(m_positions.begin()      + range.m_begin, m_positions.begin()      + range.m_end, m_previous_positions.begin()      + range.m_begin);
+            std::copy(m_orientations.begin()   + range.m_begin, m_orientations.begin()   + range.m_end, m_previous_orientations.begin()   + range.m_begin);
+        }
+
+        m_moved_ranges.clear();
+    }
+
+    void TransformHierarchy::setStatic(NodeId node, bool is_static)
+    {
+        uint32_t slot = m_slots[node];
+
+        if (isStatic(node) == is_static)
+        {
+            return;
+        }
+
+        /* Baked or unfrozen with the current pose on the next update */
+        m_flags[slot] = uint8_t(is_static ? (m_flags[slot] | STATIC) : (m_flags[slot] & ~(STATIC | BAKED)));
+        markDirty(slot);
+    }
+
+    void TransformHierarchy::markDirty(uint32_t slot)
+    {
+        m_versions[slot] = ChangeVersion::current();
+
+        if (!(m_flags[slot] & DIRTY))
+        {
+            m_flags[slot] |= DIRTY;
+            getDirtyList().m_nodes.push_back(m_nodes[slot]);
+        }
+    }
+
+    TransformHierarchy::DirtyList & TransformHierarchy::getDirtyList()
+    {
+        struct CachedList
+        {
+            uint64_t    m_hierarchy_id;
+            DirtyList * m_list;
+        };
+
+        static thread_local CachedList cached_list = { 0, nullptr };
+
+        if (cached_list.m_hierarchy_id != m_id)
+        {
+            std::lock_guard<std::mutex> lock(m_dirty_lists_mutex);
+
+            std::thread::id thread_id = std::this_thread::get_id();
+            DirtyList * list = nullptr;
+
+            for (auto & dirty_list : m_dirty_lists)
+            {
+                if (dirty_list->m_thread_id == thread_id)
+                {
+                    list = dirty_list.get();
+                }
+            }
+
+            if (!list)
+            {
+                m_dirty_lists.emplace_back(new DirtyList());
+                list = m_dirty_lists.back().get();
+                list->m_thread_id = thread_id;
+            }
+
+            cached_list.m_hierarchy_id = m_id;
+            cached_list.m_list         = list;
+        }
+
+        return *cached_list.m_list;
+    }
+
+    void TransformHierarchy::reorder()
+    {
+        const uint32_t slots_count = uint32_t(m_nodes.size());
+
+        /* Depth first from every root, in the current order of the roots - a subtree is a contiguous range */
+        m_order.clear();
+        m_stack.clear();
+
+        for (uint32_t root = 0; root < slots_count; ++root)
+        {
+            NodeId root_node = m_nodes[root];
+
+            if (root_node == INVALID_INDEX || m_links[root_node].m_parent != INVALID_INDEX)
+            {
+                continue;
+            }
+
+            m_stack.push_back(root_node);
+
+            while (!m_stack.empty())
+            {
+                NodeId node = m_stack.back();
+                m_stack.pop_back();
+
+                m_order.push_back(m_slots[node]);
+
+                for (NodeId child = m_links[node].m_last_child; child != INVALID_INDEX; child = m_links[child].m_previous_sibling)
+                {
+                    m_stack.push_back(child);
+                }
+            }
+        }
+
+        permute(m_nodes,                   m_order);
+        permute(m_flags,                   m_order);
+        permute(m_versions,                m_order);
+        permute(m_positions,               m_order);
+        permute(m_orientations,            m_order);
+        permute(m_scales,                  m_order);
+        permute(m_world_matrices,          m_order);
+        permute(m_normal_matrices,         m_order);
+        permute(m_previous_world_matrices, m_order);
+        permute(m_previous_positions,      m_order);
+        permute(m_previous_orientations,   m_order);
+
+        const uint32_t nodes_count = uint32_t(m_nodes.size());
+
+        for (uint32_t slot = 0; slot < nodes_count; ++slot)
+        {
+            m_slots[m_nodes[slot]] = slot;
+        }
+
+        /* Parents come before their children, so the sizes of the subtrees add up from the end */
+        m_parents.resize(nodes_count);
+        m_subtree_ends.resize(nodes_count);
+
+        for (uint32_t slot = 0; slot < nodes_count; ++slot)
+        {
+            NodeId parent = m_links[m_nodes[slot]].m_parent;
+
+            m_parents[slot]      = parent != INVALID_INDEX ? m_slots[parent] : INVALID_INDEX;
+            m_subtree_ends[slot] = slot + 1;
+        }
+
+        m_removed_count   = 0;
+        m_is_layout_stale = false;
+
+        for (uint32_t slot = nodes_count; slot-- > 0;)
+        {
+            if (m_parents[slot] != INVALID_INDEX)
+            {
+                uint32_t & parent_end = m_subtree_ends[m_parents[slot]];
+                parent_end = std::max(parent_end, m_subtree_ends[slot]);
+            }
+        }
+    }
+}
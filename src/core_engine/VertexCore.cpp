@@ -1,11 +1,23 @@
 #include "core_engine/VertexCore.h"
+#include "core_engine/AsyncTasks.h"
 #include "core_engine/CoreServices.h"
 #include "core_systems/SceneGraphSystem.h"
 #include "core_systems/ConsoleSystem.h"
 #include "core_systems/CameraSystem.h"
 #include "core_systems/GUISystem.h"
 #include "core_systems/RenderingSystem.h"
+#include "core_systems/NullGUISystem.h"
+#include "core_systems/NullRenderingSystem.h"
 #include "core_systems/FreePoseSystem.h"
+#include "core_components/CameraComponent.h"
+#include "core_components/FreeLookComponent.h"
+#include "core_components/FreeMoveComponent.h"
+#include "core_components/TransformComponent.h"
+#include "framework/gui/GUI.h"
+#include "framework/utilities/AllocationCounter.h"
+#include "framework/utilities/FrameAllocator.h"
+#include "framework/utilities/JobSystem.h"
+#include "framework/utilities/Profiler.h"
 #include "framework/utilities/Timer.h"
 #include "framework/window/Input.h"
 #include "framework/window/Window.h"
@@ -14,51 +26,170 @@ namespace Vertex
 {
     VertexCore::VertexCore(const std::shared_ptr<BaseGame> & game, double framerate)
         : m_users_systems(entities, events), 
+          m_frame_pacer(1.0 / framerate),
           m_game(game),
           m_frame_time(1.0 / framerate),
           m_fps(0),
           m_fpsToReturn(0),
-          m_is_running(false)
+          m_worker_threads_count(0),
+          m_render_snapshots_count(2),
+          m_is_pipelined_rendering(false),
+          m_is_headless(false),
+          m_is_uncapped(false),
+          m_is_interpolated(false),
+          m_is_replaying_input(false),
+          m_is_input_replay_finished(false),
+          m_is_running(false),
+          m_last_render_time(0.0),
+          m_last_swap_time(0.0)
     {
+        auto hardware_threads = std::thread::hardware_concurrency();
+        m_worker_threads_count = hardware_threads > 1 ? hardware_threads - 1 : 0;
     }
 
     VertexCore::~VertexCore()
     {
+        AsyncTasks::shutdown();
+        JobSystem::shutdown();
     }
 
     void VertexCore::init(unsigned int width, unsigned int height, const std::string & title)
     {
+        Profiler::setThreadName("Main");
+
         /* Init window */
-        Window::createWindow(width, height, title);
+        if (m_is_headless)
+        {
+            Window::createHeadless(width, height, title);
+        }
+        else
+        {
+            Window::createWindow(width, height, title);
+        }
 
         /* Add core systems - do not forget to update them! */
         //systems.add<AudioSystem>();
         systems.add<SceneGraphSystem>();
         systems.add<ConsoleSystem>();
         systems.add<CameraSystem>();
-        systems.add<GUISystem>();
-        systems.add<RenderingSystem>();
+        if (m_is_headless)
+        {
+            /* Registered as their base classes, so the rest of the engine doesn't notice */
+            systems.add(std::shared_ptr<GUISystem>(new NullGUISystem()));
+            systems.add(std::shared_ptr<RenderingSystem>(new NullRenderingSystem()));
+        }
+        else
+        {
+            systems.add<GUISystem>();
+            systems.add<RenderingSystem>();
+        }
         systems.add<FreePoseSystem>();
         systems.configure();
 
         /* Configure user's systems */
         m_users_systems.configure();
 
+        /* Schedule core systems - they are updated before the user's ones in case of conflicts */
+        m_scheduler.add("ConsoleSystem", [this](entityx::TimeDelta dt) { systems.update<ConsoleSystem>(dt); }, SystemScheduler::CORE_STAGE)
+                   .none();
+        m_scheduler.add("FreePoseSystem", [this](entityx::TimeDelta dt) { systems.update<FreePoseSystem>(dt); }, SystemScheduler::CORE_STAGE)
+                   .reads<FreeMoveComponent, FreeLookComponent>().writes<TransformComponent>().mainThread();
+        m_scheduler.add("CameraSystem", [this](entityx::TimeDelta dt) { systems.update<CameraSystem>(dt); }, SystemScheduler::CORE_STAGE)
+                   .reads<TransformComponent>().writes<CameraComponent>();
+        m_scheduler.add("SceneGraphSystem", [this](entityx::TimeDelta dt) { systems.update<SceneGraphSystem>(dt); }, SystemScheduler::CORE_STAGE)
+                   .writes<TransformComponent>();
+        m_scheduler.build();
+
+        JobSystem::init(m_worker_threads_count);
+        AsyncTasks::init();
+
         /* Set up Core Services */
         CoreServices::provide(this);
         CoreServices::provide(systems.system<RenderingSystem>().get());
 
         /* Register game's methods */
         systems.system<GUISystem>()->registerGame(m_game);
+        systems.system<GUISystem>()->registerTelemetry(&m_telemetry, &m_fpsToReturn);
 
         m_game->init();
     }
 
+    void VertexCore::setWorkerThreadsCount(unsigned int count)
+    {
+        m_worker_threads_count = count;
+    }
+
+    void VertexCore::setPipelinedRendering(bool enabled, unsigned int snapshots_count)
+    {
+        m_is_pipelined_rendering = enabled;
+        m_render_snapshots_count = snapshots_count;
+    }
+
+    void VertexCore::runOnRenderThread(const std::function<void()> & task)
+    {
+        m_render_pipeline.runOnRenderThread(task);
+    }
+
+    void VertexCore::setHeadless(bool enabled)
+    {
+        m_is_headless = enabled;
+    }
+
+    void VertexCore::setUncapped(bool enabled)
+    {
+        m_is_uncapped = enabled;
+    }
+
+    void VertexCore::setInterpolation(bool enabled)
+    {
+        m_is_interpolated = enabled;
+    }
+
+    void VertexCore::step(unsigned int ticks_count)
+    {
+        for (unsigned int i = 0; i < ticks_count; ++i)
+        {
+            FrameAllocator::beginFrame();
+            tick();
+
+            /* Every step is a frame of its own here */
+            AsyncTasks::update();
+
+            if (m_is_headless)
+            {
+                systems.update<RenderingSystem>(m_frame_time);
+            }
+        }
+    }
+
+    bool VertexCore::recordInput(const std::string & filename)
+    {
+        return Input::startRecording(filename);
+    }
+
+    bool VertexCore::replayInput(const std::string & filename)
+    {
+        m_is_replaying_input       = Input::startReplay(filename);
+        m_is_input_replay_finished = false;
+
+        return m_is_replaying_input;
+    }
+
     unsigned int VertexCore::getFPS() const
     {
         return m_fpsToReturn;
     }
 
+    void VertexCore::setPerformanceHUDVisible(bool visible)
+    {
+        systems.system<GUISystem>()->setPerformanceHUDVisible(visible);
+    }
+
+    bool VertexCore::isPerformanceHUDVisible()
+    {
+        return systems.system<GUISystem>()->isPerformanceHUDVisible();
+    }
+
     void VertexCore::start()
     {
         if (m_is_running)
@@ -79,87 +210,195 @@ namespace Vertex
         m_is_running = false;
     }
 
+    void VertexCore::tick()
+    {
+        VE_PROFILE_SCOPE("Tick");
+
+        if (m_is_interpolated && !m_is_uncapped)
+        {
+            SceneGraphSystem::storePreviousStates();
+        }
+
+        /* Sync point - the events posted since the last one reach the systems before they update */
+        m_event_channels.dispatch(events);
+
+        Input::beginTick();
+        m_game->input(float(m_frame_time));
+        updateSystems(m_frame_time);
+        Input::update();
+    }
+
     void VertexCore::updateSystems(entityx::TimeDelta dt)
     {
         /** 
-         * Update core engine systems in specific order 
+         * Core engine systems and user's systems are updated by the scheduler,
+         * see init() for the order of the core ones
          */
         //systems.update<AudioSystem>();
-        systems.update<ConsoleSystem>(dt);
-        systems.update<FreePoseSystem>(dt);
-        systems.update<CameraSystem>(dt);
-        systems.update<SceneGraphSystem>(dt);
-
-        m_users_systems.update_all(dt);
+        m_scheduler.update(dt);
     }
 
     void VertexCore::updateRenderingSystems(entityx::TimeDelta dt)
     {
+        VE_PROFILE_SCOPE("Rendering Systems");
+
+        if (m_render_pipeline.isRunning())
+        {
+            /* Only copy the frame, the render thread takes care of the rest */
+            RenderSnapshot & snapshot = m_render_pipeline.beginSnapshot();
+
+            systems.system<RenderingSystem>()->extract(entities, snapshot);
+            systems.system<GUISystem>()->record(dt, snapshot.m_gui);
+
+            m_render_pipeline.submitSnapshot();
+            Window::pollEvents();
+
+            return;
+        }
+
         systems.update<RenderingSystem>(dt);
         systems.update<GUISystem>(dt);
+
+        VE_PROFILE_SCOPE("Swap Buffers");
+        double swap_start = Timer::getTime();
+
+        Window::endFrame();
+        m_last_swap_time = Timer::getTime() - swap_start;
+    }
+
+    void VertexCore::renderSnapshot(RenderSnapshot & snapshot)
+    {
+        double render_start = Timer::getTime();
+
+        CoreServices::getRenderer()->render(snapshot);
+        GUI::render(snapshot.m_gui);
+
+        VE_PROFILE_SCOPE("Swap Buffers");
+        double swap_start = Timer::getTime();
+
+        Window::swapBuffers();
+
+        m_last_render_time = swap_start - render_start;
+        m_last_swap_time   = Timer::getTime() - swap_start;
+    }
+
+    void VertexCore::recordFrame(unsigned int steps, double frame_time, double sim_time, double render_time, uint64_t heap_allocations)
+    {
+        FrameSample sample;
+        sample.m_frame_ms  = float(frame_time * 1000.0);
+        sample.m_sim_ms    = float(sim_time * 1000.0);
+        sample.m_sim_steps = steps;
+        sample.m_heap_allocations = unsigned(heap_allocations);
+
+        if (m_is_headless)
+        {
+            sample.m_render_ms = 0.0f;
+            sample.m_swap_ms   = 0.0f;
+        }
+        else if (m_render_pipeline.isRunning())
+        {
+            sample.m_render_ms = float(m_last_render_time * 1000.0);
+            sample.m_swap_ms   = float(m_last_swap_time * 1000.0);
+        }
+        else
+        {
+            sample.m_swap_ms   = float(m_last_swap_time * 1000.0);
+            sample.m_render_ms = float(render_time * 1000.0) - sample.m_swap_ms;
+        }
+
+        m_telemetry.push(sample);
     }
 
     void VertexCore::run()
     {
         m_is_running = true;
 
-        int frames = 0;
-        double frame_counter = 0.0;
-
-        double last_time = Timer::getTime();
-        double unprocessed_time = 0.0;
+        if (m_is_pipelined_rendering && !m_is_headless)
+        {
+            m_render_pipeline.start(events, m_render_snapshots_count, [this](RenderSnapshot & snapshot)
+            {
+                renderSnapshot(snapshot);
+            });
+        }
 
-        double start_time = 0.0;
-        double passed_time = 0.0;
+        m_frame_pacer.reset();
 
-        bool should_render = false;
+        double last_frame_start = Timer::getTime();
+        double fps_counter_start = last_frame_start;
 
         while (m_is_running)
         {
-            should_render = false;
-
-            start_time = Timer::getTime();
-            passed_time = start_time - last_time;
+            /* Uncapped: exactly one step per iteration, however long it took */
+            unsigned int steps = 1;
 
-            last_time = start_time;
+            if (!m_is_uncapped)
+            {
+                VE_PROFILE_SCOPE("Frame Pacing");
 
-            unprocessed_time += passed_time;
-            frame_counter += passed_time;
+                /* With interpolation there can be frames without any step */
+                steps = m_is_interpolated ? m_frame_pacer.waitForFrame() : m_frame_pacer.waitForSteps();
+            }
 
-            while (unprocessed_time > m_frame_time)
+            if (Window::isCloseRequested())
             {
-                should_render = true;
+                stop();
+            }
+
+            double frame_start = Timer::getTime();
+            uint64_t allocations_start = AllocationCounter::getCount();
 
-                unprocessed_time -= m_frame_time;
+            FrameAllocator::beginFrame();
 
-                if (Window::isCloseRequested())
+            for (unsigned int i = 0; i < steps; ++i)
+            {
+                tick();
+
+                /* The remaining steps would run on live input */
+                if (m_is_replaying_input && !Input::isReplaying())
                 {
+                    m_is_replaying_input       = false;
+                    m_is_input_replay_finished = true;
                     stop();
+                    break;
                 }
+            }
 
-                m_game->input(float(m_frame_time));
-                updateSystems(m_frame_time);
-                Input::update();
+            double sim_end = Timer::getTime();
 
-                if (frame_counter >= 1.0)
-                {
-                    #ifdef _DEBUG
-                    //std::cout << 1000.0 / (double)frames << std::endl;
-                    #endif
+            /* Sync point - e.g. the events of the jobs started by the steps, before the frame is extracted */
+            m_event_channels.dispatch(events);
+            AsyncTasks::update();
 
-                    frames = 0;
-                    frame_counter = 0;
+            if (!m_is_headless)
+            {
+                if (m_is_interpolated && !m_is_uncapped)
+                {
+                    systems.system<RenderingSystem>()->setInterpolationAlpha(float(m_frame_pacer.getInterpolationAlpha()));
                 }
-            }
 
-            if (should_render)
-            {
                 /* Update Rendering and GUI systems */
                 updateRenderingSystems(m_frame_time);
+            }
+            else
+            {
+                /* Only drains what the renderer queued, nothing is drawn */
+                systems.update<RenderingSystem>(m_frame_time);
+            }
 
-                Window::endFrame();
-                frames++;
+            recordFrame(steps, frame_start - last_frame_start, sim_end - frame_start, Timer::getTime() - sim_end,
+                        AllocationCounter::getCount() - allocations_start);
+            last_frame_start = frame_start;
+
+            ++m_fps;
+            if (frame_start - fps_counter_start >= 1.0)
+            {
+                m_fpsToReturn = m_fps;
+                m_fps = 0;
+                fps_counter_start = frame_start;
             }
         }
+
+        m_render_pipeline.stop();
+        Input::stopRecording();
     }
 }
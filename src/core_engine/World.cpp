@@ -0,0 +1,78 @@
+#include "core_engine/World.h"
+#include "framework/utilities/JobSystem.h"
+#include "framework/utilities/Profiler.h"
+
+namespace Vertex
+{
+    namespace
+    {
+        thread_local World * t_current_world = nullptr;
+    }
+
+    World::World()
+    {
+        Scope scope(*this);
+        m_root.reset(new TransformComponent());
+        m_root->makeSceneRoot();
+    }
+
+    World::~World()
+    {
+    }
+
+    void World::configure()
+    {
+        Scope scope(*this);
+        m_ecs.systems.configure();
+    }
+
+    void World::step(entityx::TimeDelta dt)
+    {
+        VE_PROFILE_SCOPE("World Step");
+
+        Scope scope(*this);
+
+        m_hierarchy.storePreviousStates();
+        m_ecs.systems.update_all(dt);
+        m_hierarchy.update();
+    }
+
+    void World::stepAll(const std::vector<World *> & worlds, entityx::TimeDelta dt)
+    {
+        JobSystem::parallelFor(0, worlds.size(), [&worlds, dt](std::size_t i)
+        {
+            worlds[i]->step(dt);
+        }, 1);
+    }
+
+    World * World::current()
+    {
+        return t_current_world;
+    }
+
+    World::Scope::Scope(World & world)
+        : m_previous_world    (t_current_world),
+          m_previous_hierarchy(TransformHierarchy::makeCurrent(&world.m_hierarchy))
+    {
+        t_current_world = &world;
+    }
+
+    World::Scope::~Scope()
+    {
+        t_current_world = m_previous_world;
+        TransformHierarchy::makeCurrent(m_previous_hierarchy);
+    }
+
+    World::EngineScope::EngineScope()
+        : m_previous_world    (t_current_world),
+          m_previous_hierarchy(TransformHierarchy::makeCurrent(nullptr))
+    {
+        t_current_world = nullptr;
+    }
+
+    World::EngineScope::~EngineScope()
+    {
+        t_current_world = m_previous_world;
+        TransformHierarchy::makeCurrent(m_previous_hierarchy);
+    }
+}
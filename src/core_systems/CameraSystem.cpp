@@ -1,22 +1,27 @@
 ﻿#include "core_systems/CameraSystem.h"
 #include "core_components/CameraComponent.h"
 #include "core_components/TransformComponent.h"
+#include "framework/utilities/AffineMath.h"
 
 namespace Vertex
 {
     void CameraSystem::configure(entityx::EntityManager& entities, entityx::EventManager& events)
     {
+        m_cameras.configure(entities, events);
     }
 
     void CameraSystem::update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt)
     {
-        entities.each<CameraComponent, TransformComponent>(
-        [this](entityx::Entity entity, CameraComponent & camera, TransformComponent & transform)
+        /* Only the cameras that moved */
+        m_cameras.eachChanged<TransformComponent>(m_transforms_version,
+        [](entityx::Entity entity, CameraComponent & camera, TransformComponent & transform)
         {
-            glm::mat4 R = glm::mat4_cast(transform.orientation());
-            glm::mat4 T = glm::translate(glm::mat4(1.0f), -transform.position());
-
-            camera.m_view = R * T;
+            camera.m_view = viewMatrix(transform.orientation(), transform.position());
         });
     }
+
+    glm::mat4 CameraSystem::viewMatrix(const glm::quat & orientation, const glm::vec3 & position)
+    {
+        return AffineMath::composeRT(orientation, -position);
+    }
 }
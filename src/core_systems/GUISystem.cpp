@@ -1,5 +1,6 @@
 ﻿#include "core_systems/GUISystem.h"
 #include "framework/gui/GUI.h"
+#include "framework/utilities/Profiler.h"
 
 namespace Vertex
 {
@@ -9,15 +10,46 @@ namespace Vertex
 
     void GUISystem::update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt)
     {
+        VE_PROFILE_SCOPE("GUISystem");
+
         GUI::prepare();
 
         m_game->onGUI(dt);
+        drawPerformanceHUD();
 
         GUI::render();
     }
 
+    void GUISystem::record(entityx::TimeDelta dt, GUIDrawData & draw_data)
+    {
+        VE_PROFILE_SCOPE("GUISystem");
+
+        GUI::prepare();
+
+        m_game->onGUI(dt);
+        drawPerformanceHUD();
+
+        GUI::endFrame(draw_data);
+    }
+
     void GUISystem::registerGame(const std::shared_ptr<BaseGame> & game)
     {
         m_game = game;
     }
+
+    void GUISystem::registerTelemetry(const FrameTelemetry * telemetry, const unsigned int * fps)
+    {
+        m_telemetry = telemetry;
+        m_fps       = fps;
+    }
+
+    void GUISystem::drawPerformanceHUD()
+    {
+        if (!m_is_performance_hud_visible || !m_telemetry)
+        {
+            return;
+        }
+
+        GUI::performanceHUD(*m_telemetry, m_fps ? *m_fps : 0);
+    }
 }
@@ -0,0 +1,8 @@
+﻿#include "core_systems/NullGUISystem.h"
+
+namespace Vertex
+{
+    void NullGUISystem::update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt)
+    {
+    }
+}
@@ -0,0 +1,17 @@
+﻿#include "core_systems/NullRenderingSystem.h"
+
+namespace Vertex
+{
+    void NullRenderingSystem::configure(entityx::EntityManager & entities, entityx::EventManager & events)
+    {
+        configureQueries(entities, events);
+
+        m_scene_ambient_color = glm::vec3(0.18f);
+    }
+
+    void NullRenderingSystem::update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt)
+    {
+        /* Nothing extracts the frames, the queued spawns and despawns would pile up otherwise */
+        skipFrame();
+    }
+}
@@ -1,41 +1,41 @@
 ﻿#include <core_systems/RenderingSystem.h>
 
 #include "core_engine/CoreAssetManager.h"
-#include "core_engine/CoreServices.h"
+#include "core_systems/CameraSystem.h"
 #include "framework/window/Window.h"
 #include "core_components/DirectionalLightComponent.h"
 #include "core_components/PointLightComponent.h"
 #include "core_components/SpotLightComponent.h"
+#include "framework/utilities/AffineMath.h"
 #include "framework/utilities/ShaderGlobals.h"
+#include "framework/rendering/GpuProfiler.h"
 
 namespace Vertex
 {
     bool         RenderingSystem::M_DEBUG_RENDERING    = false;
     unsigned int RenderingSystem::M_DEBUG_WINDOW_WIDTH = 0;
 
-    RenderingSystem::RenderingSystem() {}
+    RenderingSystem::RenderingSystem()
+        : m_proxies_version(0),
+          m_requested_width(0),
+          m_requested_height(0),
+          m_viewport_width(0),
+          m_viewport_height(0),
+          m_interpolation_alpha(1.0f)
+    {}
     
     RenderingSystem::~RenderingSystem() 
     {
-        m_opaque_queue.clear();
-        m_alpha_queue.clear();
-        m_enviro_static_queue.clear();
-        m_enviro_dynamic_queue.clear();
     }
 
     void RenderingSystem::configure(entityx::EntityManager & entities, entityx::EventManager & events)
     {
-        events.subscribe<entityx::ComponentAddedEvent<CameraComponent>>(*this);
-        events.subscribe<entityx::ComponentAddedEvent<ModelRendererComponent>>(*this);
-        events.subscribe<entityx::ComponentRemovedEvent<ModelRendererComponent>>(*this);
+        configureQueries(entities, events);
 
         CoreAssetManager::createTexture2D1x1("default_white",  glm::uvec4(255, 255, 255, 255));
         CoreAssetManager::createTexture2D1x1("default_black",  glm::uvec4(0,   0,   0,   255));
         CoreAssetManager::createTexture2D1x1("default_normal", glm::uvec4(128, 127, 254, 255));
 
-        m_opaque_queue.reserve(50);
-        m_alpha_queue.reserve(5);
-
         m_forward_ambient = CoreAssetManager::createShader("Forward-Ambient", "Forward-Light.vert", "Forward-Ambient.frag");
         m_forward_ambient->link();
 
@@ -84,6 +84,9 @@ namespace Vertex
         m_light_bcone = Model();
         m_light_bcone.genCone(1.1f, 1.1f, 12, 1);
 
+        m_requested_width  = m_viewport_width  = Window::getWidth();
+        m_requested_height = m_viewport_height = Window::getHeight();
+
         M_DEBUG_WINDOW_WIDTH = GLuint(Window::getWidth() / 5.0f);
         m_scene_ambient_color = glm::vec3(0.18f);
 
@@ -127,80 +130,232 @@ namespace Vertex
 
     void RenderingSystem::update(entityx::EntityManager & entities, entityx::EventManager & events, entityx::TimeDelta dt)
     {
-        //renderForward(entities);
-        renderDeferred(entities);
+        extract(entities, m_snapshot);
+        render(m_snapshot);
+    }
+
+    void RenderingSystem::extract(entityx::EntityManager & entities, RenderSnapshot & snapshot)
+    {
+        VE_PROFILE_SCOPE("Render Extract");
 
-        if (M_DEBUG_RENDERING)
+        flushQueries();
+
+        snapshot.clear();
+
+        snapshot.m_width               = m_requested_width;
+        snapshot.m_height              = m_requested_height;
+        snapshot.m_scene_ambient_color = m_scene_ambient_color;
+        snapshot.m_debug_rendering     = M_DEBUG_RENDERING;
+        snapshot.m_skybox              = m_default_skybox;
+
+        auto camera           = getCamera();
+        auto camera_transform = getCameraTransform();
+        float alpha           = m_interpolation_alpha;
+
+        snapshot.m_camera.m_view       = camera->m_view;
+        snapshot.m_camera.m_projection = camera->m_projection;
+        snapshot.m_camera.m_position   = camera_transform->interpolated_position(alpha);
+
+        if (alpha < 1.0f)
         {
-            //renderDebugLightsBoundingBoxes(entities);
-            renderDebug();
+            snapshot.m_camera.m_view = CameraSystem::viewMatrix(camera_transform->interpolated_orientation(alpha), snapshot.m_camera.m_position);
         }
+
+        snapshot.m_camera.m_view_projection = camera->m_projection * snapshot.m_camera.m_view;
+
+        updateProxies();
+
+        /* A linear scan of the proxies, only the movable ones read their transforms */
+        for (auto & proxy : m_proxies.proxies())
+        {
+            std::vector<RenderItem> * items = nullptr;
+
+            switch (proxy.m_queue)
+            {
+            case ModelRendererComponent::RenderQueue::RQ_OPAQUE:
+                items = &snapshot.m_opaque_items;
+                break;
+            case ModelRendererComponent::RenderQueue::RQ_ALPHA:
+                items = &snapshot.m_alpha_items;
+                break;
+            case ModelRendererComponent::RenderQueue::RQ_ENVIRO_MAPPING_STATIC:
+                items = &snapshot.m_enviro_static_items;
+                break;
+            case ModelRendererComponent::RenderQueue::RQ_ENVIRO_MAPPING_DYNAMIC:
+                continue;
+            }
+
+            items->push_back(proxy.m_item);
+
+            RenderItem & item = items->back();
+            item.m_meshes = proxy.m_model->sharedMeshes();
+
+            if (!proxy.m_item.m_is_static)
+            {
+                item.m_position = proxy.m_transform->interpolated_position(alpha);
+                proxy.m_transform->interpolate(alpha, item.m_world_matrix, item.m_normal_matrix);
+            }
+        }
+
+        m_directional_lights.each([&snapshot, alpha](entityx::Entity entity, DirectionalLightComponent & directional_light, TransformComponent & transform)
+        {
+            DirectionalLightData light;
+            light.m_color       = directional_light.m_color;
+            light.m_intensity   = directional_light.m_intensity;
+            light.m_direction   = transform.interpolated_direction(alpha);
+            light.m_shadow_info = directional_light.getShadowInfo();
+
+            snapshot.m_directional_lights.push_back(light);
+        });
+
+        m_point_lights.each([&snapshot, alpha](entityx::Entity entity, PointLightComponent & point_light, TransformComponent & transform)
+        {
+            PointLightData light;
+            light.m_color       = point_light.m_color;
+            light.m_intensity   = point_light.m_intensity;
+            light.m_attenuation = point_light.m_attenuation;
+            light.m_range       = point_light.m_range;
+            light.m_position    = transform.interpolated_position(alpha);
+            light.m_shadow_info = point_light.getShadowInfo();
+
+            snapshot.m_point_lights.push_back(light);
+        });
+
+        m_spot_lights.each([&snapshot, alpha](entityx::Entity entity, SpotLightComponent & spot_light, TransformComponent & transform)
+        {
+            SpotLightData light;
+            light.m_color       = spot_light.m_color;
+            light.m_intensity   = spot_light.m_intensity;
+            light.m_attenuation = spot_light.m_attenuation;
+            light.m_range       = spot_light.m_range;
+            light.m_position    = transform.interpolated_position(alpha);
+            light.m_direction   = transform.interpolated_direction(alpha);
+            light.m_orientation = transform.interpolated_orientation(alpha);
+            light.m_cutoff      = spot_light.getCutOffAngle();
+            light.m_shadow_info = spot_light.getShadowInfo();
+
+            snapshot.m_spot_lights.push_back(light);
+        });
+
+        /* Sort transparent objects back to front */
+        sortAlpha(snapshot);
     }
 
-    void RenderingSystem::receive(const entityx::ComponentAddedEvent<CameraComponent>& event)
+    void RenderingSystem::render(RenderSnapshot & snapshot)
     {
-        if (!m_main_camera)
+        GpuProfiler::beginFrame();
+        VE_PROFILE_GPU("Render");
+
+        if (snapshot.m_width != m_viewport_width || snapshot.m_height != m_viewport_height)
         {
-            m_main_camera = event.entity;
+            applyResize(snapshot.m_width, snapshot.m_height);
+        }
+
+        //renderForward(snapshot);
+        renderDeferred(snapshot);
+
+        if (snapshot.m_debug_rendering)
+        {
+            //renderDebugLightsBoundingBoxes(snapshot);
+            renderDebug();
         }
     }
 
-    void RenderingSystem::receive(const entityx::ComponentAddedEvent<ModelRendererComponent>& event)
+    void RenderingSystem::configureQueries(entityx::EntityManager & entities, entityx::EventManager & events)
     {
-        switch (event.component->getRenderQueue())
+        events.subscribe<entityx::ComponentAddedEvent<CameraComponent>>(*this);
+        events.subscribe<entityx::ComponentRemovedEvent<ModelRendererComponent>>(*this);
+        events.subscribe<entityx::ComponentRemovedEvent<TransformComponent>>(*this);
+
+        m_renderables.configure(entities, events);
+        m_directional_lights.configure(entities, events);
+        m_point_lights.configure(entities, events);
+        m_spot_lights.configure(entities, events);
+    }
+
+    RenderProxy RenderingSystem::makeProxy(entityx::Entity entity, ModelRendererComponent & renderer, const TransformComponent & transform)
+    {
+        RenderProxy proxy;
+        proxy.m_model     = &renderer.m_model;
+        proxy.m_transform = &transform;
+        proxy.m_queue     = renderer.getRenderQueue();
+        proxy.m_index     = entity.id().index();
+        proxy.m_id        = entity.id().id();
+
+        RenderItem & item = proxy.m_item;
+        item.m_is_static     = transform.isStatic();
+        item.m_position      = transform.position();
+        item.m_world_matrix  = transform.world_matrix();
+        item.m_normal_matrix = transform.normal_matrix();
+
+        /* Read only, the mutable accessors would copy the meshes held by the snapshots */
+        const Model & model = renderer.m_model;
+
+        glm::vec3 bounds_min, bounds_max;
+        model.getBounds(bounds_min, bounds_max);
+        AffineMath::transformBounds(item.m_world_matrix, bounds_min, bounds_max, item.m_bounds_min, item.m_bounds_max);
+
+        /* The queue first, then the geometry - the draws of the same model follow each other */
+        const GLuint vertex_array = model.meshesCount() > 0 ? model.getMesh(0).getVertexArray() : 0;
+        item.m_sort_key = (uint64_t(proxy.m_queue) << 32) | uint64_t(vertex_array);
+
+        return proxy;
+    }
+
+    void RenderingSystem::flushQueries()
+    {
+        /* All the renderers and lights added or removed since the last frame, in one batch */
+        m_renderables.flush();
+        m_directional_lights.flush();
+        m_point_lights.flush();
+        m_spot_lights.flush();
+    }
+
+    void RenderingSystem::skipFrame()
+    {
+        flushQueries();
+        m_removed_renderables.clear();
+    }
+
+    void RenderingSystem::updateProxies()
+    {
+        VE_PROFILE_SCOPE("Update Render Proxies");
+
+        for (auto & entity : m_removed_renderables)
         {
-        case ModelRendererComponent::RenderQueue::RQ_OPAQUE:
-            m_opaque_queue.push_back(event.entity);
-            break;
-        case ModelRendererComponent::RenderQueue::RQ_ALPHA:
-            m_alpha_queue.push_back(event.entity);
-            break;
-        case ModelRendererComponent::RenderQueue::RQ_ENVIRO_MAPPING_STATIC:
-            m_enviro_static_queue.push_back(event.entity);
-            break;
-        case ModelRendererComponent::RenderQueue::RQ_ENVIRO_MAPPING_DYNAMIC:
-            m_enviro_dynamic_queue.push_back(event.entity);
-            break;
+            m_proxies.remove(entity.id().index(), entity.id().id());
         }
+
+        m_removed_renderables.clear();
+
+        /* New renderables, the moved ones and the ones given another model or queue - the static ones are skipped once baked */
+        m_renderables.eachChanged<TransformComponent, ModelRendererComponent>(m_proxies_version,
+        [this](entityx::Entity entity, ModelRendererComponent & renderer, TransformComponent & transform)
+        {
+            m_proxies.update(makeProxy(entity, renderer, transform));
+        });
+
+        m_proxies.sort();
     }
 
-    void RenderingSystem::receive(const entityx::ComponentRemovedEvent<ModelRendererComponent>& event)
+    void RenderingSystem::receive(const entityx::ComponentAddedEvent<CameraComponent>& event)
     {
-        std::vector<entityx::Entity>::iterator entity_it;
-
-        switch (event.component->getRenderQueue())
+        if (!m_main_camera)
         {
-        case ModelRendererComponent::RenderQueue::RQ_OPAQUE:
-            entity_it = std::find(m_opaque_queue.begin(), m_opaque_queue.end(), event.entity);
-            if (entity_it != m_opaque_queue.end())
-            {
-                m_opaque_queue.erase(entity_it);
-            }
-            break;
-        case ModelRendererComponent::RenderQueue::RQ_ALPHA:
-            entity_it = std::find(m_alpha_queue.begin(), m_alpha_queue.end(), event.entity);
-            if (entity_it != m_alpha_queue.end())
-            {
-                m_alpha_queue.erase(entity_it);
-            }
-            break;
-        case ModelRendererComponent::RenderQueue::RQ_ENVIRO_MAPPING_STATIC:
-            entity_it = std::find(m_enviro_static_queue.begin(), m_enviro_static_queue.end(), event.entity);
-            if (entity_it != m_enviro_static_queue.end())
-            {
-                m_enviro_static_queue.erase(entity_it);
-            }
-            break;
-        case ModelRendererComponent::RenderQueue::RQ_ENVIRO_MAPPING_DYNAMIC:
-            entity_it = std::find(m_enviro_dynamic_queue.begin(), m_enviro_dynamic_queue.end(), event.entity);
-            if (entity_it != m_enviro_dynamic_queue.end())
-            {
-                m_enviro_dynamic_queue.erase(entity_it);
-            }
-            break;
+            m_main_camera = event.entity;
         }
     }
 
+    void RenderingSystem::receive(const entityx::ComponentRemovedEvent<ModelRendererComponent> & event)
+    {
+        m_removed_renderables.push_back(event.entity);
+    }
+
+    void RenderingSystem::receive(const entityx::ComponentRemovedEvent<TransformComponent> & event)
+    {
+        m_removed_renderables.push_back(event.entity);
+    }
+
     void RenderingSystem::setSkybox(const std::shared_ptr<Skybox>& skybox)
     {
         m_default_skybox = skybox;
@@ -208,6 +363,17 @@ namespace Vertex
 
     void RenderingSystem::resize(unsigned width, unsigned height)
     {
+        m_requested_width  = width;
+        m_requested_height = height;
+    }
+
+    void RenderingSystem::applyResize(unsigned width, unsigned height)
+    {
+        m_viewport_width  = width;
+        m_viewport_height = height;
+
+        glViewport(0, 0, width, height);
+
         m_main_render_target->clear();
         m_helper_render_target->clear();
         m_deferred_rendering->clearGBuffer();
@@ -268,7 +434,7 @@ namespace Vertex
         if(dst == nullptr)
         {
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            glViewport(0, 0, Window::getWidth(), Window::getHeight());
+            glViewport(0, 0, m_viewport_width, m_viewport_height);
         }
         else
         {
@@ -282,43 +448,40 @@ namespace Vertex
         effect->render();
     }
 
-    void RenderingSystem::renderForward(entityx::EntityManager& entities)
+    void RenderingSystem::renderForward(RenderSnapshot & snapshot)
     {
         /* Render everything to offscreen FBO */
         m_main_render_target->bind();
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         m_forward_ambient->bind();
-        m_forward_ambient->setUniform("s_scene_ambient", m_scene_ambient_color);
-        renderOpaque(m_forward_ambient);
-
-        renderLightsForward(entities);
+        m_forward_ambient->setUniform("s_scene_ambient", snapshot.m_scene_ambient_color);
+        renderOpaque(snapshot, m_forward_ambient);
 
-        /* Sort transparent objects back to front */
-        sortAlpha();
+        renderLightsForward(snapshot);
 
-        /* Render transparent objects */
+        /* Render transparent objects, they are already sorted back to front */
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         glDisable(GL_CULL_FACE);
         m_blending_shader->bind();
-        renderAlpha(m_blending_shader);
+        renderAlpha(snapshot, m_blending_shader);
         glEnable(GL_CULL_FACE);
 
-        if (M_DEBUG_RENDERING)
+        if (snapshot.m_debug_rendering)
         {
-            renderDebugLightsBoundingBoxes(entities);
+            renderDebugLightsBoundingBoxes(snapshot);
         }
 
         /* Render skybox */
-        if (m_default_skybox != nullptr)
+        if (snapshot.m_skybox != nullptr)
         {
-            m_default_skybox->render(getCamera()->m_projection, getCamera()->m_view);
+            snapshot.m_skybox->render(snapshot.m_camera.m_projection, snapshot.m_camera.m_view);
 
             m_enviro_mapping_shader->bind();
             m_enviro_mapping_shader->setSubroutine(Shader::Type::FRAGMENT, "reflection"); // TODO: control this using Material class
 
-            m_default_skybox->bindSkyboxTexture();
-            renderEnviroMappingStatic(m_enviro_mapping_shader);
+            snapshot.m_skybox->bindSkyboxTexture();
+            renderEnviroMappingStatic(snapshot, m_enviro_mapping_shader);
         }
 
         /* Apply postprocess effect */
@@ -330,22 +493,32 @@ namespace Vertex
         applyPostprocess(m_fxaa_filter, &m_helper_render_target, 0);
     }
 
-    void RenderingSystem::renderDeferred(entityx::EntityManager& entities)
+    void RenderingSystem::renderDeferred(RenderSnapshot & snapshot)
     {
         /* Geometry Pass - Render data to GBuffer */
-        glDisable(GL_BLEND);
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(GL_TRUE);
+        {
+            VE_PROFILE_GPU("GBuffer");
 
-        m_deferred_rendering->bindGBuffer();
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            glDisable(GL_BLEND);
+            glEnable(GL_DEPTH_TEST);
+            glDepthMask(GL_TRUE);
+
+            m_deferred_rendering->bindGBuffer();
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        m_gbuffer_shader->bind();
-        renderOpaque(m_gbuffer_shader);
+            m_gbuffer_shader->bind();
+            renderOpaque(snapshot, m_gbuffer_shader);
+        }
 
         /* Compute SSAO */
-        m_ssao_rendering->computeSSAO(m_deferred_rendering, getCamera()->m_view, getCamera()->m_projection);
-        m_ssao_rendering->blurSSAO();
+        {
+            VE_PROFILE_GPU("SSAO");
+            m_ssao_rendering->computeSSAO(m_deferred_rendering, snapshot.m_camera.m_view, snapshot.m_camera.m_projection);
+        }
+        {
+            VE_PROFILE_GPU("SSAO Blur");
+            m_ssao_rendering->blurSSAO();
+        }
 
         /* Light Pass - compute lighting */
         glDepthMask(GL_FALSE);
@@ -359,58 +532,72 @@ namespace Vertex
         glClear(GL_COLOR_BUFFER_BIT);
 
         m_ssao_rendering->bindBlurredSSAOTexture(4); //TODO: replace magic number with a variable
-        renderLightsDeferred(entities);
+        renderLightsDeferred(snapshot);
 
         m_deferred_rendering->bindGBufferReadOnly();
         m_main_render_target->bindWriteOnly();
-        glBlitFramebuffer(0, 0, Window::getWidth(), Window::getHeight(),
-                          0, 0, Window::getWidth(), Window::getHeight(),
+        glBlitFramebuffer(0, 0, m_viewport_width, m_viewport_height,
+                          0, 0, m_viewport_width, m_viewport_height,
                           GL_DEPTH_BUFFER_BIT, GL_NEAREST);
 
         m_main_render_target->bind();
         glEnable(GL_DEPTH_TEST);
         glDepthMask(GL_TRUE);
 
-        if (M_DEBUG_RENDERING)
+        if (snapshot.m_debug_rendering)
         {
-            renderDebugLightsBoundingBoxes(entities);
+            renderDebugLightsBoundingBoxes(snapshot);
         }
 
-        /* Sort transparent objects back to front */
-        sortAlpha();
+        /* Render transparent objects, they are already sorted back to front */
+        {
+            VE_PROFILE_GPU("Alpha");
 
-        /* Render transparent objects */
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDisable(GL_CULL_FACE);
-        m_blending_shader->bind();
-        renderAlpha(m_blending_shader);
-        glEnable(GL_CULL_FACE);
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            glDisable(GL_CULL_FACE);
+            m_blending_shader->bind();
+            renderAlpha(snapshot, m_blending_shader);
+            glEnable(GL_CULL_FACE);
+        }
 
         /* Render skybox */
-        if (m_default_skybox != nullptr)
+        if (snapshot.m_skybox != nullptr)
         {
-            m_default_skybox->render(getCamera()->m_projection, getCamera()->m_view);
+            VE_PROFILE_GPU("Skybox");
+
+            snapshot.m_skybox->render(snapshot.m_camera.m_projection, snapshot.m_camera.m_view);
 
             m_enviro_mapping_shader->bind();
             //m_enviro_mapping_shader->setSubroutine(Shader::Type::FRAGMENT, "refraction"); // TODO: control this using Material class
             m_enviro_mapping_shader->setSubroutine(Shader::Type::FRAGMENT, "reflection");
 
-            m_default_skybox->bindSkyboxTexture();
-            renderEnviroMappingStatic(m_enviro_mapping_shader);
+            snapshot.m_skybox->bindSkyboxTexture();
+            renderEnviroMappingStatic(snapshot, m_enviro_mapping_shader);
         }
 
         /* Apply postprocess effect */
-        m_bloom_filter->extractBrightness(m_main_render_target, 1.0);
-        m_bloom_filter->blurGaussian(2);
-        m_bloom_filter->bindBrightnessTexture(1);
+        {
+            VE_PROFILE_GPU("Bloom");
 
-        applyPostprocess(m_hdr_filter, &m_main_render_target, &m_helper_render_target);
-        applyPostprocess(m_fxaa_filter, &m_helper_render_target, 0);
+            m_bloom_filter->extractBrightness(m_main_render_target, 1.0);
+            m_bloom_filter->blurGaussian(2);
+            m_bloom_filter->bindBrightnessTexture(1);
+        }
+        {
+            VE_PROFILE_GPU("HDR");
+            applyPostprocess(m_hdr_filter, &m_main_render_target, &m_helper_render_target);
+        }
+        {
+            VE_PROFILE_GPU("FXAA");
+            applyPostprocess(m_fxaa_filter, &m_helper_render_target, 0);
+        }
     }
 
     void RenderingSystem::renderDebug()
     {
+        float aspect_ratio = float(m_viewport_width) / float(m_viewport_height);
+
         glDisable(GL_BLEND);
         glClear(GL_DEPTH_BUFFER_BIT);
 
@@ -418,44 +605,37 @@ namespace Vertex
 
         m_debug_rendering->setSubroutine(Shader::Type::FRAGMENT, "debugColorTarget");
         m_deferred_rendering->bindGBufferTexture(0, (GLuint)DeferredRendering::GBufferPropertyName::POSITION);
-        glViewport(M_DEBUG_WINDOW_WIDTH * 0, 0, M_DEBUG_WINDOW_WIDTH, M_DEBUG_WINDOW_WIDTH / Window::getAspectRatio());
+        glViewport(M_DEBUG_WINDOW_WIDTH * 0, 0, M_DEBUG_WINDOW_WIDTH, M_DEBUG_WINDOW_WIDTH / aspect_ratio);
         m_deferred_rendering->render();
 
         m_deferred_rendering->bindGBufferTexture(0, (GLuint)DeferredRendering::GBufferPropertyName::ALBEDO_SPECULAR);
-        glViewport(M_DEBUG_WINDOW_WIDTH * 1, 0, M_DEBUG_WINDOW_WIDTH, M_DEBUG_WINDOW_WIDTH / Window::getAspectRatio());
+        glViewport(M_DEBUG_WINDOW_WIDTH * 1, 0, M_DEBUG_WINDOW_WIDTH, M_DEBUG_WINDOW_WIDTH / aspect_ratio);
         m_deferred_rendering->render();
 
         m_deferred_rendering->bindGBufferTexture(0, (GLuint)DeferredRendering::GBufferPropertyName::NORMAL);
-        glViewport(M_DEBUG_WINDOW_WIDTH * 2, 0, M_DEBUG_WINDOW_WIDTH, M_DEBUG_WINDOW_WIDTH / Window::getAspectRatio());
+        glViewport(M_DEBUG_WINDOW_WIDTH * 2, 0, M_DEBUG_WINDOW_WIDTH, M_DEBUG_WINDOW_WIDTH / aspect_ratio);
         m_deferred_rendering->render();
 
         m_debug_rendering->setSubroutine(Shader::Type::FRAGMENT, "debugDepthTarget");
         m_deferred_rendering->bindGBufferTexture(0, (GLuint)DeferredRendering::GBufferPropertyName::DEPTH);
-        glViewport(M_DEBUG_WINDOW_WIDTH * 3, 0, M_DEBUG_WINDOW_WIDTH, M_DEBUG_WINDOW_WIDTH / Window::getAspectRatio());
+        glViewport(M_DEBUG_WINDOW_WIDTH * 3, 0, M_DEBUG_WINDOW_WIDTH, M_DEBUG_WINDOW_WIDTH / aspect_ratio);
         m_deferred_rendering->render();
 
         glEnable(GL_BLEND);
     }
 
-    void RenderingSystem::renderDebugLightsBoundingBoxes(entityx::EntityManager& entities)
+    void RenderingSystem::renderDebugLightsBoundingBoxes(const RenderSnapshot & snapshot)
     {
-        entityx::ComponentHandle<PointLightComponent> point_light;
-        entityx::ComponentHandle<SpotLightComponent>  spot_light;
-        entityx::ComponentHandle<TransformComponent>  transform;
-
         glDisable(GL_BLEND);
 
         /* Point Lights */
         m_light_bsphere.setDrawMode(GL_LINES);
-        for (auto entity : entities.entities_with_components(point_light, transform))
+        for (auto & point_light : snapshot.m_point_lights)
         {
-            auto model       = glm::translate(glm::mat4(1.0f), transform->position()) *
-                               glm::scale(glm::mat4(1.0f), glm::vec3(point_light->m_range));
-            auto view        = CoreServices::getRenderer()->getCamera()->m_view;
-            auto projection  = CoreServices::getRenderer()->getCamera()->m_projection;
+            auto model = AffineMath::composeTRS(point_light.m_position, glm::quat(), glm::vec3(point_light.m_range));
 
             m_boundingbox_shader->bind();
-            m_boundingbox_shader->setUniform("g_mvp", projection * view * model);
+            m_boundingbox_shader->setUniform("g_mvp", AffineMath::multiply(snapshot.m_camera.m_view_projection, model));
             m_boundingbox_shader->setUniform("color", glm::vec4(1.0f, 1.0, 1.0, 1.0f));
 
             m_light_bsphere.render(*m_boundingbox_shader);
@@ -464,19 +644,17 @@ namespace Vertex
 
         /* Spot Lights */
         m_light_bcone.setDrawMode(GL_LINES);
-        for (auto entity : entities.entities_with_components(spot_light, transform))
+        for (auto & spot_light : snapshot.m_spot_lights)
         {
-            float scale_height = spot_light->m_range;
-            float scale_radius = spot_light->m_range * glm::tan(glm::acos(spot_light->getCutOffAngle()) * 1.0f);
+            float scale_height = spot_light.m_range;
+            float scale_radius = spot_light.m_range * glm::tan(glm::acos(spot_light.m_cutoff) * 1.0f);
 
-            auto model      = glm::translate(glm::mat4(1.0f), transform->position()) *
-                              glm::mat4_cast(glm::inverse(transform->orientation()) * glm::angleAxis(glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f))) *
-                              glm::scale(glm::mat4(1.0f), glm::vec3(scale_radius, scale_height, scale_radius));
-            auto view       = CoreServices::getRenderer()->getCamera()->m_view;
-            auto projection = CoreServices::getRenderer()->getCamera()->m_projection;
+            auto model = AffineMath::composeTRS(spot_light.m_position,
+                                                glm::inverse(spot_light.m_orientation) * glm::angleAxis(glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f)),
+                                                glm::vec3(scale_radius, scale_height, scale_radius));
 
             m_boundingbox_shader->bind();
-            m_boundingbox_shader->setUniform("g_mvp", projection * view * model);
+            m_boundingbox_shader->setUniform("g_mvp", AffineMath::multiply(snapshot.m_camera.m_view_projection, model));
             m_boundingbox_shader->setUniform("color", glm::vec4(1.0f, 0.0, 0.0, 1.0f));
 
             m_light_bcone.render(*m_boundingbox_shader);
@@ -485,57 +663,41 @@ namespace Vertex
         glEnable(GL_BLEND);
     }
 
-    void RenderingSystem::renderOpaque(const std::shared_ptr<Shader> & shader)
+    void RenderingSystem::renderItems(const std::vector<RenderItem> & items, const CameraData & camera, const std::shared_ptr<Shader> & shader)
     {
-        ModelRendererComponent* model_renderer;
-        TransformComponent* transform;
-
-        for (auto& entity : m_opaque_queue)
+        for (auto & item : items)
         {
-            model_renderer = entity.component<ModelRendererComponent>().get();
-            transform      = entity.component<TransformComponent>().get();
+            shader->updateGlobalUniforms(item.m_world_matrix, item.m_normal_matrix, camera.m_view_projection, camera.m_position);
 
-            shader->updateGlobalUniforms(*transform);
-            model_renderer->m_model.render(*shader);
+            for (auto & mesh : *item.m_meshes)
+            {
+                shader->updateUniforms(mesh.m_material);
+                mesh.render();
+            }
         }
     }
 
-    void RenderingSystem::renderAlpha(const std::shared_ptr<Shader>& shader)
+    void RenderingSystem::renderOpaque(const RenderSnapshot & snapshot, const std::shared_ptr<Shader> & shader)
     {
-        ModelRendererComponent* model_renderer;
-        TransformComponent* transform;
-
-        for (auto& entity : m_alpha_queue)
-        {
-            model_renderer = entity.component<ModelRendererComponent>().get();
-            transform = entity.component<TransformComponent>().get();
-
-            shader->updateGlobalUniforms(*transform);
-            model_renderer->m_model.render(*shader);
-        }
+        renderItems(snapshot.m_opaque_items, snapshot.m_camera, shader);
     }
 
-    void RenderingSystem::renderEnviroMappingStatic(const std::shared_ptr<Shader>& shader)
+    void RenderingSystem::renderAlpha(const RenderSnapshot & snapshot, const std::shared_ptr<Shader>& shader)
     {
-        ModelRendererComponent* model_renderer;
-        TransformComponent* transform;
-
-        for (auto& entity : m_enviro_static_queue)
-        {
-            model_renderer = entity.component<ModelRendererComponent>().get();
-            transform = entity.component<TransformComponent>().get();
+        renderItems(snapshot.m_alpha_items, snapshot.m_camera, shader);
+    }
 
-            shader->updateGlobalUniforms(*transform);
-            model_renderer->m_model.render(*shader);
-        }
+    void RenderingSystem::renderEnviroMappingStatic(const RenderSnapshot & snapshot, const std::shared_ptr<Shader>& shader)
+    {
+        renderItems(snapshot.m_enviro_static_items, snapshot.m_camera, shader);
     }
 
-    void RenderingSystem::renderEnviroMappingDynamic(const std::shared_ptr<Shader>& shader)
+    void RenderingSystem::renderEnviroMappingDynamic(const RenderSnapshot & snapshot, const std::shared_ptr<Shader>& shader)
     {
 
     }
 
-    void RenderingSystem::renderLightsForward(entityx::EntityManager& entities)
+    void RenderingSystem::renderLightsForward(const RenderSnapshot & snapshot)
     {
         /*
          * TODO:
@@ -544,15 +706,10 @@ namespace Vertex
          * Then render lights with shadows and then lights without shadows;
          */
 
-        entityx::ComponentHandle<DirectionalLightComponent> directional_light;
-        entityx::ComponentHandle<PointLightComponent>       point_light;
-        entityx::ComponentHandle<SpotLightComponent>        spot_light;
-        entityx::ComponentHandle<TransformComponent>        transform;
-
         /* Directional Lights */
-        for(auto entity : entities.entities_with_components(directional_light, transform))
+        for(auto & directional_light : snapshot.m_directional_lights)
         {
-            ShadowInfo shadow_info = directional_light->getShadowInfo();
+            const ShadowInfo & shadow_info = directional_light.m_shadow_info;
             glm::mat4 light_matrix = glm::mat4(0.0f);
 
             if(shadow_info.getCastsShadows())
@@ -562,34 +719,34 @@ namespace Vertex
                 m_dir_shadow_map->bind();
                 glClear(GL_DEPTH_BUFFER_BIT);
 
-                light_matrix = shadow_info.getProjection() * glm::lookAt(-transform->direction(), glm::vec3(0.0f), glm::vec3(0, 1, 0));
+                light_matrix = AffineMath::multiply(shadow_info.getProjection(), glm::lookAt(-directional_light.m_direction, glm::vec3(0.0f), glm::vec3(0, 1, 0)));
                 m_shadow_map_generator->setUniform("s_light_matrix", light_matrix);
 
                 glCullFace(GL_FRONT);
-                renderOpaque(m_shadow_map_generator);
-                renderEnviroMappingStatic(m_shadow_map_generator);
+                renderOpaque(snapshot, m_shadow_map_generator);
+                renderEnviroMappingStatic(snapshot, m_shadow_map_generator);
                 glCullFace(GL_BACK);
             }
 
             bindMainRenderTarget();
-            
+
             m_forward_directional->bind();
             m_dir_shadow_map->bindTexture(SHADOW_MAP);
 
-            m_forward_directional->setUniform(S_DIRECTIONAL_LIGHT ".base.color",     directional_light->m_color);
-            m_forward_directional->setUniform(S_DIRECTIONAL_LIGHT ".base.intensity", directional_light->m_intensity);
-            m_forward_directional->setUniform(S_DIRECTIONAL_LIGHT ".direction",      transform->direction());
+            m_forward_directional->setUniform(S_DIRECTIONAL_LIGHT ".base.color",     directional_light.m_color);
+            m_forward_directional->setUniform(S_DIRECTIONAL_LIGHT ".base.intensity", directional_light.m_intensity);
+            m_forward_directional->setUniform(S_DIRECTIONAL_LIGHT ".direction",      directional_light.m_direction);
             m_forward_directional->setUniform("s_light_matrix", light_matrix);
 
             beginForwardRendering();
-            renderOpaque(m_forward_directional);
+            renderOpaque(snapshot, m_forward_directional);
             endForwardRendering();
         }
 
         /* Point Lights */
-        for (auto entity : entities.entities_with_components(point_light, transform))
+        for (auto & point_light : snapshot.m_point_lights)
         {
-            ShadowInfo shadow_info = point_light->getShadowInfo();
+            const ShadowInfo & shadow_info = point_light.m_shadow_info;
             glm::mat4 light_matrices[6];
 
             if (shadow_info.getCastsShadows())
@@ -599,20 +756,15 @@ namespace Vertex
                 m_omni_shadow_map->bind();
                 glClear(GL_DEPTH_BUFFER_BIT);
 
-                light_matrices[0] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3( 1,  0,  0), glm::vec3(0, -1,  0));
-                light_matrices[1] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3(-1,  0,  0), glm::vec3(0, -1,  0));
-                light_matrices[2] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3( 0,  1,  0), glm::vec3(0,  0,  1));
-                light_matrices[3] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3( 0, -1,  0), glm::vec3(0,  0, -1));
-                light_matrices[4] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3( 0,  0,  1), glm::vec3(0, -1,  0));
-                light_matrices[5] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3( 0,  0, -1), glm::vec3(0, -1,  0));
+                pointLightMatrices(shadow_info.getProjection(), point_light.m_position, light_matrices);
 
                 m_omni_shadow_map_generator->setUniform("s_light_matrices", light_matrices, 6);
-                m_omni_shadow_map_generator->setUniform("s_light_pos", transform->position());
+                m_omni_shadow_map_generator->setUniform("s_light_pos", point_light.m_position);
                 m_omni_shadow_map_generator->setUniform("s_far_plane", 100.0f);
 
                 glCullFace(GL_FRONT);
-                renderOpaque(m_omni_shadow_map_generator);
-                renderEnviroMappingStatic(m_omni_shadow_map_generator);
+                renderOpaque(snapshot, m_omni_shadow_map_generator);
+                renderEnviroMappingStatic(snapshot, m_omni_shadow_map_generator);
                 glCullFace(GL_BACK);
             }
 
@@ -621,24 +773,24 @@ namespace Vertex
             m_forward_point->bind();
             m_omni_shadow_map->bindTexture(SHADOW_MAP);
 
-            m_forward_point->setUniform(S_POINT_LIGHT ".base.color",      point_light->m_color);
-            m_forward_point->setUniform(S_POINT_LIGHT ".base.intensity",  point_light->m_intensity);
-            m_forward_point->setUniform(S_POINT_LIGHT ".atten.constant",  point_light->m_attenuation.m_constant);
-            m_forward_point->setUniform(S_POINT_LIGHT ".atten.linear",    point_light->m_attenuation.m_linear);
-            m_forward_point->setUniform(S_POINT_LIGHT ".atten.quadratic", point_light->m_attenuation.m_quadratic);
-            m_forward_point->setUniform(S_POINT_LIGHT ".position",        transform->position());
-            m_forward_point->setUniform(S_POINT_LIGHT ".range",           point_light->m_range);
+            m_forward_point->setUniform(S_POINT_LIGHT ".base.color",      point_light.m_color);
+            m_forward_point->setUniform(S_POINT_LIGHT ".base.intensity",  point_light.m_intensity);
+            m_forward_point->setUniform(S_POINT_LIGHT ".atten.constant",  point_light.m_attenuation.m_constant);
+            m_forward_point->setUniform(S_POINT_LIGHT ".atten.linear",    point_light.m_attenuation.m_linear);
+            m_forward_point->setUniform(S_POINT_LIGHT ".atten.quadratic", point_light.m_attenuation.m_quadratic);
+            m_forward_point->setUniform(S_POINT_LIGHT ".position",        point_light.m_position);
+            m_forward_point->setUniform(S_POINT_LIGHT ".range",           point_light.m_range);
             m_forward_point->setUniform("s_far_plane", 100.0f);
 
             beginForwardRendering();
-            renderOpaque(m_forward_point);
+            renderOpaque(snapshot, m_forward_point);
             endForwardRendering();
         }
 
         /* Spot Lights */
-        for (auto entity : entities.entities_with_components(spot_light, transform))
+        for (auto & spot_light : snapshot.m_spot_lights)
         {
-            ShadowInfo shadow_info = spot_light->getShadowInfo();
+            const ShadowInfo & shadow_info = spot_light.m_shadow_info;
             glm::mat4 light_matrix = glm::mat4(0.0f);
 
             if (shadow_info.getCastsShadows())
@@ -648,12 +800,12 @@ namespace Vertex
                 m_spot_shadow_map->bind();
                 glClear(GL_DEPTH_BUFFER_BIT);
 
-                light_matrix = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + transform->direction(), glm::vec3(0, 1, 0));
+                light_matrix = AffineMath::multiply(shadow_info.getProjection(), glm::lookAt(spot_light.m_position, spot_light.m_position + spot_light.m_direction, glm::vec3(0, 1, 0)));
                 m_shadow_map_generator->setUniform("s_light_matrix", light_matrix);
 
                 glCullFace(GL_FRONT);
-                renderOpaque(m_shadow_map_generator);
-                renderEnviroMappingStatic(m_shadow_map_generator);
+                renderOpaque(snapshot, m_shadow_map_generator);
+                renderEnviroMappingStatic(snapshot, m_shadow_map_generator);
                 glCullFace(GL_BACK);
             }
 
@@ -662,268 +814,276 @@ namespace Vertex
             m_forward_spot->bind();
             m_spot_shadow_map->bindTexture(SHADOW_MAP);
 
-            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.base.color",      spot_light->m_color);
-            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.base.intensity",  spot_light->m_intensity);
-            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.atten.constant",  spot_light->m_attenuation.m_constant);
-            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.atten.linear",    spot_light->m_attenuation.m_linear);
-            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.atten.quadratic", spot_light->m_attenuation.m_quadratic);
-            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.position",        transform->position());
-            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.range",           spot_light->m_range);
-            m_forward_spot->setUniform(S_SPOT_LIGHT ".direction",             transform->direction());
-            m_forward_spot->setUniform(S_SPOT_LIGHT ".cutoff",                spot_light->getCutOffAngle());
+            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.base.color",      spot_light.m_color);
+            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.base.intensity",  spot_light.m_intensity);
+            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.atten.constant",  spot_light.m_attenuation.m_constant);
+            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.atten.linear",    spot_light.m_attenuation.m_linear);
+            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.atten.quadratic", spot_light.m_attenuation.m_quadratic);
+            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.position",        spot_light.m_position);
+            m_forward_spot->setUniform(S_SPOT_LIGHT ".point.range",           spot_light.m_range);
+            m_forward_spot->setUniform(S_SPOT_LIGHT ".direction",             spot_light.m_direction);
+            m_forward_spot->setUniform(S_SPOT_LIGHT ".cutoff",                spot_light.m_cutoff);
             m_forward_spot->setUniform("s_light_matrix", light_matrix);
 
             beginForwardRendering();
-            renderOpaque(m_forward_spot);
+            renderOpaque(snapshot, m_forward_spot);
             endForwardRendering();
         }
     }
 
-    void RenderingSystem::renderLightsDeferred(entityx::EntityManager& entities)
+    void RenderingSystem::renderLightsDeferred(const RenderSnapshot & snapshot)
     {
-        entityx::ComponentHandle<DirectionalLightComponent> directional_light;
-        entityx::ComponentHandle<PointLightComponent>       point_light;
-        entityx::ComponentHandle<SpotLightComponent>        spot_light;
-        entityx::ComponentHandle<TransformComponent>        transform;
-
         /* Directional Lights */
-        for(auto entity : entities.entities_with_components(directional_light, transform))
         {
-            ShadowInfo shadow_info = directional_light->getShadowInfo();
-            glm::mat4 light_matrix = glm::mat4(0.0f);
+            VE_PROFILE_GPU("Directional Lights");
 
-            if(shadow_info.getCastsShadows())
+            for(auto & directional_light : snapshot.m_directional_lights)
             {
-                glEnable(GL_DEPTH_TEST);
-                glDepthMask(GL_TRUE);
+                const ShadowInfo & shadow_info = directional_light.m_shadow_info;
+                glm::mat4 light_matrix = glm::mat4(0.0f);
 
-                m_shadow_map_generator->bind();
-                m_dir_shadow_map->bind();
-                glClear(GL_DEPTH_BUFFER_BIT);
+                if(shadow_info.getCastsShadows())
+                {
+                    glEnable(GL_DEPTH_TEST);
+                    glDepthMask(GL_TRUE);
 
-                light_matrix = shadow_info.getProjection() * glm::lookAt(-transform->direction(), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-                m_shadow_map_generator->setUniform("s_light_matrix", light_matrix);
+                    m_shadow_map_generator->bind();
+                    m_dir_shadow_map->bind();
+                    glClear(GL_DEPTH_BUFFER_BIT);
 
-                glCullFace(GL_FRONT);
-                renderOpaque(m_shadow_map_generator);
-                renderEnviroMappingStatic(m_shadow_map_generator);
-                glCullFace(GL_BACK);
+                    light_matrix = AffineMath::multiply(shadow_info.getProjection(), glm::lookAt(-directional_light.m_direction, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+                    m_shadow_map_generator->setUniform("s_light_matrix", light_matrix);
 
-                glDepthMask(GL_FALSE);
-                glDisable(GL_DEPTH_TEST);
-            }
+                    glCullFace(GL_FRONT);
+                    renderOpaque(snapshot, m_shadow_map_generator);
+                    renderEnviroMappingStatic(snapshot, m_shadow_map_generator);
+                    glCullFace(GL_BACK);
 
-            bindMainRenderTarget();
+                    glDepthMask(GL_FALSE);
+                    glDisable(GL_DEPTH_TEST);
+                }
 
-            m_deferred_directional->bind();
-            m_deferred_rendering->bindGBufferTextures();
-            m_dir_shadow_map->bindTexture(SHADOW_MAP);
+                bindMainRenderTarget();
 
-            m_deferred_directional->setUniform("s_scene_ambient", m_scene_ambient_color);
-            m_deferred_directional->setUniform(S_DIRECTIONAL_LIGHT ".base.color",     directional_light->m_color);
-            m_deferred_directional->setUniform(S_DIRECTIONAL_LIGHT ".base.intensity", directional_light->m_intensity);
-            m_deferred_directional->setUniform(S_DIRECTIONAL_LIGHT ".direction",      transform->direction());
-            m_deferred_directional->setUniform("s_light_matrix", light_matrix);
+                m_deferred_directional->bind();
+                m_deferred_rendering->bindGBufferTextures();
+                m_dir_shadow_map->bindTexture(SHADOW_MAP);
 
-            m_deferred_rendering->render();
+                m_deferred_directional->setUniform("s_scene_ambient", snapshot.m_scene_ambient_color);
+                m_deferred_directional->setUniform(S_DIRECTIONAL_LIGHT ".base.color",     directional_light.m_color);
+                m_deferred_directional->setUniform(S_DIRECTIONAL_LIGHT ".base.intensity", directional_light.m_intensity);
+                m_deferred_directional->setUniform(S_DIRECTIONAL_LIGHT ".direction",      directional_light.m_direction);
+                m_deferred_directional->setUniform("s_light_matrix", light_matrix);
+
+                m_deferred_rendering->render();
+            }
         }
 
         /* Point Lights */
         glEnable(GL_STENCIL_TEST);
-        for (auto entity : entities.entities_with_components(point_light, transform))
         {
-            ShadowInfo shadow_info = point_light->getShadowInfo();
-            glm::mat4 light_matrices[6];
+            VE_PROFILE_GPU("Point Lights");
 
-            if (shadow_info.getCastsShadows())
+            for (auto & point_light : snapshot.m_point_lights)
             {
-                glEnable(GL_DEPTH_TEST);
-                glDepthMask(GL_TRUE);
+                const ShadowInfo & shadow_info = point_light.m_shadow_info;
+                glm::mat4 light_matrices[6];
 
-                m_omni_shadow_map_generator->bind();
+                if (shadow_info.getCastsShadows())
+                {
+                    glEnable(GL_DEPTH_TEST);
+                    glDepthMask(GL_TRUE);
 
-                m_omni_shadow_map->bind();
-                glClear(GL_DEPTH_BUFFER_BIT);
+                    m_omni_shadow_map_generator->bind();
 
-                light_matrices[0] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3( 1,  0,  0), glm::vec3(0, -1,  0));
-                light_matrices[1] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3(-1,  0,  0), glm::vec3(0, -1,  0));
-                light_matrices[2] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3( 0,  1,  0), glm::vec3(0,  0,  1));
-                light_matrices[3] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3( 0, -1,  0), glm::vec3(0,  0, -1));
-                light_matrices[4] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3( 0,  0,  1), glm::vec3(0, -1,  0));
-                light_matrices[5] = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + glm::vec3( 0,  0, -1), glm::vec3(0, -1,  0));
+                    m_omni_shadow_map->bind();
+                    glClear(GL_DEPTH_BUFFER_BIT);
 
-                m_omni_shadow_map_generator->setUniform("s_light_matrices", light_matrices, 6);
-                m_omni_shadow_map_generator->setUniform("s_light_pos", transform->position());
-                m_omni_shadow_map_generator->setUniform("s_far_plane", 100.0f);
+                    pointLightMatrices(shadow_info.getProjection(), point_light.m_position, light_matrices);
 
-                glCullFace(GL_FRONT);
-                renderOpaque(m_omni_shadow_map_generator);
-                renderEnviroMappingStatic(m_omni_shadow_map_generator);
-                glCullFace(GL_BACK);
+                    m_omni_shadow_map_generator->setUniform("s_light_matrices", light_matrices, 6);
+                    m_omni_shadow_map_generator->setUniform("s_light_pos", point_light.m_position);
+                    m_omni_shadow_map_generator->setUniform("s_far_plane", 100.0f);
 
-                glDepthMask(GL_FALSE);
-                glDisable(GL_DEPTH_TEST);
-            }
+                    glCullFace(GL_FRONT);
+                    renderOpaque(snapshot, m_omni_shadow_map_generator);
+                    renderEnviroMappingStatic(snapshot, m_omni_shadow_map_generator);
+                    glCullFace(GL_BACK);
 
-            bindMainRenderTarget();
+                    glDepthMask(GL_FALSE);
+                    glDisable(GL_DEPTH_TEST);
+                }
 
-            /* Bounding sphere MVP matrix setup */
-            auto model       = glm::translate(glm::mat4(1.0f), transform->position()) *
-                               glm::scale(glm::mat4(1.0f), glm::vec3(point_light->m_range));
-            auto view        = CoreServices::getRenderer()->getCamera()->m_view;
-            auto projection  = CoreServices::getRenderer()->getCamera()->m_projection;
-            auto mvp = projection * view * model;
+                bindMainRenderTarget();
 
-            /* Stencil pass */
-            m_null_shader->bind();
-            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                /* Bounding sphere MVP matrix setup */
+                auto model = AffineMath::composeTRS(point_light.m_position, glm::quat(), glm::vec3(point_light.m_range));
+                auto mvp   = AffineMath::multiply(snapshot.m_camera.m_view_projection, model);
 
-            glEnable(GL_DEPTH_TEST);
-            glDisable(GL_CULL_FACE);
+                /* Stencil pass */
+                m_null_shader->bind();
+                glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 
-            glClear(GL_STENCIL_BUFFER_BIT);
-            glStencilFunc(GL_ALWAYS, 0, 0);
-            glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
-            glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+                glEnable(GL_DEPTH_TEST);
+                glDisable(GL_CULL_FACE);
 
-            m_null_shader->setUniform("g_mvp", mvp);
-            m_light_bsphere.render(*m_null_shader);
+                glClear(GL_STENCIL_BUFFER_BIT);
+                glStencilFunc(GL_ALWAYS, 0, 0);
+                glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+                glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
 
-            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                m_null_shader->setUniform("g_mvp", mvp);
+                m_light_bsphere.render(*m_null_shader);
 
-            /* Lighting pass */
-            glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
-            glDisable(GL_DEPTH_TEST);
-            glEnable(GL_BLEND);
-            glBlendEquation(GL_FUNC_ADD);
-            glBlendFunc(GL_ONE, GL_ONE);
+                glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_FRONT);
+                /* Lighting pass */
+                glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+                glDisable(GL_DEPTH_TEST);
+                glEnable(GL_BLEND);
+                glBlendEquation(GL_FUNC_ADD);
+                glBlendFunc(GL_ONE, GL_ONE);
 
-            m_deferred_point->bind();
-            m_deferred_rendering->bindGBufferTextures();
-            m_omni_shadow_map->bindTexture(SHADOW_MAP);
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_FRONT);
 
-            m_deferred_point->setUniform(S_POINT_LIGHT ".base.color",      point_light->m_color);
-            m_deferred_point->setUniform(S_POINT_LIGHT ".base.intensity",  point_light->m_intensity);
-            m_deferred_point->setUniform(S_POINT_LIGHT ".atten.constant",  point_light->m_attenuation.m_constant);
-            m_deferred_point->setUniform(S_POINT_LIGHT ".atten.linear",    point_light->m_attenuation.m_linear);
-            m_deferred_point->setUniform(S_POINT_LIGHT ".atten.quadratic", point_light->m_attenuation.m_quadratic);
-            m_deferred_point->setUniform(S_POINT_LIGHT ".position",        transform->position());
-            m_deferred_point->setUniform(S_POINT_LIGHT ".range",           point_light->m_range);
-            m_deferred_point->setUniform("s_far_plane", 100.0f);
+                m_deferred_point->bind();
+                m_deferred_rendering->bindGBufferTextures();
+                m_omni_shadow_map->bindTexture(SHADOW_MAP);
 
-            m_deferred_point->setUniform("g_mvp", mvp);
-            m_light_bsphere.render(*m_deferred_point);
+                m_deferred_point->setUniform(S_POINT_LIGHT ".base.color",      point_light.m_color);
+                m_deferred_point->setUniform(S_POINT_LIGHT ".base.intensity",  point_light.m_intensity);
+                m_deferred_point->setUniform(S_POINT_LIGHT ".atten.constant",  point_light.m_attenuation.m_constant);
+                m_deferred_point->setUniform(S_POINT_LIGHT ".atten.linear",    point_light.m_attenuation.m_linear);
+                m_deferred_point->setUniform(S_POINT_LIGHT ".atten.quadratic", point_light.m_attenuation.m_quadratic);
+                m_deferred_point->setUniform(S_POINT_LIGHT ".position",        point_light.m_position);
+                m_deferred_point->setUniform(S_POINT_LIGHT ".range",           point_light.m_range);
+                m_deferred_point->setUniform("s_far_plane", 100.0f);
 
-            glCullFace(GL_BACK);
-            glDisable(GL_BLEND);
+                m_deferred_point->setUniform("g_mvp", mvp);
+                m_light_bsphere.render(*m_deferred_point);
+
+                glCullFace(GL_BACK);
+                glDisable(GL_BLEND);
+            }
         }
 
         /* Spot Lights */
-        for (auto entity : entities.entities_with_components(spot_light, transform))
         {
-            ShadowInfo shadow_info = spot_light->getShadowInfo();
-            glm::mat4 light_matrix = glm::mat4(0.0f);
+            VE_PROFILE_GPU("Spot Lights");
 
-            if (shadow_info.getCastsShadows())
+            for (auto & spot_light : snapshot.m_spot_lights)
             {
-                glEnable(GL_DEPTH_TEST);
-                glDepthMask(GL_TRUE);
+                const ShadowInfo & shadow_info = spot_light.m_shadow_info;
+                glm::mat4 light_matrix = glm::mat4(0.0f);
 
-                m_shadow_map_generator->bind();
+                if (shadow_info.getCastsShadows())
+                {
+                    glEnable(GL_DEPTH_TEST);
+                    glDepthMask(GL_TRUE);
 
-                m_spot_shadow_map->bind();
-                glClear(GL_DEPTH_BUFFER_BIT);
+                    m_shadow_map_generator->bind();
 
-                light_matrix = shadow_info.getProjection() * glm::lookAt(transform->position(), transform->position() + transform->direction(), glm::vec3(0, 1, 0));
-                m_shadow_map_generator->setUniform("s_light_matrix", light_matrix);
+                    m_spot_shadow_map->bind();
+                    glClear(GL_DEPTH_BUFFER_BIT);
 
-                glCullFace(GL_FRONT);
-                renderOpaque(m_shadow_map_generator);
-                renderEnviroMappingStatic(m_shadow_map_generator);
-                glCullFace(GL_BACK);
+                    light_matrix = AffineMath::multiply(shadow_info.getProjection(), glm::lookAt(spot_light.m_position, spot_light.m_position + spot_light.m_direction, glm::vec3(0, 1, 0)));
+                    m_shadow_map_generator->setUniform("s_light_matrix", light_matrix);
 
-                glDepthMask(GL_FALSE);
-                glDisable(GL_DEPTH_TEST);
-            }
+                    glCullFace(GL_FRONT);
+                    renderOpaque(snapshot, m_shadow_map_generator);
+                    renderEnviroMappingStatic(snapshot, m_shadow_map_generator);
+                    glCullFace(GL_BACK);
 
-            bindMainRenderTarget();
+                    glDepthMask(GL_FALSE);
+                    glDisable(GL_DEPTH_TEST);
+                }
 
-            /* Bounding cone MVP matrix setup */
-            float scale_height = spot_light->m_range;
-            float scale_radius = spot_light->m_range * glm::tan(glm::acos(spot_light->getCutOffAngle()));
+                bindMainRenderTarget();
 
-            auto model      = glm::translate(glm::mat4(1.0f), transform->position()) *
-                              glm::mat4_cast(glm::inverse(transform->orientation()) * glm::angleAxis(glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f))) *
-                              glm::scale(glm::mat4(1.0f), glm::vec3(scale_radius, scale_height, scale_radius));
-            auto view        = CoreServices::getRenderer()->getCamera()->m_view;
-            auto projection  = CoreServices::getRenderer()->getCamera()->m_projection;
-            auto mvp = projection * view * model;
+                /* Bounding cone MVP matrix setup */
+                float scale_height = spot_light.m_range;
+                float scale_radius = spot_light.m_range * glm::tan(glm::acos(spot_light.m_cutoff));
 
-            /* Stencil pass */
-            m_null_shader->bind();
-            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                auto model = AffineMath::composeTRS(spot_light.m_position,
+                                                    glm::inverse(spot_light.m_orientation) * glm::angleAxis(glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f)),
+                                                    glm::vec3(scale_radius, scale_height, scale_radius));
+                auto mvp   = AffineMath::multiply(snapshot.m_camera.m_view_projection, model);
 
-            glEnable(GL_DEPTH_TEST);
-            glDisable(GL_CULL_FACE);
+                /* Stencil pass */
+                m_null_shader->bind();
+                glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 
-            glClear(GL_STENCIL_BUFFER_BIT);
-            glStencilFunc(GL_ALWAYS, 0, 0);
-            glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
-            glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+                glEnable(GL_DEPTH_TEST);
+                glDisable(GL_CULL_FACE);
 
-            m_null_shader->setUniform("g_mvp", mvp);
-            m_light_bcone.render(*m_null_shader);
+                glClear(GL_STENCIL_BUFFER_BIT);
+                glStencilFunc(GL_ALWAYS, 0, 0);
+                glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+                glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
 
-            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                m_null_shader->setUniform("g_mvp", mvp);
+                m_light_bcone.render(*m_null_shader);
 
-            /* Lighting pass */
-            glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
-            glDisable(GL_DEPTH_TEST);
-            glEnable(GL_BLEND);
-            glBlendEquation(GL_FUNC_ADD);
-            glBlendFunc(GL_ONE, GL_ONE);
+                glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_FRONT);
+                /* Lighting pass */
+                glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+                glDisable(GL_DEPTH_TEST);
+                glEnable(GL_BLEND);
+                glBlendEquation(GL_FUNC_ADD);
+                glBlendFunc(GL_ONE, GL_ONE);
 
-            m_deferred_spot->bind();
-            m_deferred_rendering->bindGBufferTextures();
-            m_spot_shadow_map->bindTexture(SHADOW_MAP);
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_FRONT);
 
-            m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.base.color",      spot_light->m_color);
-            m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.base.intensity",  spot_light->m_intensity);
-            m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.atten.constant",  spot_light->m_attenuation.m_constant);
-            m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.atten.linear",    spot_light->m_attenuation.m_linear);
-            m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.atten.quadratic", spot_light->m_attenuation.m_quadratic);
-            m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.position",        transform->position());
-            m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.range",           spot_light->m_range);
-            m_deferred_spot->setUniform(S_SPOT_LIGHT ".direction",             transform->direction());
-            m_deferred_spot->setUniform(S_SPOT_LIGHT ".cutoff",                spot_light->getCutOffAngle());
-            m_deferred_spot->setUniform("s_light_matrix", light_matrix);
-
-            m_deferred_spot->setUniform("g_mvp", mvp);
-            m_light_bcone.render(*m_deferred_point);
-
-            glCullFace(GL_BACK);
-            glDisable(GL_BLEND);
+                m_deferred_spot->bind();
+                m_deferred_rendering->bindGBufferTextures();
+                m_spot_shadow_map->bindTexture(SHADOW_MAP);
+
+                m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.base.color",      spot_light.m_color);
+                m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.base.intensity",  spot_light.m_intensity);
+                m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.atten.constant",  spot_light.m_attenuation.m_constant);
+                m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.atten.linear",    spot_light.m_attenuation.m_linear);
+                m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.atten.quadratic", spot_light.m_attenuation.m_quadratic);
+                m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.position",        spot_light.m_position);
+                m_deferred_spot->setUniform(S_SPOT_LIGHT ".point.range",           spot_light.m_range);
+                m_deferred_spot->setUniform(S_SPOT_LIGHT ".direction",             spot_light.m_direction);
+                m_deferred_spot->setUniform(S_SPOT_LIGHT ".cutoff",                spot_light.m_cutoff);
+                m_deferred_spot->setUniform("s_light_matrix", light_matrix);
+
+                m_deferred_spot->setUniform("g_mvp", mvp);
+                m_light_bcone.render(*m_deferred_point);
+
+                glCullFace(GL_BACK);
+                glDisable(GL_BLEND);
+            }
         }
         glDisable(GL_STENCIL_TEST);
     }
 
-    void RenderingSystem::sortAlpha()
+    void RenderingSystem::sortAlpha(RenderSnapshot & snapshot)
     {
-        auto cam_pos = getCameraTransform()->position();
+        auto cam_pos = snapshot.m_camera.m_position;
 
-        std::sort(m_alpha_queue.begin(), m_alpha_queue.end(), 
-                   [&cam_pos](entityx::Entity & obj1, entityx::Entity & obj2)
+        std::sort(snapshot.m_alpha_items.begin(), snapshot.m_alpha_items.end(),
+                   [&cam_pos](const RenderItem & obj1, const RenderItem & obj2)
                          {
-                            const auto pos1 = obj1.component<TransformComponent>()->position();
-                            const auto pos2 = obj2.component<TransformComponent>()->position();
-
-                            return glm::length(cam_pos - pos1) >= glm::length(cam_pos - pos2);
+                            return glm::length(cam_pos - obj1.m_position) > glm::length(cam_pos - obj2.m_position);
                          });
     }
+
+    void RenderingSystem::pointLightMatrices(const glm::mat4 & projection, const glm::vec3 & position, glm::mat4 * light_matrices)
+    {
+        glm::mat4 views[6];
+
+        views[0] = glm::lookAt(position, position + glm::vec3( 1,  0,  0), glm::vec3(0, -1,  0));
+        views[1] = glm::lookAt(position, position + glm::vec3(-1,  0,  0), glm::vec3(0, -1,  0));
+        views[2] = glm::lookAt(position, position + glm::vec3( 0,  1,  0), glm::vec3(0,  0,  1));
+        views[3] = glm::lookAt(position, position + glm::vec3( 0, -1,  0), glm::vec3(0,  0, -1));
+        views[4] = glm::lookAt(position, position + glm::vec3( 0,  0,  1), glm::vec3(0, -1,  0));
+        views[5] = glm::lookAt(position, position + glm::vec3( 0,  0, -1), glm::vec3(0, -1,  0));
+
+        AffineMath::multiply(projection, views, light_matrices, 6);
+    }
 }
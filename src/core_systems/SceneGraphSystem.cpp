@@ -1,15 +1,34 @@
 ﻿#include "core_systems/SceneGraphSystem.h"
+#include "core_engine/World.h"
 
 namespace Vertex
 {
     TransformComponent SceneGraphSystem::M_ROOT_NODE;
 
+    namespace
+    {
+        /* Initialized right after the root, in the order of the definitions */
+        const bool g_is_root_node_registered = (SceneGraphSystem::M_ROOT_NODE.makeSceneRoot(), true);
+    }
+
     void SceneGraphSystem::configure(entityx::EntityManager& entities, entityx::EventManager& events)
     {
     }
 
     void SceneGraphSystem::update(entityx::EntityManager& entities, entityx::EventManager& events, entityx::TimeDelta dt)
     {
-        M_ROOT_NODE.update(M_ROOT_NODE.world_matrix(), false);
+        TransformComponent::hierarchy().update();
+    }
+
+    TransformComponent & SceneGraphSystem::root()
+    {
+        World * world = World::current();
+
+        return world ? world->root() : M_ROOT_NODE;
+    }
+
+    void SceneGraphSystem::storePreviousStates()
+    {
+        TransformComponent::hierarchy().storePreviousStates();
     }
 }
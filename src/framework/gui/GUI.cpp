@@ -1,13 +1,70 @@
 ﻿#include "framework/gui/GUI.h"
 #include "framework/gui/imgui_impl_opengl3.h"
+#include "framework/rendering/GpuProfiler.h"
+#include "framework/utilities/AllocationCounter.h"
 
 #include <glm/vec2.hpp>
 #include <glm/common.hpp>
 #include <imgui_internal.h>
+#include <cstring>
 #include <sstream>
 
 namespace Vertex
 {
+    namespace
+    {
+        /* ImVector's assignment frees the memory first, this one reuses it */
+        template <typename T>
+        void copyVector(ImVector<T> & dst, const ImVector<T> & src)
+        {
+            dst.resize(src.Size);
+
+            if (src.Size > 0)
+            {
+                memcpy(dst.Data, src.Data, size_t(src.Size) * sizeof(T));
+            }
+        }
+    }
+
+    GUIDrawData::GUIDrawData()
+    {
+    }
+
+    GUIDrawData::~GUIDrawData()
+    {
+        for (auto draw_list : m_draw_lists)
+        {
+            delete draw_list;
+        }
+    }
+
+    void GUIDrawData::copyFrom(const ImDrawData & draw_data)
+    {
+        while (m_draw_lists.size() < size_t(draw_data.CmdListsCount))
+        {
+            m_draw_lists.push_back(new ImDrawList(nullptr));
+        }
+
+        for (int i = 0; i < draw_data.CmdListsCount; ++i)
+        {
+            const ImDrawList * src = draw_data.CmdLists[i];
+            ImDrawList       * dst = m_draw_lists[i];
+
+            copyVector(dst->CmdBuffer, src->CmdBuffer);
+            copyVector(dst->IdxBuffer, src->IdxBuffer);
+            copyVector(dst->VtxBuffer, src->VtxBuffer);
+            dst->Flags = src->Flags;
+        }
+
+        m_draw_data.Valid         = draw_data.Valid;
+        m_draw_data.CmdLists      = m_draw_lists.empty() ? nullptr : m_draw_lists.data();
+        m_draw_data.CmdListsCount = draw_data.CmdListsCount;
+        m_draw_data.TotalIdxCount = draw_data.TotalIdxCount;
+        m_draw_data.TotalVtxCount = draw_data.TotalVtxCount;
+        m_draw_data.DisplayPos    = draw_data.DisplayPos;
+        m_draw_data.DisplaySize   = draw_data.DisplaySize;
+    }
+
     glm::vec2 GUI::m_window_size = glm::vec2(0.0f);
 
     GUI::~GUI()
@@ -28,6 +85,19 @@ namespace Vertex
         m_window_size = glm::vec2(Window::getWidth(), Window::getHeight());
 
         ImGui::GetIO().Fonts->AddFontDefault();
+
+        /* Create the font texture now, so prepare() doesn't need the GL context */
+        ImGui_ImplOpenGL3_CreateDeviceObjects();
+    }
+
+    void GUI::initHeadless()
+    {
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+
+        m_window_size = glm::vec2(Window::getWidth(), Window::getHeight());
+
+        ImGui::GetIO().Fonts->AddFontDefault();
     }
 
     void GUI::prepare()
@@ -39,11 +109,32 @@ namespace Vertex
 
     void GUI::render()
     {
+        VE_PROFILE_GPU("GUI");
+
         glViewport(0, 0, GLsizei(m_window_size.x), GLsizei(m_window_size.y));
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     }
 
+    void GUI::endFrame(GUIDrawData & draw_data)
+    {
+        ImGui::Render();
+        draw_data.copyFrom(*ImGui::GetDrawData());
+    }
+
+    void GUI::render(GUIDrawData & draw_data)
+    {
+        if (!draw_data.get()->Valid)
+        {
+            return;
+        }
+
+        VE_PROFILE_GPU("GUI");
+
+        glViewport(0, 0, GLsizei(draw_data.get()->DisplaySize.x), GLsizei(draw_data.get()->DisplaySize.y));
+        ImGui_ImplOpenGL3_RenderDrawData(draw_data.get());
+    }
+
     void GUI::updateWindowSize(float width, float height)
     {
         m_window_size = glm::vec2(width, height);
@@ -72,6 +163,60 @@ namespace Vertex
         ImGui::PopStyleVar(2);
     }
 
+    void GUI::performanceHUD(const FrameTelemetry & telemetry, unsigned int fps)
+    {
+        typedef FrameTelemetry::Metric Metric;
+
+        static const Metric      metrics[] = { Metric::FRAME_TIME, Metric::SIM_TIME, Metric::RENDER_TIME, Metric::SWAP_TIME };
+        static const char *      names[]   = { "Frame", "Simulation", "Render", "Swap" };
+        static std::vector<float> values;
+        static std::vector<float> bins;
+
+        ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - 10.0f, 110.0f), ImGuiCond_FirstUseEver, ImVec2(1.0f, 0.0f));
+        ImGui::SetNextWindowBgAlpha(0.75f);
+        ImGui::Begin("Performance", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing);
+
+        ImGui::Text("FPS: %u   Frames: %u   Steps p99: %.0f", fps, unsigned(telemetry.size()), telemetry.percentile(Metric::SIM_STEPS, 99.0f));
+        if (AllocationCounter::isEnabled())
+        {
+            ImGui::Text("Heap allocations per frame: p50 %.0f   max %.0f", telemetry.percentile(Metric::HEAP_ALLOCATIONS, 50.0f), telemetry.max(Metric::HEAP_ALLOCATIONS));
+        }
+        else
+        {
+            ImGui::Text("Heap allocations per frame: not counted (VE_ALLOCATION_COUNTER is OFF)");
+        }
+        ImGui::Separator();
+
+        ImGui::Columns(4, nullptr, false);
+        ImGui::Text("ms"); ImGui::NextColumn();
+        ImGui::Text("p50"); ImGui::NextColumn();
+        ImGui::Text("p95"); ImGui::NextColumn();
+        ImGui::Text("p99"); ImGui::NextColumn();
+
+        for (int i = 0; i < 4; ++i)
+        {
+            ImGui::Text("%s", names[i]); ImGui::NextColumn();
+            ImGui::Text("%.2f", telemetry.percentile(metrics[i], 50.0f)); ImGui::NextColumn();
+            ImGui::Text("%.2f", telemetry.percentile(metrics[i], 95.0f)); ImGui::NextColumn();
+            ImGui::Text("%.2f", telemetry.percentile(metrics[i], 99.0f)); ImGui::NextColumn();
+        }
+
+        ImGui::Columns(1);
+        ImGui::Separator();
+
+        /* Hitches stand out better with the scale fixed a bit above the worst frame */
+        float max_frame_ms = glm::max(telemetry.max(Metric::FRAME_TIME) * 1.1f, 1.0f);
+
+        telemetry.values(Metric::FRAME_TIME, values);
+        ImGui::PlotLines("##FrameTimes", values.data(), int(values.size()), 0, "Frame time", 0.0f, max_frame_ms, ImVec2(300.0f, 60.0f));
+
+        telemetry.histogram(Metric::FRAME_TIME, max_frame_ms, 40, bins);
+        ImGui::PlotHistogram("##FrameTimesHistogram", bins.data(), int(bins.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(300.0f, 60.0f));
+        ImGui::Text("Histogram range: 0 - %.1f ms", max_frame_ms);
+
+        ImGui::End();
+    }
+
     float GUI::text(const std::shared_ptr<Font> & font, const std::string& text, const glm::vec2& position, float size, const glm::vec4& color, bool center, bool text_shadow)
     {
         ImGuiWindow* window = ImGui::GetCurrentWindow();
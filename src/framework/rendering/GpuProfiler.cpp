@@ -0,0 +1,121 @@
+#include "framework/rendering/GpuProfiler.h"
+
+namespace Vertex
+{
+    GpuProfiler::Frame    GpuProfiler::m_frames[GpuProfiler::FRAMES_COUNT];
+    std::vector<unsigned> GpuProfiler::m_open_passes;
+    unsigned              GpuProfiler::m_frame_index   = 0;
+    unsigned              GpuProfiler::m_lane          = 0;
+    bool                  GpuProfiler::m_is_lane_added = false;
+    bool                  GpuProfiler::m_is_recording  = false;
+
+    void GpuProfiler::beginFrame()
+    {
+        m_frames[m_frame_index].m_is_complete = m_open_passes.empty();
+        m_open_passes.clear();
+
+        m_is_recording = Profiler::isEnabled();
+
+        if (!m_is_recording)
+        {
+            return;
+        }
+
+        if (!m_is_lane_added)
+        {
+            m_lane          = Profiler::addLane("GPU");
+            m_is_lane_added = true;
+        }
+
+        m_frame_index = (m_frame_index + 1) % FRAMES_COUNT;
+
+        Frame & frame = m_frames[m_frame_index];
+        resolve(frame);
+
+        frame.m_passes.clear();
+        frame.m_last_query = 0;
+
+        GLint64 gpu_time = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+
+        frame.m_gpu_reference = gpu_time;
+        frame.m_cpu_reference = Profiler::now();
+    }
+
+    void GpuProfiler::beginPass(const char * name)
+    {
+        /* The profiler was enabled in the middle of the frame */
+        if (!m_is_recording)
+        {
+            return;
+        }
+
+        Frame & frame = m_frames[m_frame_index];
+        unsigned index = unsigned(frame.m_passes.size());
+
+        Pass pass = { name, acquireQuery(frame, 2 * index), acquireQuery(frame, 2 * index + 1), uint32_t(m_open_passes.size()) };
+        frame.m_passes.push_back(pass);
+        m_open_passes.push_back(index);
+
+        glQueryCounter(pass.m_begin_query, GL_TIMESTAMP);
+    }
+
+    void GpuProfiler::endPass()
+    {
+        if (m_open_passes.empty())
+        {
+            return;
+        }
+
+        Frame & frame = m_frames[m_frame_index];
+
+        frame.m_last_query = frame.m_passes[m_open_passes.back()].m_end_query;
+        glQueryCounter(frame.m_last_query, GL_TIMESTAMP);
+        m_open_passes.pop_back();
+    }
+
+    GLuint GpuProfiler::acquireQuery(Frame & frame, unsigned index)
+    {
+        /* The queries are reused frame after frame, new ones are created only when there are more passes */
+        while (frame.m_queries.size() <= index)
+        {
+            GLuint query = 0;
+            glGenQueries(1, &query);
+            frame.m_queries.push_back(query);
+        }
+
+        return frame.m_queries[index];
+    }
+
+    void GpuProfiler::resolve(Frame & frame)
+    {
+        if (frame.m_passes.empty() || !frame.m_is_complete)
+        {
+            return;
+        }
+
+        /* The queries finish in the order they were issued, if the last one is ready all of them are */
+        GLint is_available = GL_FALSE;
+        glGetQueryObjectiv(frame.m_last_query, GL_QUERY_RESULT_AVAILABLE, &is_available);
+
+        if (is_available == GL_FALSE)
+        {
+            return;
+        }
+
+        for (auto & pass : frame.m_passes)
+        {
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(pass.m_begin_query, GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(pass.m_end_query,   GL_QUERY_RESULT, &end);
+
+            ProfileEvent event;
+            event.m_name     = pass.m_name;
+            event.m_begin_ns = uint64_t(int64_t(frame.m_cpu_reference) + (int64_t(begin) - frame.m_gpu_reference));
+            event.m_end_ns   = uint64_t(int64_t(frame.m_cpu_reference) + (int64_t(end)   - frame.m_gpu_reference));
+            event.m_depth    = pass.m_depth;
+
+            Profiler::record(m_lane, event);
+        }
+    }
+}
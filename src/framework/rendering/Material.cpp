@@ -49,11 +49,13 @@ namespace Vertex
         m_float_map[uniform_name] = value;
     }
 
-    std::shared_ptr<Texture> Material::getTexture(TextureType texture_type)
+    std::shared_ptr<Texture> Material::getTexture(TextureType texture_type) const
     {
-        if(m_texture_map.count(texture_type))
+        auto texture = m_texture_map.find(texture_type);
+
+        if(texture != m_texture_map.end())
         {
-            return m_texture_map[texture_type];
+            return texture->second;
         }
 
         VERTEX_ASSERT_MSG(false, "Couldn't find texture with the specified texture type!");
@@ -61,21 +63,25 @@ namespace Vertex
         return nullptr;
     }
 
-    glm::vec3 Material::getVector3(const std::string& uniform_name)
+    glm::vec3 Material::getVector3(const std::string& uniform_name) const
     {
-        if (m_vec3_map.count(uniform_name))
+        auto vector3 = m_vec3_map.find(uniform_name);
+
+        if (vector3 != m_vec3_map.end())
         {
-            return m_vec3_map[uniform_name];
+            return vector3->second;
         }
 
         return glm::vec3(1.0f);
     }
 
-    float Material::getFloat(const std::string& uniform_name)
+    float Material::getFloat(const std::string& uniform_name) const
     {
-        if (m_float_map.count(uniform_name))
+        auto value = m_float_map.find(uniform_name);
+
+        if (value != m_float_map.end())
         {
-            return m_float_map[uniform_name];
+            return value->second;
         }
 
         return 1.0f;
@@ -1,11 +1,22 @@
 #include "framework/rendering/Mesh.h"
+#include "framework/window/Window.h"
+#include <glm/common.hpp>
 
 namespace Vertex
 {
     MeshData::MeshData()
-        : m_indices_count(0),
-          m_draw_mode(GL_TRIANGLES)
+        : m_vao_id(0),
+          m_vbo_ids{ 0, 0 },
+          m_indices_count(0),
+          m_draw_mode(GL_TRIANGLES),
+          m_bounds_min(0.0f),
+          m_bounds_max(0.0f)
     {
+        if (Window::isHeadless())
+        {
+            return;
+        }
+
         glCreateVertexArrays(1, &m_vao_id);
         glCreateBuffers(sizeof(m_vbo_ids) / sizeof(GLuint), m_vbo_ids);
     }
@@ -36,6 +47,24 @@ namespace Vertex
         m_mesh_data = std::make_shared<MeshData>();
         m_mesh_data->m_indices_count = buffers.m_indices.size();
 
+        if (!buffers.m_vertices.empty())
+        {
+            m_mesh_data->m_bounds_min = buffers.m_vertices[0].m_position;
+            m_mesh_data->m_bounds_max = buffers.m_vertices[0].m_position;
+
+            for (auto & vertex : buffers.m_vertices)
+            {
+                m_mesh_data->m_bounds_min = glm::min(m_mesh_data->m_bounds_min, vertex.m_position);
+                m_mesh_data->m_bounds_max = glm::max(m_mesh_data->m_bounds_max, vertex.m_position);
+            }
+        }
+
+        /* Without GL context only the mesh's bookkeeping is kept */
+        if (m_mesh_data->m_vao_id == 0)
+        {
+            return;
+        }
+
         /* Set up buffer objects */
         glNamedBufferStorage(m_mesh_data->m_vbo_ids[VERTEX_DATA],  buffers.m_vertices.size()  * sizeof(buffers.m_vertices[0]),  buffers.m_vertices.data(),  0 /*flags*/);
         glNamedBufferStorage(m_mesh_data->m_vbo_ids[INDEX],        buffers.m_indices.size()   * sizeof(buffers.m_indices[0]),   buffers.m_indices.data(),   0 /*flags*/);
@@ -62,8 +91,26 @@ namespace Vertex
         glVertexArrayVertexBuffer(m_mesh_data->m_vao_id, 0 /*bindingindex*/, m_mesh_data->m_vbo_ids[VERTEX_DATA], 0 /*offset*/, sizeof(buffers.m_vertices[0]) /*stride*/);
     }
 
+    bool Mesh::getBounds(glm::vec3 & min, glm::vec3 & max) const
+    {
+        if (!m_mesh_data)
+        {
+            return false;
+        }
+
+        min = m_mesh_data->m_bounds_min;
+        max = m_mesh_data->m_bounds_max;
+
+        return true;
+    }
+
     void Mesh::render() const
-    {        
+    {
+        if (m_mesh_data->m_vao_id == 0)
+        {
+            return;
+        }
+
         glBindVertexArray(m_mesh_data->m_vao_id);
         glDrawElements(m_mesh_data->m_draw_mode, m_mesh_data->m_indices_count, GL_UNSIGNED_INT, nullptr);
     }
@@ -9,7 +9,24 @@
 
 namespace Vertex
 {
+    namespace
+    {
+        const aiTextureType MATERIAL_TEXTURE_TYPES[] = { aiTextureType_DIFFUSE, aiTextureType_HEIGHT, aiTextureType_NORMALS, aiTextureType_SPECULAR };
+
+        std::string texturePath(aiMaterial * material, aiTextureType type, GLuint index, const aiString & directory)
+        {
+            aiString str, fullPath(directory);
+            material->GetTexture(type, index, &str);
+
+            fullPath.Append("/");
+            fullPath.Append(str.C_Str());
+
+            return fullPath.C_Str();
+        }
+    }
+
     Model::Model()
+        : m_meshes(std::make_shared<std::vector<Mesh>>())
     {
     }
 
@@ -17,9 +34,38 @@ namespace Vertex
     {
     }
 
+    std::vector<Mesh> & Model::mutableMeshes()
+    {
+        /* Only the main thread makes new references, so a unique one can't be taken meanwhile */
+        if (m_meshes.use_count() > 1)
+        {
+            m_meshes = std::make_shared<std::vector<Mesh>>(*m_meshes);
+        }
+
+        return *m_meshes;
+    }
+
     void Model::load(const std::string & filename)
     {
-        Assimp::Importer importer;
+        load(*import(filename));
+    }
+
+    void Model::load(const ModelImport & imported)
+    {
+        if (!imported.m_scene)
+        {
+            return;
+        }
+
+        aiString directory = aiString(imported.m_filename.substr(0, imported.m_filename.rfind("/")));
+
+        processNode(imported.m_scene->mRootNode, imported, directory);
+    }
+
+    std::shared_ptr<ModelImport> Model::import(const std::string & filename)
+    {
+        auto imported = std::make_shared<ModelImport>();
+        imported->m_filename = filename;
 
         unsigned int flags = aiProcess_Triangulate              | 
                              aiProcess_GenSmoothNormals         | 
@@ -29,34 +75,60 @@ namespace Vertex
                              aiProcess_RemoveRedundantMaterials | 
                              aiProcess_ImproveCacheLocality     | 
                              aiProcess_JoinIdenticalVertices;
-        const aiScene * scene = importer.ReadFile(filename, flags);
+        const aiScene * scene = imported->m_importer.ReadFile(filename, flags);
 
         if (!scene || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
         {
-            fprintf(stderr, "Assimp error while loading mesh %s\n Error: %s\n", filename.c_str(), importer.GetErrorString());
-            return;
+            fprintf(stderr, "Assimp error while loading mesh %s\n Error: %s\n", filename.c_str(), imported->m_importer.GetErrorString());
+            scene = nullptr;
+        }
+
+        imported->m_scene = scene;
+
+        if (!scene)
+        {
+            return imported;
         }
 
+        /* Decoding is most of the loading time of a textured model, only the upload needs the GL context */
         aiString directory = aiString(filename.substr(0, filename.rfind("/")));
 
-        processNode(scene->mRootNode, scene, directory);
+        for (GLuint i = 0; i < scene->mNumMeshes; ++i)
+        {
+            aiMaterial * material = scene->mMaterials[scene->mMeshes[i]->mMaterialIndex];
+
+            for (aiTextureType type : MATERIAL_TEXTURE_TYPES)
+            {
+                for (GLuint j = 0; j < material->GetTextureCount(type); ++j)
+                {
+                    std::string path = texturePath(material, type, j, directory);
+
+                    if (!imported->m_textures.count(path) && !CoreAssetManager::getTexture2D(path))
+                    {
+                        imported->m_textures[path] = Texture::import(path);
+                    }
+                }
+            }
+        }
+
+        return imported;
     }
 
-    void Model::processNode(aiNode * node, const aiScene * scene, aiString & directory)
+    void Model::processNode(aiNode * node, const ModelImport & imported, aiString & directory)
     {
         for (GLuint i = 0; i < node->mNumMeshes; ++i)
         {
-            aiMesh * mesh = scene->mMeshes[node->mMeshes[i]];
-            m_meshes.push_back(processMesh(mesh, scene, directory));
+            aiMesh * mesh = imported.m_scene->mMeshes[node->mMeshes[i]];
+            mutableMeshes().push_back(processMesh(mesh, imported, directory));
         }
 
         for (GLuint i = 0; i < node->mNumChildren; ++i)
         {
-            processNode(node->mChildren[i], scene, directory);
+            processNode(node->mChildren[i], imported, directory);
         }
     }
 
-    Mesh Model::processMesh(aiMesh * mesh, const aiScene * scene, aiString & directory) const
+    Mesh Model::processMesh(aiMesh * mesh, const ModelImport & imported, aiString & directory) const
     {
         VertexBuffers buffers;
         Mesh ve_mesh;
@@ -95,12 +167,12 @@ namespace Vertex
         /* Process textures */
         if (mesh->mMaterialIndex >= 0)
         {
-            aiMaterial * material = scene->mMaterials[mesh->mMaterialIndex];
+            aiMaterial * material = imported.m_scene->mMaterials[mesh->mMaterialIndex];
 
-            loadMaterialTextures(ve_mesh, material, aiTextureType_DIFFUSE,  Material::TextureType::DIFFUSE,  directory);
-            loadMaterialTextures(ve_mesh, material, aiTextureType_HEIGHT,   Material::TextureType::NORMAL,   directory);
-            loadMaterialTextures(ve_mesh, material, aiTextureType_NORMALS,  Material::TextureType::NORMAL,   directory);
-            loadMaterialTextures(ve_mesh, material, aiTextureType_SPECULAR, Material::TextureType::SPECULAR, directory);
+            loadMaterialTextures(ve_mesh, material, aiTextureType_DIFFUSE,  Material::TextureType::DIFFUSE,  imported, directory);
+            loadMaterialTextures(ve_mesh, material, aiTextureType_HEIGHT,   Material::TextureType::NORMAL,   imported, directory);
+            loadMaterialTextures(ve_mesh, material, aiTextureType_NORMALS,  Material::TextureType::NORMAL,   imported, directory);
+            loadMaterialTextures(ve_mesh, material, aiTextureType_SPECULAR, Material::TextureType::SPECULAR, imported, directory);
         }
 
         /* Feed Vertex Engine's Mesh with data */
@@ -109,7 +181,7 @@ namespace Vertex
         return ve_mesh;
     }
 
-    void Model::loadMaterialTextures(Mesh & mesh, aiMaterial * mat, aiTextureType type, Material::TextureType texture_type, aiString & directory) const
+    void Model::loadMaterialTextures(Mesh & mesh, aiMaterial * mat, aiTextureType type, Material::TextureType texture_type, const ModelImport & imported, aiString & directory) const
     {
         GLuint texturesCount = mat->GetTextureCount(type);
 
@@ -117,19 +189,18 @@ namespace Vertex
         {
             for (GLuint i = 0; i < texturesCount; ++i)
             {
-                aiString str, fullPath(directory);
-                mat->GetTexture(type, i, &str);
+                std::string path = texturePath(mat, type, i, directory);
+                auto decoded     = imported.m_textures.find(path);
 
-                fullPath.Append("/");
-                fullPath.Append(str.C_Str());
-
-                auto texture = CoreAssetManager::createTexture2D(fullPath.C_Str(), type == aiTextureType_DIFFUSE);
+                /* Decoded by import() unless CoreAssetManager had it loaded already */
+                auto texture = decoded != imported.m_textures.end() ? CoreAssetManager::createTexture2D(*decoded->second, type == aiTextureType_DIFFUSE)
+                                                                    : CoreAssetManager::createTexture2D(path, type == aiTextureType_DIFFUSE);
                 mesh.m_material.addTexture(texture_type, texture);
             }
         }
     }
 
-    void Model::calcTangentSpace(VertexBuffers & buffers) const
+    void Model::calcTangentSpace(VertexBuffers & buffers)
     {
         for(unsigned i = 0; i < buffers.m_vertices.size(); ++i)
         {
@@ -174,12 +245,12 @@ namespace Vertex
         calcTangentSpace(buffers);
         mesh.setBuffers(buffers);
 
-        if(m_meshes.size() > 0)
+        if(m_meshes->size() > 0)
         {
             return;
         }
 
-        m_meshes.push_back(mesh);
+        mutableMeshes().push_back(mesh);
     }
 
     void Model::genCone(float height, float radius, unsigned int slices, unsigned int stacks)
@@ -236,23 +307,46 @@ namespace Vertex
         GeomPrimitive::genQuad(buffers, width, height);
 
         genPrimitive(buffers);
-        m_meshes[m_meshes.size() - 1].setDrawMode(GL_TRIANGLE_STRIP);
+        m_meshes->back().setDrawMode(GL_TRIANGLE_STRIP);
+    }
+
+    void Model::getBounds(glm::vec3 & min, glm::vec3 & max) const
+    {
+        bool has_bounds = false;
+
+        min = glm::vec3(0.0f);
+        max = glm::vec3(0.0f);
+
+        for (auto & mesh : *m_meshes)
+        {
+            glm::vec3 mesh_min, mesh_max;
+
+            if (!mesh.getBounds(mesh_min, mesh_max))
+            {
+                continue;
+            }
+
+            min = has_bounds ? glm::min(min, mesh_min) : mesh_min;
+            max = has_bounds ? glm::max(max, mesh_max) : mesh_max;
+            has_bounds = true;
+        }
     }
 
     void Model::render(Shader & shader)
     {
-        for(unsigned i = 0; i < m_meshes.size(); ++i)
+        for (auto & mesh : *m_meshes)
         {
-            shader.updateUniforms(m_meshes[i].m_material);
-            m_meshes[i].render();
+            shader.updateUniforms(mesh.m_material);
+            mesh.render();
         }
     }
 
     void Model::setDrawMode(GLenum draw_mode)
     {
-        for(unsigned i = 0; i < m_meshes.size(); ++i)
+        /* The draw mode is kept by the mesh data, which the copies of the meshes share anyway */
+        for (auto & mesh : *m_meshes)
         {
-            m_meshes[i].setDrawMode(draw_mode);
+            mesh.setDrawMode(draw_mode);
         }
     }
 }
@@ -0,0 +1,80 @@
+#include "framework/rendering/RenderProxies.h"
+
+#include <algorithm>
+
+namespace Vertex
+{
+    const uint32_t RenderProxies::INVALID_PROXY;
+
+    void RenderProxies::update(const RenderProxy & proxy)
+    {
+        if (proxy.m_index >= m_proxies_indices.size())
+        {
+            m_proxies_indices.resize(proxy.m_index + 1, INVALID_PROXY);
+        }
+
+        uint32_t & proxy_index = m_proxies_indices[proxy.m_index];
+
+        if (proxy_index == INVALID_PROXY)
+        {
+            proxy_index = uint32_t(m_proxies.size());
+            m_proxies.push_back(proxy);
+
+            m_is_order_dirty = true;
+            return;
+        }
+
+        RenderProxy & current = m_proxies[proxy_index];
+
+        if (current.m_item.m_sort_key != proxy.m_item.m_sort_key)
+        {
+            m_is_order_dirty = true;
+        }
+
+        current = proxy;
+    }
+
+    void RenderProxies::remove(uint32_t index, uint64_t id)
+    {
+        if (index >= m_proxies_indices.size() || m_proxies_indices[index] == INVALID_PROXY)
+        {
+            return;
+        }
+
+        const uint32_t proxy_index = m_proxies_indices[index];
+
+        if (m_proxies[proxy_index].m_id != id)
+        {
+            return;
+        }
+
+        /* The last proxy takes the removed one's place, sort() puts it back */
+        m_proxies[proxy_index] = m_proxies.back();
+        m_proxies_indices[m_proxies[proxy_index].m_index] = proxy_index;
+
+        m_proxies.pop_back();
+        m_proxies_indices[index] = INVALID_PROXY;
+
+        m_is_order_dirty = true;
+    }
+
+    void RenderProxies::sort()
+    {
+        if (!m_is_order_dirty)
+        {
+            return;
+        }
+
+        std::stable_sort(m_proxies.begin(), m_proxies.end(), [](const RenderProxy & lhs, const RenderProxy & rhs)
+        {
+            return lhs.m_item.m_sort_key < rhs.m_item.m_sort_key;
+        });
+
+        for (uint32_t i = 0; i < uint32_t(m_proxies.size()); ++i)
+        {
+            m_proxies_indices[m_proxies[i].m_index] = i;
+        }
+
+        m_is_order_dirty = false;
+    }
+}
@@ -5,7 +5,7 @@
 #include "core_engine/CoreAssetManager.h"
 #include "framework/utilities/Util.h"
 #include "framework/utilities/ShaderGlobals.h"
-#include "core_engine/CoreServices.h"
+#include "framework/window/Window.h"
 
 namespace Vertex
 {
@@ -13,6 +13,12 @@ namespace Vertex
         : m_program_id(0),
           m_is_linked(false)
     {
+        /* No program object without GL context, the shader only keeps its name in the asset manager */
+        if (Window::isHeadless())
+        {
+            return;
+        }
+
         m_program_id = glCreateProgram();
 
         if (m_program_id == 0)
@@ -165,17 +171,17 @@ namespace Vertex
             {
                 m_global_uniforms_types.push_back(values[1]);
                 m_global_uniforms_names.push_back(uniform_name);
-                m_uniforms_locations[uniform_name] = values[3];
+                m_uniforms_locations.insert(uniform_name, values[3]);
             }
             else if(SKIP_UNIFORM_PREFIX == prefix)
             {
-                m_uniforms_locations[uniform_name] = values[3];
+                m_uniforms_locations.insert(uniform_name, values[3]);
             }
             else
             {
                 m_uniforms_types.push_back(values[1]);
                 m_uniforms_names.push_back(uniform_name);
-                m_uniforms_locations[uniform_name] = values[3];
+                m_uniforms_locations.insert(uniform_name, values[3]);
             }
         }
     }
@@ -214,13 +220,18 @@ namespace Vertex
 
                 GLuint subroutine_index = glGetSubroutineIndex(m_program_id, shader_stages[i], subroutine_name.c_str());
 
-                m_subroutine_indices[subroutine_name] = subroutine_index;
+                m_subroutine_indices.insert(subroutine_name, subroutine_index);
             }
         }
     }
 
     bool Shader::link()
     {
+        if (m_program_id == 0)
+        {
+            return m_is_linked;
+        }
+
         glLinkProgram(m_program_id);
 
         GLint status;
@@ -262,11 +273,11 @@ namespace Vertex
         }
     }
 
-    void Shader::updateUniforms(Material & material)
+    void Shader::updateUniforms(const Material & material)
     {
         for(unsigned i = 0; i < m_uniforms_names.size(); ++i)
         {
-            auto uniform_name = m_uniforms_names[i];
+            const auto & uniform_name = m_uniforms_names[i];
             auto uniform_type = m_uniforms_types[i];
 
             switch(uniform_type)
@@ -307,11 +318,14 @@ namespace Vertex
         }
     }
 
-    void Shader::updateGlobalUniforms(const TransformComponent & transform)
+    void Shader::updateGlobalUniforms(const glm::mat4 & world_matrix,
+                                      const glm::mat3 & normal_matrix,
+                                      const glm::mat4 & view_projection,
+                                      const glm::vec3 & camera_position)
     {
         for(unsigned i = 0; i < m_global_uniforms_names.size(); ++i)
         {
-            auto uniform_name = m_global_uniforms_names[i];
+            const auto & uniform_name = m_global_uniforms_names[i];
             auto uniform_type = m_global_uniforms_types[i];
 
             switch(uniform_type)
@@ -320,16 +334,12 @@ namespace Vertex
                 {
                     if (G_MVP == uniform_name)
                     {
-                        auto view = CoreServices::getRenderer()->getCamera()->m_view;
-                        auto projection = CoreServices::getRenderer()->getCamera()->m_projection;
-
-                        auto mvp = projection * view * transform.world_matrix();
-                        setUniform(G_MVP, mvp);
+                        setUniform(G_MVP, view_projection * world_matrix);
                     }
                     else
                     if (G_MODEL_MATRIX == uniform_name)
                     {
-                        setUniform(G_MODEL_MATRIX, transform.world_matrix());
+                        setUniform(G_MODEL_MATRIX, world_matrix);
                     }
                     break;
                 }
@@ -337,7 +347,7 @@ namespace Vertex
                 {
                     if (G_NORMAL_MATRIX == uniform_name)
                     {
-                        setUniform(G_NORMAL_MATRIX, transform.normal_matrix());
+                        setUniform(G_NORMAL_MATRIX, normal_matrix);
                     }
                     break;
                 }
@@ -345,211 +355,173 @@ namespace Vertex
                 {
                     if (G_CAM_POS == uniform_name)
                     {
-                        setUniform(G_CAM_POS, CoreServices::getRenderer()->getCameraTransform()->position());
+                        setUniform(G_CAM_POS, camera_position);
                     }
                 }
             }
         }
     }
 
-    bool Shader::getUniformLocation(const std::string & uniform_name)
+    GLint Shader::findUniformLocation(const UniformName & uniform_name)
     {
-        GLint uniform_location = glGetUniformLocation(m_program_id, uniform_name.c_str());
+        if (GLint * location = m_uniforms_locations.find(uniform_name))
+        {
+            return *location;
+        }
 
-        if (uniform_location != -1)
+        if (m_program_id == 0)
         {
-            m_uniforms_locations[uniform_name] = uniform_location;
-            return true;
+            return -1;
         }
-        else
+
+        GLint uniform_location = glGetUniformLocation(m_program_id, uniform_name.m_name);
+
+        /* Missing uniforms are remembered too, so the error is printed only once */
+        m_uniforms_locations.insert(uniform_name, uniform_location);
+
+        if (uniform_location == -1)
         {
-            fprintf(stderr, "Error! Can't find uniform %s\n", uniform_name.c_str());
-            return false;
+            fprintf(stderr, "Error! Can't find uniform %s\n", uniform_name.m_name);
         }
+
+        return uniform_location;
     }
 
-    void Shader::setUniform(const std::string & uniformName, float value)
+    void Shader::setUniform(const UniformName & uniformName, float value)
     {
-        if (m_uniforms_locations.count(uniformName))
-        {
-            glProgramUniform1f(m_program_id, m_uniforms_locations[uniformName], value);
-        }
-        else
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniform1f(m_program_id, m_uniforms_locations[uniformName], value);
-            }
+            glProgramUniform1f(m_program_id, location, value);
         }
     }
 
-    void Shader::setUniform(const std::string & uniformName, int value)
+    void Shader::setUniform(const UniformName & uniformName, int value)
     {
-        if (m_uniforms_locations.count(uniformName))
-        {
-            glProgramUniform1i(m_program_id, m_uniforms_locations[uniformName], value);
-        }
-        else
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniform1i(m_program_id, m_uniforms_locations[uniformName], value);
-            }
+            glProgramUniform1i(m_program_id, location, value);
         }
     }
 
-    void Shader::setUniform(const std::string & uniformName, unsigned int value)
+    void Shader::setUniform(const UniformName & uniformName, unsigned int value)
     {
-        if (m_uniforms_locations.count(uniformName))
-        {
-            glProgramUniform1ui(m_program_id, m_uniforms_locations.at(uniformName), value);
-        }
-        else
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniform1ui(m_program_id, m_uniforms_locations[uniformName], value);
-            }
+            glProgramUniform1ui(m_program_id, location, value);
         }
     }
 
-    void Shader::setUniform(const std::string & uniformName, GLsizei count, float * value)
+    void Shader::setUniform(const UniformName & uniformName, GLsizei count, float * value)
     {
-        if (m_uniforms_locations.count(uniformName))
-        {
-            glProgramUniform1fv(m_program_id, m_uniforms_locations[uniformName], count, value);
-        }
-        else
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniform1fv(m_program_id, m_uniforms_locations[uniformName], count, value);
-            }
+            glProgramUniform1fv(m_program_id, location, count, value);
         }
     }
 
-    void Shader::setUniform(const std::string & uniformName, GLsizei count, int * value)
+    void Shader::setUniform(const UniformName & uniformName, GLsizei count, int * value)
     {
-        if (m_uniforms_locations.count(uniformName))
-        {
-            glProgramUniform1iv(m_program_id, m_uniforms_locations[uniformName], count, value);
-        }
-        else
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniform1iv(m_program_id, m_uniforms_locations[uniformName], count, value);
-            }
+            glProgramUniform1iv(m_program_id, location, count, value);
         }
     }
 
-    void Shader::setUniform(const std::string & uniformName, GLsizei count, glm::vec3 * vectors)
+    void Shader::setUniform(const UniformName & uniformName, GLsizei count, glm::vec3 * vectors)
     {
-        if (m_uniforms_locations.count(uniformName))
-        {
-            glProgramUniform3fv(m_program_id, m_uniforms_locations[uniformName], count, glm::value_ptr(vectors[0]));
-        }
-        else
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniform3fv(m_program_id, m_uniforms_locations[uniformName], count, glm::value_ptr(vectors[0]));
-            }
+            glProgramUniform3fv(m_program_id, location, count, glm::value_ptr(vectors[0]));
         }
     }
 
-    void Shader::setUniform(const std::string & uniformName, const glm::vec2 & vector)
+    void Shader::setUniform(const UniformName & uniformName, const glm::vec2 & vector)
     {
-        if (m_uniforms_locations.count(uniformName))
-        {
-            glProgramUniform2fv(m_program_id, m_uniforms_locations[uniformName], 1, glm::value_ptr(vector));
-        }
-        else
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniform2fv(m_program_id, m_uniforms_locations[uniformName], 1, glm::value_ptr(vector));
-            }
+            glProgramUniform2fv(m_program_id, location, 1, glm::value_ptr(vector));
         }
     }
 
-    void Shader::setUniform(const std::string & uniformName, const glm::vec3 & vector)
+    void Shader::setUniform(const UniformName & uniformName, const glm::vec3 & vector)
     {
-        if (m_uniforms_locations.count(uniformName))
-        {
-            glProgramUniform3fv(m_program_id, m_uniforms_locations[uniformName], 1, glm::value_ptr(vector));
-        }
-        else
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniform3fv(m_program_id, m_uniforms_locations[uniformName], 1, glm::value_ptr(vector));
-            }
+            glProgramUniform3fv(m_program_id, location, 1, glm::value_ptr(vector));
         }
     }
 
-    void Shader::setUniform(const std::string & uniformName, const glm::vec4 & vector)
+    void Shader::setUniform(const UniformName & uniformName, const glm::vec4 & vector)
     {
-        if (m_uniforms_locations.count(uniformName))
-        {
-            glProgramUniform4fv(m_program_id, m_uniforms_locations[uniformName], 1, glm::value_ptr(vector));
-        }
-        else
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniform4fv(m_program_id, m_uniforms_locations[uniformName], 1, glm::value_ptr(vector));
-            }
+            glProgramUniform4fv(m_program_id, location, 1, glm::value_ptr(vector));
         }
     }
 
-    void Shader::setUniform(const std::string & uniformName, const glm::mat3 & matrix)
+    void Shader::setUniform(const UniformName & uniformName, const glm::mat3 & matrix)
     {
-        if (m_uniforms_locations.count(uniformName))
-        {
-            glProgramUniformMatrix3fv(m_program_id, m_uniforms_locations[uniformName], 1, GL_FALSE, glm::value_ptr(matrix));
-        }
-        else
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniformMatrix3fv(m_program_id, m_uniforms_locations[uniformName], 1, GL_FALSE, glm::value_ptr(matrix));
-            }
+            glProgramUniformMatrix3fv(m_program_id, location, 1, GL_FALSE, glm::value_ptr(matrix));
         }
     }
 
-    void Shader::setUniform(const std::string & uniformName, const glm::mat4 & matrix)
+    void Shader::setUniform(const UniformName & uniformName, const glm::mat4 & matrix)
     {
-        if (m_uniforms_locations.count(uniformName))
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            glProgramUniformMatrix4fv(m_program_id, m_uniforms_locations[uniformName], 1, GL_FALSE, glm::value_ptr(matrix));
+            glProgramUniformMatrix4fv(m_program_id, location, 1, GL_FALSE, glm::value_ptr(matrix));
         }
-        else
+    }
+
+    void Shader::setUniform(const UniformName & uniformName, glm::mat4 * matrices, unsigned count)
+    {
+        GLint location = findUniformLocation(uniformName);
+
+        if (location != -1)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniformMatrix4fv(m_program_id, m_uniforms_locations[uniformName], 1, GL_FALSE, glm::value_ptr(matrix));
-            }
+            glProgramUniformMatrix4fv(m_program_id, location, count, GL_FALSE, &matrices[0][0][0]);
         }
     }
 
-    void Shader::setUniform(const std::string & uniformName, glm::mat4 * matrices, unsigned count)
+    void Shader::setSubroutine(Type shader_type, const UniformName & subroutine_name)
     {
-        if (m_uniforms_locations.count(uniformName))
+        if (m_program_id == 0)
         {
-            glProgramUniformMatrix4fv(m_program_id, m_uniforms_locations[uniformName], count, GL_FALSE, &matrices[0][0][0]);
+            return;
         }
-        else
+
+        const GLuint * subroutine_index = m_subroutine_indices.find(subroutine_name);
+
+        if (subroutine_index == nullptr)
         {
-            if (getUniformLocation(uniformName))
-            {
-                glProgramUniformMatrix4fv(m_program_id, m_uniforms_locations[uniformName], count, GL_FALSE, &matrices[0][0][0]);
-            }
+            fprintf(stderr, "Error! Can't find subroutine %s\n", subroutine_name.m_name);
+            return;
         }
-    }
 
-    void Shader::setSubroutine(Type shader_type, const std::string & subroutine_name)
-    {
-        glUniformSubroutinesuiv(GLenum(shader_type), m_active_subroutine_uniform_locations[GLenum(shader_type)], &m_subroutine_indices[subroutine_name]);
+        glUniformSubroutinesuiv(GLenum(shader_type), m_active_subroutine_uniform_locations[GLenum(shader_type)], subroutine_index);
     }
 }
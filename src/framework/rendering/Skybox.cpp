@@ -1,6 +1,7 @@
 #include "framework/rendering/Skybox.h"
 #include "framework/rendering/Mesh.h"
 #include "framework/utilities/GeomPrimitive.h"
+#include "framework/window/Window.h"
 
 namespace Vertex
 {
@@ -11,7 +12,9 @@ namespace Vertex
                    const std::string & down_face,
                    const std::string & front_face,
                    const std::string & back_face)
-        : m_world(glm::mat4(1.0f))
+        : m_world(glm::mat4(1.0f)),
+          m_vao_id(0),
+          m_vbo_id(0)
     {
         /* Create cubemap texture object */
         std::string filenames[6] = { 
@@ -28,6 +31,11 @@ namespace Vertex
         m_skybox_shader = CoreAssetManager::createShader("Skybox", "Skybox.vert", "Skybox.frag");
         m_skybox_shader->link();
 
+        if (Window::isHeadless())
+        {
+            return;
+        }
+
         /* Create buffer objects */
         glCreateVertexArrays(1, &m_vao_id);
         glCreateBuffers(1, &m_vbo_id);
@@ -1,5 +1,6 @@
 #include "framework/rendering/Texture.h"
 #include "framework/utilities/Util.h"
+#include "framework/window/Window.h"
 #include <iostream>
 #include <glm/common.hpp>
 #include <glm/exponential.hpp>
@@ -24,16 +25,50 @@ namespace Vertex
         }
     }
 
-    void Texture::genTexture2D(const std::string & filename, GLuint num_mipmaps, bool is_srgb)
+    TextureImport::~TextureImport()
+    {
+        if (m_pixels)
+        {
+            stbi_image_free(m_pixels);
+        }
+    }
+
+    std::shared_ptr<TextureImport> Texture::import(const std::string & filename)
     {
-        /* Pointer to the image */
-        unsigned char* data = Util::loadTexture(filename, m_tex_data);
+        auto imported = std::make_shared<TextureImport>();
+        imported->m_filename = filename;
+
+        if (Window::isHeadless())
+        {
+            return imported;
+        }
+
+        imported->m_pixels = Util::loadTexture(filename, imported->m_image_data);
 
-        if(!data)
+        if (!imported->m_pixels)
         {
             std::cout << "Could not load texture " << filename << std::endl;
         }
 
+        return imported;
+    }
+
+    void Texture::genTexture2D(const std::string & filename, GLuint num_mipmaps, bool is_srgb)
+    {
+        genTexture2D(*import(filename), num_mipmaps, is_srgb);
+    }
+
+    void Texture::genTexture2D(const TextureImport & imported, GLuint num_mipmaps, bool is_srgb)
+    {
+        if (Window::isHeadless())
+        {
+            genHeadless(&imported.m_filename, 1, GL_TEXTURE_2D, num_mipmaps, is_srgb);
+            return;
+        }
+
+        const unsigned char * data = imported.m_pixels;
+        m_tex_data = imported.m_image_data;
+
         m_to_type = GL_TEXTURE_2D;
         m_format  = m_tex_data.channels == 4 ? GL_RGBA : GL_RGB;
         m_internal_format = is_srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
@@ -66,9 +101,6 @@ namespace Vertex
         glTextureParameteri(m_to_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTextureParameteri(m_to_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTextureParameteri(m_to_id, GL_TEXTURE_MAX_ANISOTROPY, 16); // TODO anisotropy as Renderer parameter
-
-        /* Release image data */
-        stbi_image_free(data);
     }
 
     void Texture::genTexture2D1x1(const glm::uvec4 & color)
@@ -81,6 +113,11 @@ namespace Vertex
         m_format          = GL_RGBA;
         m_internal_format = GL_RGBA8;
 
+        if (Window::isHeadless())
+        {
+            return;
+        }
+
         GLubyte pixel_data[] = { static_cast<GLubyte>(color.r),
                                  static_cast<GLubyte>(color.g),
                                  static_cast<GLubyte>(color.b),
@@ -114,6 +151,12 @@ namespace Vertex
     {
         const int numCubeFaces = 6;
 
+        if (Window::isHeadless())
+        {
+            genHeadless(filenames, numCubeFaces, GL_TEXTURE_CUBE_MAP, num_mipmaps, is_srgb);
+            return;
+        }
+
         /* Pointer to the image data */
         unsigned char * imgs_data[numCubeFaces];
 
@@ -168,6 +211,25 @@ namespace Vertex
         }
     }
 
+    void Texture::genHeadless(const std::string * filenames, int files_count, GLenum type, GLuint num_mipmaps, bool is_srgb)
+    {
+        /* Keeps the same metadata as the GL path, without decoding the pixels */
+        for (int i = 0; i < files_count; ++i)
+        {
+            if (!Util::loadTextureInfo(filenames[i], m_tex_data))
+            {
+                std::cout << "Could not load texture " << filenames[i] << std::endl;
+            }
+        }
+
+        m_to_type         = type;
+        m_format          = m_tex_data.channels == 4 ? GL_RGBA : GL_RGB;
+        m_internal_format = is_srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+
+        const GLuint max_num_mipmaps = 1 + glm::floor(glm::log2(glm::max(glm::max(float(m_tex_data.width), float(m_tex_data.height)), 1.0f)));
+        m_num_mipmaps = glm::clamp(num_mipmaps, 1u, max_num_mipmaps);
+    }
+
     void Texture::bind(GLuint unit) const
     {
         glBindTextureUnit(unit, m_to_id);
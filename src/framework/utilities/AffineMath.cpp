@@ -0,0 +1,167 @@
+#include "framework/utilities/AffineMath.h"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#if defined(__AVX__)
+    #define VE_AFFINE_AVX
+    #include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define VE_AFFINE_SSE
+    #include <xmmintrin.h>
+#endif
+
+namespace Vertex
+{
+    namespace
+    {
+        /* Columns of glm::mat4 are four contiguous floats */
+        inline void multiplyAffine(const float * lhs, const float * rhs, float * result)
+        {
+#if defined(VE_AFFINE_AVX)
+            const __m256 lhs0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs));
+            const __m256 lhs1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs + 4));
+            const __m256 lhs2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs + 8));
+            const __m256 lhs3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs + 12));
+
+            /* Two columns at once, the w of rhs columns is 0, 0, 0, 1 */
+            for (int column = 0; column < 16; column += 8)
+            {
+                const __m256 rhs_columns = _mm256_loadu_ps(rhs + column);
+
+                __m256 sum = _mm256_mul_ps(lhs0, _mm256_permute_ps(rhs_columns, 0x00));
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(lhs1, _mm256_permute_ps(rhs_columns, 0x55)));
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(lhs2, _mm256_permute_ps(rhs_columns, 0xAA)));
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(lhs3, _mm256_permute_ps(rhs_columns, 0xFF)));
+
+                _mm256_storeu_ps(result + column, sum);
+            }
+#elif defined(VE_AFFINE_SSE)
+            const __m128 lhs0 = _mm_loadu_ps(lhs);
+            const __m128 lhs1 = _mm_loadu_ps(lhs + 4);
+            const __m128 lhs2 = _mm_loadu_ps(lhs + 8);
+            const __m128 lhs3 = _mm_loadu_ps(lhs + 12);
+
+            for (int column = 0; column < 12; column += 4)
+            {
+                __m128 sum = _mm_mul_ps(lhs0, _mm_set1_ps(rhs[column]));
+                sum = _mm_add_ps(sum, _mm_mul_ps(lhs1, _mm_set1_ps(rhs[column + 1])));
+                sum = _mm_add_ps(sum, _mm_mul_ps(lhs2, _mm_set1_ps(rhs[column + 2])));
+
+                _mm_storeu_ps(result + column, sum);
+            }
+
+            __m128 translation = _mm_mul_ps(lhs0, _mm_set1_ps(rhs[12]));
+            translation = _mm_add_ps(translation, _mm_mul_ps(lhs1, _mm_set1_ps(rhs[13])));
+            translation = _mm_add_ps(translation, _mm_mul_ps(lhs2, _mm_set1_ps(rhs[14])));
+            translation = _mm_add_ps(translation, lhs3);
+
+            _mm_storeu_ps(result + 12, translation);
+#else
+            for (int column = 0; column < 16; column += 4)
+            {
+                for (int row = 0; row < 4; ++row)
+                {
+                    float sum = lhs[row] * rhs[column] + lhs[4 + row] * rhs[column + 1] + lhs[8 + row] * rhs[column + 2];
+                    result[column + row] = column == 12 ? sum + lhs[12 + row] : sum;
+                }
+            }
+#endif
+        }
+    }
+
+    glm::mat4 AffineMath::composeTRS(const glm::vec3 & position, const glm::quat & orientation, const glm::vec3 & scale)
+    {
+        const float xx = orientation.x * orientation.x;
+        const float yy = orientation.y * orientation.y;
+        const float zz = orientation.z * orientation.z;
+        const float xy = orientation.x * orientation.y;
+        const float xz = orientation.x * orientation.z;
+        const float yz = orientation.y * orientation.z;
+        const float wx = orientation.w * orientation.x;
+        const float wy = orientation.w * orientation.y;
+        const float wz = orientation.w * orientation.z;
+
+        glm::mat4 result;
+
+        result[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * scale.x, 2.0f * (xy + wz) * scale.x, 2.0f * (xz - wy) * scale.x, 0.0f);
+        result[1] = glm::vec4(2.0f * (xy - wz) * scale.y, (1.0f - 2.0f * (xx + zz)) * scale.y, 2.0f * (yz + wx) * scale.y, 0.0f);
+        result[2] = glm::vec4(2.0f * (xz + wy) * scale.z, 2.0f * (yz - wx) * scale.z, (1.0f - 2.0f * (xx + yy)) * scale.z, 0.0f);
+        result[3] = glm::vec4(position, 1.0f);
+
+        return result;
+    }
+
+    glm::mat4 AffineMath::composeRT(const glm::quat & orientation, const glm::vec3 & translation)
+    {
+        glm::mat4 result = composeTRS(glm::vec3(0.0f), orientation, glm::vec3(1.0f));
+        result[3] = glm::vec4(glm::vec3(result[0]) * translation.x +
+                              glm::vec3(result[1]) * translation.y +
+                              glm::vec3(result[2]) * translation.z, 1.0f);
+
+        return result;
+    }
+
+    glm::mat4 AffineMath::multiply(const glm::mat4 & lhs, const glm::mat4 & rhs)
+    {
+        glm::mat4 result;
+        multiplyAffine(&lhs[0][0], &rhs[0][0], &result[0][0]);
+
+        return result;
+    }
+
+    void AffineMath::multiply(const glm::mat4 * lhs, const glm::mat4 * rhs, glm::mat4 * result, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            multiplyAffine(&lhs[i][0][0], &rhs[i][0][0], &result[i][0][0]);
+        }
+    }
+
+    void AffineMath::multiply(const glm::mat4 & lhs, const glm::mat4 * rhs, glm::mat4 * result, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            multiplyAffine(&lhs[0][0], &rhs[i][0][0], &result[i][0][0]);
+        }
+    }
+
+    glm::mat3 AffineMath::normalMatrix(const glm::mat4 & affine)
+    {
+        const glm::vec3 column0(affine[0]);
+        const glm::vec3 column1(affine[1]);
+        const glm::vec3 column2(affine[2]);
+
+        /* Cofactor matrix divided by the determinant */
+        glm::mat3 cofactors(glm::cross(column1, column2),
+                            glm::cross(column2, column0),
+                            glm::cross(column0, column1));
+
+        const float inverse_determinant = 1.0f / glm::dot(column0, cofactors[0]);
+
+        return cofactors * inverse_determinant;
+    }
+
+    glm::mat3 AffineMath::normalMatrixUniform(const glm::mat4 & affine)
+    {
+        /* inverse(s * R)^T = (s * R) / s^2 */
+        const glm::mat3 rotation_scale(affine);
+
+        return rotation_scale * (1.0f / glm::dot(rotation_scale[0], rotation_scale[0]));
+    }
+
+    void AffineMath::transformBounds(const glm::mat4 & affine, const glm::vec3 & min, const glm::vec3 & max, glm::vec3 & result_min, glm::vec3 & result_max)
+    {
+        /* Center moves with the matrix, the extents grow by the absolute values of the rotation and scale */
+        const glm::vec3 center  = (min + max) * 0.5f;
+        const glm::vec3 extents = (max - min) * 0.5f;
+
+        const glm::vec3 world_center = glm::vec3(affine[3]) + glm::vec3(affine[0]) * center.x + glm::vec3(affine[1]) * center.y + glm::vec3(affine[2]) * center.z;
+        const glm::vec3 world_extents = glm::abs(glm::vec3(affine[0])) * extents.x +
+                                        glm::abs(glm::vec3(affine[1])) * extents.y +
+                                        glm::abs(glm::vec3(affine[2])) * extents.z;
+
+        result_min = world_center - world_extents;
+        result_max = world_center + world_extents;
+    }
+}
@@ -0,0 +1,227 @@
+#include "framework/utilities/AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+    #include <malloc.h>
+#endif
+
+#ifdef VE_ENABLE_ALLOCATION_COUNTER
+
+namespace
+{
+    /* Constant initialized, so it's usable by allocations made before main() */
+    std::atomic<uint64_t> g_allocations_count(0);
+
+    /* Alignment 0 is malloc's own one */
+    void * tryAllocate(size_t size, size_t alignment)
+    {
+        if (alignment == 0)
+        {
+            return malloc(size);
+        }
+
+#ifdef _MSC_VER
+        return _aligned_malloc(size, alignment);
+#else
+        void * ptr = nullptr;
+        return posix_memalign(&ptr, alignment, size) == 0 ? ptr : nullptr;
+#endif
+    }
+
+#ifdef __cpp_aligned_new
+    /* _aligned_malloc() memory can't be freed with free() */
+    void freeAligned(void * ptr)
+    {
+#ifdef _MSC_VER
+        _aligned_free(ptr);
+#else
+        free(ptr);
+#endif
+    }
+#endif
+
+    /* The new_handler may free some memory, so it's called until the allocation succeeds or there's none */
+    void * allocate(size_t size, size_t alignment = 0)
+    {
+        if (size == 0)
+        {
+            size = 1;
+        }
+
+        void * ptr;
+
+        while ((ptr = tryAllocate(size, alignment)) == nullptr)
+        {
+            std::new_handler handler = std::get_new_handler();
+
+            if (!handler)
+            {
+                throw std::bad_alloc();
+            }
+
+            handler();
+        }
+
+        return ptr;
+    }
+
+    void * allocateNoThrow(size_t size, size_t alignment = 0) noexcept
+    {
+        try
+        {
+            return allocate(size, alignment);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+}
+
+void * operator new(size_t size)
+{
+    g_allocations_count.fetch_add(1, std::memory_order_relaxed);
+
+    return allocate(size);
+}
+
+void * operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    g_allocations_count.fetch_add(1, std::memory_order_relaxed);
+
+    return allocateNoThrow(size);
+}
+
+void * operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void * ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void * ptr, const std::nothrow_t &) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept
+{
+    free(ptr);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void * ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void * ptr, size_t) noexcept
+{
+    free(ptr);
+}
+#endif
+
+/* Over-aligned types of the C++17 code, the engine itself is built with -faligned-new to have them */
+#ifdef __cpp_aligned_new
+void * operator new(size_t size, std::align_val_t alignment)
+{
+    g_allocations_count.fetch_add(1, std::memory_order_relaxed);
+
+    return allocate(size, size_t(alignment));
+}
+
+void * operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void * operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    g_allocations_count.fetch_add(1, std::memory_order_relaxed);
+
+    return allocateNoThrow(size, size_t(alignment));
+}
+
+void * operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return operator new(size, alignment, std::nothrow);
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    freeAligned(ptr);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void * ptr, size_t, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+
+void operator delete[](void * ptr, size_t, std::align_val_t) noexcept
+{
+    freeAligned(ptr);
+}
+#endif
+#endif
+
+namespace Vertex
+{
+    uint64_t AllocationCounter::getCount()
+    {
+        return g_allocations_count.load(std::memory_order_relaxed);
+    }
+
+    bool AllocationCounter::isEnabled()
+    {
+        return true;
+    }
+}
+
+#else
+
+namespace Vertex
+{
+    uint64_t AllocationCounter::getCount()
+    {
+        return 0;
+    }
+
+    bool AllocationCounter::isEnabled()
+    {
+        return false;
+    }
+}
+
+#endif
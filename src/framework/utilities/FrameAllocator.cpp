@@ -0,0 +1,151 @@
+#include "framework/utilities/FrameAllocator.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace Vertex
+{
+    /*
+     * A chain of blocks. When a frame didn't fit in the first block, the next reset
+     * replaces the chain with a single block big enough for the whole frame.
+     */
+    class FrameAllocator::Arena
+    {
+    public:
+        static const size_t MIN_BLOCK_SIZE = 256 * 1024;
+
+        Arena()
+            : m_offset(0),
+              m_used_bytes(0)
+        {}
+
+        void * allocate(size_t size, size_t alignment)
+        {
+            if (m_blocks.empty())
+            {
+                addBlock(std::max(size + alignment, size_t(MIN_BLOCK_SIZE)));
+            }
+
+            Block & block = m_blocks.back();
+
+            uintptr_t base    = reinterpret_cast<uintptr_t>(block.m_memory.get());
+            uintptr_t aligned = (base + m_offset + alignment - 1) & ~uintptr_t(alignment - 1);
+
+            if (aligned + size > base + block.m_size)
+            {
+                addBlock(std::max(size + alignment, block.m_size * 2));
+                return allocate(size, alignment);
+            }
+
+            m_offset      = size_t(aligned + size - base);
+            m_used_bytes += size;
+
+            return reinterpret_cast<void *>(aligned);
+        }
+
+        void reset()
+        {
+            if (m_blocks.size() > 1)
+            {
+                size_t total_size = 0;
+                for (auto & block : m_blocks)
+                {
+                    total_size += block.m_size;
+                }
+
+                m_blocks.clear();
+                addBlock(total_size);
+            }
+
+            m_offset     = 0;
+            m_used_bytes = 0;
+        }
+
+        size_t getUsedBytes() const { return m_used_bytes; }
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<unsigned char[]> m_memory;
+            size_t                           m_size;
+        };
+
+        void addBlock(size_t size)
+        {
+            Block block = { std::unique_ptr<unsigned char[]>(new unsigned char[size]), size };
+            m_blocks.push_back(std::move(block));
+            m_offset = 0;
+        }
+
+        std::vector<Block> m_blocks;
+        size_t             m_offset;
+        size_t             m_used_bytes;
+    };
+
+    struct FrameAllocator::ThreadArenas
+    {
+        ThreadArenas()
+            : m_frame(0),
+              m_current(0),
+              m_is_self_driven(false)
+        {}
+
+        Arena    m_arenas[2];
+        uint64_t m_frame;
+        unsigned m_current;
+        bool     m_is_self_driven;
+
+        void flip()
+        {
+            m_current = 1 - m_current;
+            m_arenas[m_current].reset();
+        }
+    };
+
+    std::atomic<uint64_t> FrameAllocator::m_frame(0);
+
+    void FrameAllocator::beginFrame()
+    {
+        m_frame.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void FrameAllocator::beginThreadFrame()
+    {
+        ThreadArenas & arenas = threadArenas();
+
+        arenas.m_is_self_driven = true;
+        arenas.flip();
+    }
+
+    void * FrameAllocator::allocate(size_t size, size_t alignment)
+    {
+        ThreadArenas & arenas = threadArenas();
+
+        if (!arenas.m_is_self_driven)
+        {
+            uint64_t frame = m_frame.load(std::memory_order_relaxed);
+
+            if (arenas.m_frame != frame)
+            {
+                arenas.m_frame = frame;
+                arenas.flip();
+            }
+        }
+
+        return arenas.m_arenas[arenas.m_current].allocate(size, alignment);
+    }
+
+    size_t FrameAllocator::getUsedBytes()
+    {
+        ThreadArenas & arenas = threadArenas();
+
+        return arenas.m_arenas[arenas.m_current].getUsedBytes();
+    }
+
+    FrameAllocator::ThreadArenas & FrameAllocator::threadArenas()
+    {
+        static thread_local ThreadArenas arenas;
+
+        return arenas;
+    }
+}
@@ -0,0 +1,105 @@
+#include "framework/utilities/FrameTelemetry.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Vertex
+{
+    FrameTelemetry::FrameTelemetry(size_t capacity)
+        : m_samples(std::max<size_t>(capacity, 1)),
+          m_next(0),
+          m_count(0)
+    {
+        m_scratch.reserve(m_samples.size());
+    }
+
+    void FrameTelemetry::push(const FrameSample & sample)
+    {
+        m_samples[m_next] = sample;
+        m_next  = (m_next + 1) % m_samples.size();
+        m_count = std::min(m_count + 1, m_samples.size());
+    }
+
+    void FrameTelemetry::clear()
+    {
+        m_next  = 0;
+        m_count = 0;
+    }
+
+    const FrameSample & FrameTelemetry::get(size_t i) const
+    {
+        size_t oldest = (m_next + m_samples.size() - m_count) % m_samples.size();
+
+        return m_samples[(oldest + i) % m_samples.size()];
+    }
+
+    float FrameTelemetry::percentile(Metric metric, float percentile) const
+    {
+        if (m_count == 0)
+        {
+            return 0.0f;
+        }
+
+        values(metric, m_scratch);
+
+        size_t rank = size_t(std::ceil(std::min(std::max(percentile, 0.0f), 100.0f) / 100.0f * m_count));
+        size_t nth  = rank > 0 ? rank - 1 : 0;
+
+        std::nth_element(m_scratch.begin(), m_scratch.begin() + nth, m_scratch.end());
+
+        return m_scratch[nth];
+    }
+
+    float FrameTelemetry::max(Metric metric) const
+    {
+        float result = 0.0f;
+
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            result = std::max(result, value(m_samples[i], metric));
+        }
+
+        return result;
+    }
+
+    void FrameTelemetry::values(Metric metric, std::vector<float> & values) const
+    {
+        values.resize(m_count);
+
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            values[i] = value(get(i), metric);
+        }
+    }
+
+    void FrameTelemetry::histogram(Metric metric, float max_value, size_t bins_count, std::vector<float> & bins) const
+    {
+        bins.assign(bins_count, 0.0f);
+
+        if (bins_count == 0 || max_value <= 0.0f)
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            size_t bin = size_t(value(m_samples[i], metric) / max_value * bins_count);
+            bins[std::min(bin, bins_count - 1)] += 1.0f;
+        }
+    }
+
+    float FrameTelemetry::value(const FrameSample & sample, Metric metric)
+    {
+        switch (metric)
+        {
+        case Metric::FRAME_TIME:  return sample.m_frame_ms;
+        case Metric::SIM_TIME:    return sample.m_sim_ms;
+        case Metric::RENDER_TIME: return sample.m_render_ms;
+        case Metric::SWAP_TIME:   return sample.m_swap_ms;
+        case Metric::SIM_STEPS:   return float(sample.m_sim_steps);
+        case Metric::HEAP_ALLOCATIONS: return float(sample.m_heap_allocations);
+        }
+
+        return 0.0f;
+    }
+}
@@ -0,0 +1,268 @@
+#include "framework/utilities/JobSystem.h"
+#include "framework/utilities/Profiler.h"
+
+namespace Vertex
+{
+    /*
+     * Fixed size ring buffer guarded by a mutex. It never allocates after
+     * construction - a job that doesn't fit is executed right away by the
+     * submitting thread instead.
+     */
+    class JobSystem::JobQueue
+    {
+    public:
+        JobQueue()
+            : m_jobs(CAPACITY),
+              m_head(0),
+              m_tail(0)
+        {}
+
+        bool push(const Job & job)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_tail - m_head == CAPACITY)
+            {
+                return false;
+            }
+
+            m_jobs[m_tail % CAPACITY] = job;
+            ++m_tail;
+
+            return true;
+        }
+
+        /* Owner's end */
+        bool popBack(Job & job)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_tail == m_head)
+            {
+                return false;
+            }
+
+            --m_tail;
+            job = m_jobs[m_tail % CAPACITY];
+
+            return true;
+        }
+
+        /* Thieves' end */
+        bool popFront(Job & job)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_tail == m_head)
+            {
+                return false;
+            }
+
+            job = m_jobs[m_head % CAPACITY];
+            ++m_head;
+
+            return true;
+        }
+
+    private:
+        static const std::size_t CAPACITY = 4096;
+
+        std::mutex       m_mutex;
+        std::vector<Job> m_jobs;
+        std::size_t      m_head;
+        std::size_t      m_tail;
+    };
+
+    namespace
+    {
+        /* 0 - shared queue of the non-worker threads, 1..N - worker queues */
+        thread_local unsigned t_queue_index = 0;
+    }
+
+    std::vector<std::thread>                          JobSystem::m_workers;
+    std::vector<std::unique_ptr<JobSystem::JobQueue>> JobSystem::m_queues;
+
+    std::atomic<bool> JobSystem::m_is_running(false);
+    std::atomic<int>  JobSystem::m_queued_jobs(0);
+    std::atomic<int>  JobSystem::m_sleeping_workers(0);
+
+    std::mutex              JobSystem::m_sleep_mutex;
+    std::condition_variable JobSystem::m_wake_condition;
+
+    void JobSystem::init(unsigned workers_count)
+    {
+        shutdown();
+
+        m_queues.clear();
+        for (unsigned i = 0; i < workers_count + 1; ++i)
+        {
+            m_queues.push_back(std::unique_ptr<JobQueue>(new JobQueue()));
+        }
+
+        m_is_running = true;
+
+        for (unsigned i = 0; i < workers_count; ++i)
+        {
+            m_workers.push_back(std::thread(&JobSystem::workerLoop, i + 1));
+        }
+    }
+
+    void JobSystem::shutdown()
+    {
+        if (!m_is_running)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_is_running = false;
+        }
+        m_wake_condition.notify_all();
+
+        for (auto & worker : m_workers)
+        {
+            worker.join();
+        }
+
+        m_workers.clear();
+
+        /* Nobody is going to pick up the leftovers, so run them here */
+        Job job;
+        while (popOrSteal(0, job))
+        {
+            execute(job);
+        }
+    }
+
+    unsigned JobSystem::getWorkersCount()
+    {
+        return unsigned(m_workers.size());
+    }
+
+    void JobSystem::submit(const Job & job)
+    {
+        if (job.m_counter)
+        {
+            job.m_counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (m_queues.empty() || !m_queues[getQueueIndex()]->push(job))
+        {
+            execute(job);
+            return;
+        }
+
+        m_queued_jobs.fetch_add(1);
+
+        if (m_sleeping_workers.load() > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            }
+            m_wake_condition.notify_one();
+        }
+    }
+
+    void JobSystem::wait(JobCounter & counter)
+    {
+        while (!counter.isDone())
+        {
+            if (!runOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool JobSystem::runOne()
+    {
+        if (m_queues.empty())
+        {
+            return false;
+        }
+
+        Job job;
+        if (popOrSteal(getQueueIndex(), job))
+        {
+            execute(job);
+            return true;
+        }
+
+        return false;
+    }
+
+    void JobSystem::workerLoop(unsigned queue_index)
+    {
+        t_queue_index = queue_index;
+        Profiler::setThreadName("Worker " + std::to_string(queue_index));
+
+        const unsigned spins_before_sleep = 64;
+        unsigned idle_spins = 0;
+
+        while (m_is_running)
+        {
+            Job job;
+            if (popOrSteal(queue_index, job))
+            {
+                execute(job);
+                idle_spins = 0;
+
+                continue;
+            }
+
+            if (++idle_spins < spins_before_sleep)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            /* Out of work for a while - go to sleep until something gets submitted */
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+
+            m_sleeping_workers.fetch_add(1);
+            m_wake_condition.wait(lock, [] { return m_queued_jobs.load() > 0 || !m_is_running; });
+            m_sleeping_workers.fetch_sub(1);
+
+            idle_spins = 0;
+        }
+    }
+
+    bool JobSystem::popOrSteal(unsigned queue_index, Job & job)
+    {
+        if (m_queued_jobs.load() == 0)
+        {
+            return false;
+        }
+
+        bool found = m_queues[queue_index]->popBack(job);
+
+        const unsigned queues_count = unsigned(m_queues.size());
+        for (unsigned i = 1; i < queues_count && !found; ++i)
+        {
+            found = m_queues[(queue_index + i) % queues_count]->popFront(job);
+        }
+
+        if (found)
+        {
+            m_queued_jobs.fetch_sub(1);
+        }
+
+        return found;
+    }
+
+    void JobSystem::execute(const Job & job)
+    {
+        job.m_function(job.m_data, job.m_begin, job.m_end);
+
+        if (job.m_counter)
+        {
+            job.m_counter->m_pending.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    unsigned JobSystem::getQueueIndex()
+    {
+        return t_queue_index;
+    }
+}
@@ -0,0 +1,356 @@
+#include "framework/utilities/Profiler.h"
+#include "helpers/Assertions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+namespace Vertex
+{
+    /*
+     * Single producer ring buffer. Only the owning thread writes, the exporter may
+     * read at the same time. Every slot is a tiny seqlock: the reader skips slots
+     * that were being overwritten while it copied them, nobody ever waits.
+     */
+    class Profiler::Ring
+    {
+    public:
+        static const uint64_t CAPACITY = 1 << 16;
+
+        Ring(unsigned id, const std::string & name)
+            : m_slots(new Slot[CAPACITY]),
+              m_write_index(0),
+              m_clear_index(0),
+              m_name(name),
+              m_id(id),
+              m_depth(0),
+              m_is_free(false)
+        {}
+
+        bool isEmpty() const
+        {
+            return m_clear_index.load(std::memory_order_relaxed) == m_write_index.load(std::memory_order_acquire);
+        }
+
+        void push(const ProfileEvent & event)
+        {
+            uint64_t index = m_write_index.load(std::memory_order_relaxed);
+            Slot   & slot  = m_slots[index & (CAPACITY - 1)];
+
+            /* Odd sequence - the slot is being written */
+            slot.m_sequence.store(2 * index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            slot.m_name.store(event.m_name, std::memory_order_relaxed);
+            slot.m_begin_ns.store(event.m_begin_ns, std::memory_order_relaxed);
+            slot.m_end_ns.store(event.m_end_ns, std::memory_order_relaxed);
+            slot.m_depth.store(event.m_depth, std::memory_order_relaxed);
+
+            slot.m_sequence.store(2 * index + 2, std::memory_order_release);
+            m_write_index.store(index + 1, std::memory_order_release);
+        }
+
+        void read(std::vector<ProfileEvent> & events) const
+        {
+            uint64_t end   = m_write_index.load(std::memory_order_acquire);
+            uint64_t begin = std::max(end > CAPACITY ? end - CAPACITY : 0, m_clear_index.load(std::memory_order_relaxed));
+
+            for (uint64_t i = begin; i < end; ++i)
+            {
+                const Slot & slot = m_slots[i & (CAPACITY - 1)];
+
+                uint64_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+
+                ProfileEvent event;
+                event.m_name     = slot.m_name.load(std::memory_order_relaxed);
+                event.m_begin_ns = slot.m_begin_ns.load(std::memory_order_relaxed);
+                event.m_end_ns   = slot.m_end_ns.load(std::memory_order_relaxed);
+                event.m_depth    = slot.m_depth.load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (sequence == 2 * i + 2 && slot.m_sequence.load(std::memory_order_relaxed) == sequence)
+                {
+                    events.push_back(event);
+                }
+            }
+        }
+
+        /* Only the writer moves the write index, so clearing just hides what was written so far */
+        void clear()
+        {
+            m_clear_index.store(m_write_index.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+
+        struct Slot
+        {
+            Slot()
+                : m_sequence(0),
+                  m_name(nullptr),
+                  m_begin_ns(0),
+                  m_end_ns(0),
+                  m_depth(0)
+            {}
+
+            std::atomic<uint64_t>     m_sequence;
+            std::atomic<const char *> m_name;
+            std::atomic<uint64_t>     m_begin_ns;
+            std::atomic<uint64_t>     m_end_ns;
+            std::atomic<uint32_t>     m_depth;
+        };
+
+        std::unique_ptr<Slot[]> m_slots;
+        std::atomic<uint64_t>   m_write_index;
+        std::atomic<uint64_t>   m_clear_index;
+        std::string             m_name;
+        unsigned                m_id;
+        uint32_t                m_depth;
+        bool                    m_is_free; /* Its thread exited */
+    };
+
+    /* Gives the ring back when the thread exits */
+    class Profiler::ThreadState
+    {
+    public:
+        ThreadState()
+            : m_ring(nullptr),
+              m_name("Thread")
+        {}
+
+        ~ThreadState()
+        {
+            if (m_ring)
+            {
+                Profiler::releaseRing(*m_ring);
+            }
+        }
+
+        Ring      * m_ring;
+        std::string m_name;
+    };
+
+    const unsigned Profiler::MAX_LANES;
+
+    std::atomic<bool>                            Profiler::m_is_enabled(false);
+    std::mutex                                   Profiler::m_rings_mutex;
+    std::vector<std::unique_ptr<Profiler::Ring>> Profiler::m_rings;
+    std::vector<Profiler::Ring *>                Profiler::m_free_rings;
+    std::atomic<Profiler::Ring *>                Profiler::m_lanes[MAX_LANES];
+    unsigned                                     Profiler::m_lanes_count = 0;
+    thread_local Profiler::ThreadState           Profiler::m_thread_state;
+
+    namespace
+    {
+        const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+        void writeEscaped(std::ostream & stream, const char * text)
+        {
+            for (; *text; ++text)
+            {
+                if (*text == '"' || *text == '\\')
+                {
+                    stream << '\\';
+                }
+
+                stream << *text;
+            }
+        }
+    }
+
+    void Profiler::setEnabled(bool enabled)
+    {
+        m_is_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void Profiler::setThreadName(const std::string & name)
+    {
+        ThreadState & state = m_thread_state;
+        state.m_name = name;
+
+        if (state.m_ring)
+        {
+            std::lock_guard<std::mutex> lock(m_rings_mutex);
+            state.m_ring->m_name = name;
+        }
+    }
+
+    unsigned Profiler::addLane(const std::string & name)
+    {
+        Ring & ring = addRing(name);
+
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+
+        if (m_lanes_count == MAX_LANES)
+        {
+            VERTEX_ASSERT_FAIL("Too many profiler lanes");
+            return MAX_LANES;
+        }
+
+        m_lanes[m_lanes_count].store(&ring, std::memory_order_release);
+
+        return m_lanes_count++;
+    }
+
+    uint64_t Profiler::now()
+    {
+        /* Relative to the start, so 0 can mean "not started" */
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_epoch).count()) + 1;
+    }
+
+    uint32_t Profiler::beginScope()
+    {
+        return threadRing().m_depth++;
+    }
+
+    void Profiler::endScope(const char * name, uint64_t begin_ns)
+    {
+        Ring & ring = threadRing();
+
+        ProfileEvent event = { name, begin_ns, now(), --ring.m_depth };
+        ring.push(event);
+    }
+
+    void Profiler::record(unsigned lane, const ProfileEvent & event)
+    {
+        /* Rings are never freed, so a published one stays valid */
+        Ring * ring = lane < MAX_LANES ? m_lanes[lane].load(std::memory_order_acquire) : nullptr;
+
+        if (ring)
+        {
+            ring->push(event);
+        }
+    }
+
+    bool Profiler::exportChromeTrace(const std::string & filename)
+    {
+        std::ofstream file(filename);
+
+        if (!file)
+        {
+            fprintf(stderr, "Error: Can't write the profiler trace to %s.\n", filename.c_str());
+            return false;
+        }
+
+        struct ExportedRing
+        {
+            const Ring * m_ring;
+            std::string  m_name;
+        };
+
+        /* Only the list of the rings is locked - the rings are read lock-free and the file is written without the lock */
+        std::vector<ExportedRing> rings;
+
+        {
+            std::lock_guard<std::mutex> lock(m_rings_mutex);
+
+            for (auto & ring : m_rings)
+            {
+                /* Nothing left of the exited thread */
+                if (!ring->m_is_free || !ring->isEmpty())
+                {
+                    ExportedRing exported = { ring.get(), ring->m_name };
+                    rings.push_back(exported);
+                }
+            }
+        }
+
+        std::vector<ProfileEvent> events;
+
+        /* Microseconds with nanosecond precision */
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool is_first = true;
+        for (auto & exported : rings)
+        {
+            const Ring * ring = exported.m_ring;
+
+            file << (is_first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->m_id << ",\"args\":{\"name\":\"";
+            writeEscaped(file, exported.m_name.c_str());
+            file << "\"}}";
+            is_first = false;
+
+            events.clear();
+            ring->read(events);
+
+            for (auto & event : events)
+            {
+                /* Complete events, the viewer nests them by time */
+                file << ",\n{\"name\":\"";
+                writeEscaped(file, event.m_name);
+                file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->m_id
+                     << ",\"ts\":"  << double(event.m_begin_ns) / 1000.0
+                     << ",\"dur\":" << double(event.m_end_ns - event.m_begin_ns) / 1000.0
+                     << ",\"args\":{\"depth\":" << event.m_depth << "}}";
+            }
+        }
+
+        file << "\n]}\n";
+
+        return bool(file);
+    }
+
+    void Profiler::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+
+        for (auto & ring : m_rings)
+        {
+            ring->clear();
+        }
+    }
+
+    Profiler::Ring & Profiler::threadRing()
+    {
+        ThreadState & state = m_thread_state;
+
+        if (!state.m_ring)
+        {
+            state.m_ring = &acquireRing(state.m_name);
+        }
+
+        return *state.m_ring;
+    }
+
+    Profiler::Ring & Profiler::addRing(const std::string & name)
+    {
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+
+        m_rings.push_back(std::unique_ptr<Ring>(new Ring(unsigned(m_rings.size()), name)));
+
+        return *m_rings.back();
+    }
+
+    Profiler::Ring & Profiler::acquireRing(const std::string & name)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_rings_mutex);
+
+            if (!m_free_rings.empty())
+            {
+                Ring & ring = *m_free_rings.back();
+                m_free_rings.pop_back();
+
+                /* The events of the previous thread would show up under the new name */
+                ring.clear();
+                ring.m_name    = name;
+                ring.m_depth   = 0;
+                ring.m_is_free = false;
+
+                return ring;
+            }
+        }
+
+        return addRing(name);
+    }
+
+    void Profiler::releaseRing(Ring & ring)
+    {
+        std::lock_guard<std::mutex> lock(m_rings_mutex);
+
+        ring.m_is_free = true;
+        m_free_rings.push_back(&ring);
+    }
+}
@@ -67,4 +67,20 @@ namespace Vertex
 
         return data;
     }
+
+    bool Util::loadTextureInfo(const std::string & filename, ImageData & image_data)
+    {
+        int width, height, nr_channels;
+
+        if (!stbi_info(filename.c_str(), &width, &height, &nr_channels))
+        {
+            return false;
+        }
+
+        image_data.width    = width;
+        image_data.height   = height;
+        image_data.channels = nr_channels;
+
+        return true;
+    }
 }
@@ -1,8 +1,47 @@
 #include "framework/window/Input.h"
+#include "framework/window/Window.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
 
 namespace Vertex
 {
-    GLFWwindow * Input::m_window = nullptr;
+    namespace
+    {
+        /*
+         * Recording format: header, then one record per step:
+         * uint8 mouse buttons, uint16 count of keys that changed state, uint16 key codes, float cursor x, float cursor y
+         */
+        const char     RECORDING_MAGIC[4] = { 'V', 'E', 'I', 'R' };
+        const uint32_t RECORDING_VERSION  = 1;
+
+        struct RecordingHeader
+        {
+            char     m_magic[4];
+            uint32_t m_version;
+            float    m_window_center_x;
+            float    m_window_center_y;
+        };
+
+        template <typename T>
+        void writeValue(std::ofstream & file, const T & value)
+        {
+            file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        bool readValue(std::ifstream & file, T & value)
+        {
+            return bool(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+        }
+    }
+
+    GLFWwindow *  Input::m_window = nullptr;
+    Input::State  Input::m_state;
+    std::ofstream Input::m_record_file;
+    std::ifstream Input::m_replay_file;
+    glm::vec2     Input::m_replay_cursor_offset;
 
     std::unordered_map<KeyCode, bool> Input::m_last_keys_states = {
         { KeyCode::Backspace,      false },
@@ -122,6 +161,189 @@ namespace Vertex
         m_window = window;
     }
 
+    void Input::beginTick()
+    {
+        State previous_state = m_state;
+
+        if (m_replay_file.is_open())
+        {
+            bool is_read = readState(m_state);
+
+            /* Stop right after the last step, so isReplaying() is false before the next one */
+            if (!is_read || m_replay_file.peek() == std::ifstream::traits_type::eof())
+            {
+                stopReplay();
+            }
+
+            if (is_read)
+            {
+                return;
+            }
+        }
+
+        pollState(m_state);
+
+        if (m_record_file.is_open())
+        {
+            writeState(previous_state, m_state);
+        }
+    }
+
+    bool Input::startRecording(const std::string & filename)
+    {
+        stopRecording();
+
+        m_record_file.open(filename, std::ios::binary | std::ios::trunc);
+
+        if (!m_record_file)
+        {
+            fprintf(stderr, "Can't open file %s for recording input.\n", filename.c_str());
+            return false;
+        }
+
+        glm::vec2 center = Window::getCenter();
+
+        RecordingHeader header = { { RECORDING_MAGIC[0], RECORDING_MAGIC[1], RECORDING_MAGIC[2], RECORDING_MAGIC[3] },
+                                   RECORDING_VERSION, center.x, center.y };
+        writeValue(m_record_file, header);
+
+        /* Key changes are written relative to the previous step, the first record starts from nothing pressed */
+        m_state = State();
+
+        return true;
+    }
+
+    void Input::stopRecording()
+    {
+        if (m_record_file.is_open())
+        {
+            m_record_file.close();
+        }
+    }
+
+    bool Input::isRecording()
+    {
+        return m_record_file.is_open();
+    }
+
+    bool Input::startReplay(const std::string & filename)
+    {
+        stopReplay();
+
+        m_replay_file.open(filename, std::ios::binary);
+
+        RecordingHeader header;
+
+        if (!m_replay_file || !readValue(m_replay_file, header) ||
+            !std::equal(RECORDING_MAGIC, RECORDING_MAGIC + 4, header.m_magic) || header.m_version != RECORDING_VERSION)
+        {
+            fprintf(stderr, "Can't replay input from file %s.\n", filename.c_str());
+            stopReplay();
+            return false;
+        }
+
+        m_replay_cursor_offset = Window::getCenter() - glm::vec2(header.m_window_center_x, header.m_window_center_y);
+        m_state = State();
+
+        return true;
+    }
+
+    void Input::stopReplay()
+    {
+        if (m_replay_file.is_open())
+        {
+            m_replay_file.close();
+        }
+
+        m_replay_file.clear();
+    }
+
+    bool Input::isReplaying()
+    {
+        return m_replay_file.is_open();
+    }
+
+    void Input::pollState(State & state)
+    {
+        state = State();
+
+        /* No window in the headless mode - nothing is ever pressed */
+        if (!m_window)
+        {
+            return;
+        }
+
+        for (auto & kv : m_last_keys_states)
+        {
+            state.m_keys[static_cast<int>(kv.first)] = glfwGetKey(m_window, static_cast<int>(kv.first)) == GLFW_PRESS;
+        }
+
+        for (auto & kv : m_last_mouse_states)
+        {
+            state.m_mouse_buttons[static_cast<int>(kv.first)] = glfwGetMouseButton(m_window, static_cast<int>(kv.first)) == GLFW_PRESS;
+        }
+
+        double x_pos, y_pos;
+        glfwGetCursorPos(m_window, &x_pos, &y_pos);
+
+        state.m_mouse_position = glm::vec2(x_pos, y_pos);
+    }
+
+    void Input::writeState(const State & previous_state, const State & state)
+    {
+        auto changed_keys = previous_state.m_keys ^ state.m_keys;
+
+        writeValue(m_record_file, uint8_t(state.m_mouse_buttons.to_ulong()));
+        writeValue(m_record_file, uint16_t(changed_keys.count()));
+
+        for (size_t i = 0; i < changed_keys.size(); ++i)
+        {
+            if (changed_keys[i])
+            {
+                writeValue(m_record_file, uint16_t(i));
+            }
+        }
+
+        writeValue(m_record_file, state.m_mouse_position.x);
+        writeValue(m_record_file, state.m_mouse_position.y);
+    }
+
+    bool Input::readState(State & state)
+    {
+        uint8_t  mouse_buttons;
+        uint16_t changed_keys_count;
+
+        if (!readValue(m_replay_file, mouse_buttons) || !readValue(m_replay_file, changed_keys_count))
+        {
+            return false;
+        }
+
+        state.m_mouse_buttons = std::bitset<GLFW_MOUSE_BUTTON_LAST + 1>(mouse_buttons);
+
+        for (uint16_t i = 0; i < changed_keys_count; ++i)
+        {
+            uint16_t key;
+
+            if (!readValue(m_replay_file, key) || key >= state.m_keys.size())
+            {
+                return false;
+            }
+
+            state.m_keys.flip(key);
+        }
+
+        glm::vec2 mouse_position;
+
+        if (!readValue(m_replay_file, mouse_position.x) || !readValue(m_replay_file, mouse_position.y))
+        {
+            return false;
+        }
+
+        state.m_mouse_position = mouse_position + m_replay_cursor_offset;
+
+        return true;
+    }
+
     void Input::update()
     {
         for (auto & kv : m_last_keys_states)
@@ -137,7 +359,14 @@ namespace Vertex
 
     bool Input::getKey(KeyCode keyCode)
     {
-        return glfwGetKey(m_window, static_cast<int>(keyCode)) == GLFW_PRESS;
+        int key = static_cast<int>(keyCode);
+
+        if (key < 0 || key > GLFW_KEY_LAST)
+        {
+            return false;
+        }
+
+        return m_state.m_keys[key];
     }
 
     bool Input::getKeyDown(KeyCode keyCode)
@@ -152,7 +381,14 @@ namespace Vertex
 
     bool Input::getMouse(KeyCode keyCode)
     {
-        return glfwGetMouseButton(m_window, static_cast<int>(keyCode)) == GLFW_PRESS;
+        int button = static_cast<int>(keyCode);
+
+        if (button < 0 || button > GLFW_MOUSE_BUTTON_LAST)
+        {
+            return false;
+        }
+
+        return m_state.m_mouse_buttons[button];
     }
 
     bool Input::getMouseDown(KeyCode keyCode)
@@ -167,14 +403,16 @@ namespace Vertex
 
     glm::vec2 Input::getMousePosition()
     {
-        double x_pos, y_pos;
-        glfwGetCursorPos(m_window, &x_pos, &y_pos);
-
-        return glm::vec2(x_pos, y_pos);
+        return m_state.m_mouse_position;
     }
 
     void Input::setMouseCursorVisibility(bool is_visible)
     {
+        if (!m_window)
+        {
+            return;
+        }
+
         if (is_visible)
         {
             glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
@@ -187,6 +425,11 @@ namespace Vertex
 
     void Input::setMouseCursorPosition(const glm::vec2 & cursor_position)
     {
+        if (!m_window)
+        {
+            return;
+        }
+
         glfwSetCursorPos(m_window, cursor_position.x, cursor_position.y);
     }
 }
\ No newline at end of file
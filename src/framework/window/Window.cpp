@@ -10,6 +10,7 @@ namespace Vertex
     GLFWwindow * Window::m_window = nullptr;
     std::string  Window::m_title = "";
     glm::vec2    Window::m_window_size = glm::vec2(0);
+    bool         Window::m_is_headless = false;
 
     Window::Window()
     {
@@ -17,6 +18,11 @@ namespace Vertex
 
     Window::~Window()
     {
+        if (m_is_headless)
+        {
+            return;
+        }
+
         glfwDestroyWindow(m_window);
         glfwTerminate();
     }
@@ -90,14 +96,74 @@ namespace Vertex
         GUI::init(m_window);
     }
 
+    void Window::createHeadless(unsigned int width, unsigned int height, const std::string & title)
+    {
+        m_title = title;
+        m_window_size = glm::vec2(width, height);
+        m_is_headless = true;
+
+        /* Input stays released, GUI only gets its context so fonts can be loaded */
+        GUI::initHeadless();
+    }
+
+    bool Window::isHeadless()
+    {
+        return m_is_headless;
+    }
+
     void Window::endFrame()
     {
+        pollEvents();
+        swapBuffers();
+    }
+
+    void Window::pollEvents()
+    {
+        if (m_is_headless)
+        {
+            return;
+        }
+
         glfwPollEvents();
+    }
+
+    void Window::swapBuffers()
+    {
+        if (m_is_headless)
+        {
+            return;
+        }
+
         glfwSwapBuffers(m_window);
     }
 
+    void Window::makeContextCurrent()
+    {
+        if (m_is_headless)
+        {
+            return;
+        }
+
+        glfwMakeContextCurrent(m_window);
+    }
+
+    void Window::releaseContext()
+    {
+        if (m_is_headless)
+        {
+            return;
+        }
+
+        glfwMakeContextCurrent(nullptr);
+    }
+
     int Window::isCloseRequested()
     {
+        if (m_is_headless)
+        {
+            return 0;
+        }
+
         return glfwWindowShouldClose(m_window);
     }
 
@@ -128,6 +194,11 @@ namespace Vertex
 
     void Window::setVSync(bool enabled)
     {
+        if (m_is_headless)
+        {
+            return;
+        }
+
         auto value = enabled ? 1 : 0;
 
         glfwSwapInterval(value);
@@ -135,14 +206,18 @@ namespace Vertex
 
     void Window::bindDefaultFramebuffer()
     {
+        if (m_is_headless)
+        {
+            return;
+        }
+
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(0, 0, m_window_size.x, m_window_size.y);
     }
 
     void Window::framebuffer_size_callback(GLFWwindow * window, int width, int height)
     {
-        glViewport(0, 0, width, height);
-
+        /* The viewport is updated by the renderer, which may live on another thread */
         m_window_size.x = float(width);
         m_window_size.y = float(height);
 
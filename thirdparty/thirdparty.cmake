@@ -2,6 +2,10 @@
 find_package(OpenGL REQUIRED)
 set(OPENGL_LIBRARY ${OPENGL_LIBRARIES})
 
+# Threads
+find_package(Threads REQUIRED)
+set(THREADS_LIBRARY ${CMAKE_THREAD_LIBS_INIT})
+
 # assimp
 find_library(ASSIMP_LIBRARY "assimp" "/usr/lib" "/usr/local/lib")
 find_path(ASSIMP_INCLUDE_DIR "assimp/mesh.h" "/usr/include" "/usr/local/include")